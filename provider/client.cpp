@@ -8,26 +8,78 @@
 #include "mi_module.hpp"
 #include "mi_schema.hpp"
 #include "shared_protocol.hpp"
+#include "shared_ring.hpp"
 #include "socket_wrapper.hpp"
+#include "thread_pool.hpp"
 
 
 #include <cstdlib>
 #include <errno.h>
+#include <fcntl.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <unistd.h>
+#include <vector>
 
 
 namespace scx
 {
 
 
+/*static*/ size_t const Client::DEFAULT_THREAD_COUNT;
+
+
+// request_task runs a handler on one of the workers.
+class Client::request_task : public thread_pool::task
+{
+public:
+    /*ctor*/ request_task (
+        Client* const pClient,
+        handler_fn const handler,
+        MI_Context::Ptr const& pContext,
+        socket_wrapper& sock)
+        : m_pClient (pClient)
+        , m_Handler (handler)
+        , m_pContext (pContext)
+        , m_Message (sock.getRecvRemaining ())
+    {
+        if (!m_Message.empty ())
+        {
+            sock.recv (&m_Message[0], m_Message.size ());
+        }
+    }
+
+    void run ()
+    {
+        SCX_BOOKEND ("Client::request_task::run");
+        socket_wrapper sock (m_Message.empty () ? NULL : &m_Message[0],
+                             m_Message.size ());
+        if (EXIT_SUCCESS != (m_pClient->*m_Handler)(sock, m_pContext))
+        {
+            SCX_BOOKEND_PRINT ("handler failed");
+        }
+        if (!m_pContext->getResultSent () &&
+            !m_pContext->getResultDeferred ())
+        {
+            m_pContext->postResult (MI_RESULT_FAILED);
+        }
+    }
+
+private:
+    Client* const m_pClient;
+    handler_fn const m_Handler;
+    MI_Context::Ptr const m_pContext;
+    std::vector<socket_wrapper::byte_t> m_Message;
+};
+
+
 /*static*/ int
 Client::create (
     unsigned short const& port,
     unsigned int (&key)[4],
     util::internal_counted_ptr<MI_Module> const& pModule,
-    Client::Ptr* ppClientOut)
+    Client::Ptr* ppClientOut,
+    size_t const& nThreads)
 {
     SCX_BOOKEND ("Client::create");
     int rval = EXIT_SUCCESS;
@@ -71,11 +123,8 @@ Client::create (
                 if (EXIT_SUCCESS == rval)
                 {
                     SCX_BOOKEND_PRINT ("socket created");
-                    ppClientOut->reset (
-                        new Client (
-                            util::internal_counted_ptr<socket_wrapper> (
-                                new socket_wrapper (fd)),
-                            pModule));
+                    rval = create (fd, shared_ring::INVALID_FD, pModule,
+                                   ppClientOut, nThreads);
                 }
             }
             else
@@ -95,6 +144,53 @@ Client::create (
 }
 
 
+/*static*/ int
+Client::create (
+    int const& fd,
+    int const& ringFD,
+    util::internal_counted_ptr<MI_Module> const& pModule,
+    Client::Ptr* ppClientOut,
+    size_t const& nThreads)
+{
+    SCX_BOOKEND ("Client::create (fd)");
+    int rval = EXIT_SUCCESS;
+    if (ppClientOut &&
+        socket_wrapper::INVALID_SOCKET != fd)
+    {
+        // keep the socket out of any process started by the provider script
+        fcntl (fd, F_SETFD, FD_CLOEXEC);
+        shared_ring::Ptr pRing;
+        if (shared_ring::INVALID_FD != ringFD)
+        {
+            if (shared_ring::SUCCESS == shared_ring::attach (ringFD, &pRing))
+            {
+                // the mapping stays valid after the backing file is closed
+                pRing->closeFD ();
+            }
+            else
+            {
+                // the server will get everything on the socket
+                SCX_BOOKEND_PRINT ("shared_ring::attach failed");
+                close (ringFD);
+                pRing.reset ();
+            }
+        }
+        ppClientOut->reset (
+            new Client (
+                util::internal_counted_ptr<socket_wrapper> (
+                    new socket_wrapper (fd, socket_wrapper::DUPLEX)),
+                pRing,
+                pModule,
+                nThreads));
+    }
+    else
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
 /*ctor*/
 Client::~Client ()
 {
@@ -107,63 +203,88 @@ Client::run ()
 {
     SCX_BOOKEND ("Client::run");
     int rval = m_pModule->getSchemaDecl ()->send (*m_pSocket);
+    if (EXIT_SUCCESS == rval)
+    {
+        rval = m_pSocket->flush ();
+    }
+    // the workers are joined before run returns
+    thread_pool workers (m_nThreads);
     bool complete = EXIT_SUCCESS != rval;
     while (!complete)
     {
         protocol::opcode_t opcode;
-        int rval = protocol::recv_opcode (&opcode, *m_pSocket);
+        protocol::request_id_t requestID;
+        int rval = protocol::recv_opcode (&opcode, &requestID, *m_pSocket);
         if (EXIT_SUCCESS == rval)
         {
             SCX_BOOKEND_PRINT ("an opcode was read");
+            MI_Context::Ptr pContext (new MI_Context (m_pChannel, requestID));
+            handler_fn handler = NULL;
             switch (opcode)
             {
             case protocol::MODULE_LOAD:
                 SCX_BOOKEND_PRINT ("MODULE_LOAD");
-                rval = handle_module_load();
+                wait_idle (workers);
+                rval = handle_module_load (*m_pSocket, pContext);
                 break;
             case protocol::MODULE_UNLOAD:
                 SCX_BOOKEND_PRINT ("MODULE_UNLOAD");
-                rval = handle_module_unload ();
+                wait_idle (workers);
+                rval = handle_module_unload (*m_pSocket, pContext);
                 complete = true;
                 break;
             case protocol::CLASS_LOAD:
                 SCX_BOOKEND_PRINT ("CLASS_LOAD");
-                rval = handle_class_load ();
+                wait_idle (workers);
+                rval = handle_class_load (*m_pSocket, pContext);
                 break;
             case protocol::CLASS_UNLOAD:
                 SCX_BOOKEND_PRINT ("CLASS_UNLOAD");
-                rval = handle_class_unload ();
+                wait_idle (workers);
+                rval = handle_class_unload (*m_pSocket, pContext);
                 break;
             case protocol::ENUMERATE_INSTANCES:
                 SCX_BOOKEND_PRINT ("ENUMERATE_INSTANCES");
-                rval = handle_enumerate_instances ();
+                handler = &Client::handle_enumerate_instances;
                 break;
             case protocol::GET_INSTANCE:
                 SCX_BOOKEND_PRINT ("GET_INSTANCE");
-                rval = handle_get_instance ();
+                handler = &Client::handle_get_instance;
                 break;
             case protocol::CREATE_INSTANCE:
                 SCX_BOOKEND_PRINT ("CREATE_INSTANCE");
-                rval = handle_create_instance ();
+                handler = &Client::handle_create_instance;
                 break;
             case protocol::MODIFY_INSTANCE:
                 SCX_BOOKEND_PRINT ("MODIFY_INSTANCE");
-                rval = handle_modify_instance ();
+                handler = &Client::handle_modify_instance;
                 break;
             case protocol::DELETE_INSTANCE:
                 SCX_BOOKEND_PRINT ("DELETE_INSTANCE");
-                rval = handle_delete_instance ();
+                handler = &Client::handle_delete_instance;
                 break;
             case protocol::INVOKE:
                 SCX_BOOKEND_PRINT ("INVOKE");
-                rval = handle_invoke ();
+                handler = &Client::handle_invoke;
                 break;
             default:
                 SCX_BOOKEND_PRINT ("unhandled opcode");
-                m_pContext->postResult (MI_RESULT_NOT_SUPPORTED);
+                pContext->postResult (MI_RESULT_NOT_SUPPORTED);
                 //rval = EXIT_FAILURE;
                 break;
             }
+            if (NULL != handler)
+            {
+                // the worker gets its own copy of the rest of the message,
+                // the socket moves on to the next one
+                workers.submit (
+                    new request_task (this, handler, pContext, *m_pSocket));
+            }
+            else if (!pContext->getResultSent () &&
+                     !pContext->getResultDeferred ())
+            {
+                pContext->postResult (MI_RESULT_FAILED);
+            }
         }
         else
         {
@@ -173,51 +294,66 @@ Client::run ()
         {
             complete = true;
         }
-        if (!m_pContext->getResultSent ())
-        {
-            m_pContext->postResult (MI_RESULT_FAILED);
-        }
-        m_pContext->resetResultSent ();
     }
     return rval;
 }
 
 
+void
+Client::wait_idle (
+    thread_pool& workers)
+{
+    workers.waitIdle ();
+    // requests that deferred their results are still in progress too
+    m_pChannel->waitDeferred ();
+}
+
+
 /*ctor*/
 Client::Client (
     util::internal_counted_ptr<socket_wrapper> const& pSocket,
-    util::internal_counted_ptr<MI_Module> const& pModule)
+    util::internal_counted_ptr<shared_ring> const& pRing,
+    util::internal_counted_ptr<MI_Module> const& pModule,
+    size_t const& nThreads)
     : m_pSocket (pSocket)
     , m_pModule (pModule)
-    , m_pContext (new MI_Context (pSocket, pModule->getSchemaDecl ()))
+    , m_pChannel (new context_channel (pSocket, pModule->getSchemaDecl (),
+                                       pRing))
+    , m_nThreads (nThreads)
 {
     SCX_BOOKEND ("Client::ctor");
 }
 
 
 int
-Client::handle_module_load ()
+Client::handle_module_load (
+    socket_wrapper& /*sock*/,
+    MI_Context::Ptr const& pContext)
 {
     SCX_BOOKEND ("Client::handle_module_load");
-    return m_pModule->getLoadFn ()->fn (m_pModule, m_pContext);
+    return m_pModule->getLoadFn ()->fn (m_pModule, pContext);
 }
 
 
 int
-Client::handle_module_unload ()
+Client::handle_module_unload (
+    socket_wrapper& /*sock*/,
+    MI_Context::Ptr const& pContext)
 {
     SCX_BOOKEND ("Client::handle_module_unload");
-    return m_pModule->getUnloadFn ()->fn (m_pModule, m_pContext);
+    return m_pModule->getUnloadFn ()->fn (m_pModule, pContext);
 }
 
 
 int
-Client::handle_class_load ()
+Client::handle_class_load (
+    socket_wrapper& sock,
+    MI_Context::Ptr const& pContext)
 {
     SCX_BOOKEND ("Client::handle_class_load");
     std::ostringstream strm;
     MI_Value<MI_STRING>::Ptr pClassName;
-    int rval = MI_Value<MI_STRING>::recv (&pClassName, *m_pSocket);
+    int rval = string_table::recv (&pClassName, sock);
     if (socket_wrapper::SUCCESS == rval)
     {
         strm << "class name: \"" << pClassName->getValue () << "\"";
@@ -230,7 +366,7 @@ Client::handle_class_load ()
         {
             SCX_BOOKEND_PRINT ("MI_ClassDecl was found");
             rval = pClassDecl->getFunctionTable ()->Load (
-                m_pModule, m_pContext);
+                m_pModule, pContext);
         }
         else
         {
@@ -250,12 +386,14 @@ Client::handle_class_load ()
 
 
 int
-Client::handle_class_unload ()
+Client::handle_class_unload (
+    socket_wrapper& sock,
+    MI_Context::Ptr const& pContext)
 {
     SCX_BOOKEND ("Client::handle_class_unload");
 
     MI_Value<MI_STRING>::Ptr pClassName;
-    int rval = MI_Value<MI_STRING>::recv (&pClassName, *m_pSocket);
+    int rval = string_table::recv (&pClassName, sock);
     if (socket_wrapper::SUCCESS == rval)
     {
         std::ostringstream strm;
@@ -269,7 +407,7 @@ Client::handle_class_unload ()
         if (pClassDecl)
         {
             SCX_BOOKEND_PRINT ("MI_ClassDecl was found");
-            rval = pClassDecl->getFunctionTable ()->Unload (m_pContext);
+            rval = pClassDecl->getFunctionTable ()->Unload (pContext);
         }
         else
         {
@@ -289,23 +427,25 @@ Client::handle_class_unload ()
 
 
 int
-Client::handle_enumerate_instances ()
+Client::handle_enumerate_instances (
+    socket_wrapper& sock,
+    MI_Context::Ptr const& pContext)
 {
     SCX_BOOKEND ("Client::handle_class_enumerate_instances");
     MI_Value<MI_STRING>::Ptr pNameSpace;
     MI_Value<MI_STRING>::Ptr pClassName;
     MI_PropertySet::ConstPtr pPropertySet;
     MI_Value<MI_BOOLEAN>::Ptr pKeysOnly;
-    int rval = MI_Value<MI_STRING>::recv (&pNameSpace, *m_pSocket);
+    int rval = string_table::recv (&pNameSpace, sock);
     if (socket_wrapper::SUCCESS == rval)
     {
-        rval = MI_Value<MI_STRING>::recv (&pClassName, *m_pSocket);
+        rval = string_table::recv (&pClassName, sock);
         if (socket_wrapper::SUCCESS == rval)
         {
-            rval = MI_PropertySet::recv (&pPropertySet, *m_pSocket);
+            rval = MI_PropertySet::recv (&pPropertySet, sock);
             if (socket_wrapper::SUCCESS == rval)
             {
-                rval = MI_Value<MI_BOOLEAN>::recv (&pKeysOnly, *m_pSocket);
+                rval = MI_Value<MI_BOOLEAN>::recv (&pKeysOnly, sock);
                 if (socket_wrapper::SUCCESS != rval)
                 {
                     // error
@@ -343,7 +483,7 @@ Client::handle_enumerate_instances ()
         {
             SCX_BOOKEND_PRINT ("MI_ClassDecl was found");
             rval = pClassDecl->getFunctionTable ()->EnumerateInstances (
-                m_pContext, pNameSpace, pClassName, pPropertySet, pKeysOnly);
+                pContext, pNameSpace, pClassName, pPropertySet, pKeysOnly);
         }
         else
         {
@@ -362,26 +502,28 @@ Client::handle_enumerate_instances ()
 }
 
 
-bool
-Client::handle_get_instance ()
+int
+Client::handle_get_instance (
+    socket_wrapper& sock,
+    MI_Context::Ptr const& pContext)
 {
     SCX_BOOKEND ("Client::handle_get_instance");
     MI_Value<MI_STRING>::Ptr pNameSpace;
     MI_Value<MI_STRING>::Ptr pClassName;
     MI_Instance::Ptr pInstance;
     MI_PropertySet::ConstPtr pPropertySet;
-    int rval = MI_Value<MI_STRING>::recv (&pNameSpace, *m_pSocket);
+    int rval = string_table::recv (&pNameSpace, sock);
     if (socket_wrapper::SUCCESS == rval)
     {
 
-        rval = MI_Value<MI_STRING>::recv (&pClassName, *m_pSocket);
+        rval = string_table::recv (&pClassName, sock);
         if (socket_wrapper::SUCCESS == rval)
         {
             rval = MI_Instance::recv (
-                &pInstance, m_pModule->getSchemaDecl (), *m_pSocket);
+                &pInstance, m_pModule->getSchemaDecl (), sock);
             if (socket_wrapper::SUCCESS == rval)
             {
-                rval = MI_PropertySet::recv (&pPropertySet, *m_pSocket);
+                rval = MI_PropertySet::recv (&pPropertySet, sock);
                 if (socket_wrapper::SUCCESS != rval)
                 {
                     // error
@@ -420,7 +562,7 @@ Client::handle_get_instance ()
         {
             SCX_BOOKEND_PRINT ("MI_ClassDecl was found");
             rval = pClassDecl->getFunctionTable ()->GetInstance (
-                m_pContext, pNameSpace, pClassName, pInstance, pPropertySet);
+                pContext, pNameSpace, pClassName, pInstance, pPropertySet);
         }
         else
         {
@@ -439,21 +581,23 @@ Client::handle_get_instance ()
 }
 
 
-bool
-Client::handle_create_instance ()
+int
+Client::handle_create_instance (
+    socket_wrapper& sock,
+    MI_Context::Ptr const& pContext)
 {
     SCX_BOOKEND ("Client::handle_create_instance");
     MI_Value<MI_STRING>::Ptr pNameSpace;
     MI_Value<MI_STRING>::Ptr pClassName;
     MI_Instance::Ptr pInstance;
-    int rval = MI_Value<MI_STRING>::recv (&pNameSpace, *m_pSocket);
+    int rval = string_table::recv (&pNameSpace, sock);
     if (socket_wrapper::SUCCESS == rval)
     {
-        rval = MI_Value<MI_STRING>::recv (&pClassName, *m_pSocket);
+        rval = string_table::recv (&pClassName, sock);
         if (socket_wrapper::SUCCESS == rval)
         {
             rval = MI_Instance::recv (
-                &pInstance, m_pModule->getSchemaDecl (), *m_pSocket);
+                &pInstance, m_pModule->getSchemaDecl (), sock);
             if (socket_wrapper::SUCCESS != rval)
             {
                 // error
@@ -486,7 +630,7 @@ Client::handle_create_instance ()
         {
             SCX_BOOKEND_PRINT ("MI_ClassDecl was found");
             rval = pClassDecl->getFunctionTable ()->CreateInstance (
-                m_pContext, pNameSpace, pClassName, pInstance);
+                pContext, pNameSpace, pClassName, pInstance);
         }
         else
         {
@@ -505,25 +649,27 @@ Client::handle_create_instance ()
 }
 
 
-bool
-Client::handle_modify_instance ()
+int
+Client::handle_modify_instance (
+    socket_wrapper& sock,
+    MI_Context::Ptr const& pContext)
 {
     SCX_BOOKEND ("Client::handle_modify_instance");
     MI_Value<MI_STRING>::Ptr pNameSpace;
     MI_Value<MI_STRING>::Ptr pClassName;
     MI_Instance::Ptr pInstance;
     MI_PropertySet::ConstPtr pPropertySet;
-    int rval = MI_Value<MI_STRING>::recv (&pNameSpace, *m_pSocket);
+    int rval = string_table::recv (&pNameSpace, sock);
     if (socket_wrapper::SUCCESS == rval)
     {
-        rval = MI_Value<MI_STRING>::recv (&pClassName, *m_pSocket);
+        rval = string_table::recv (&pClassName, sock);
         if (socket_wrapper::SUCCESS == rval)
         {
             rval = MI_Instance::recv (
-                &pInstance, m_pModule->getSchemaDecl (), *m_pSocket);
+                &pInstance, m_pModule->getSchemaDecl (), sock);
             if (socket_wrapper::SUCCESS == rval)
             {
-                rval = MI_PropertySet::recv (&pPropertySet, *m_pSocket);
+                rval = MI_PropertySet::recv (&pPropertySet, sock);
                 if (socket_wrapper::SUCCESS != rval)
                 {
                     // error
@@ -562,7 +708,7 @@ Client::handle_modify_instance ()
         {
             SCX_BOOKEND_PRINT ("MI_ClassDecl was found");
             rval = pClassDecl->getFunctionTable ()->ModifyInstance (
-                m_pContext, pNameSpace, pClassName, pInstance, pPropertySet);
+                pContext, pNameSpace, pClassName, pInstance, pPropertySet);
         }
         else
         {
@@ -581,21 +727,23 @@ Client::handle_modify_instance ()
 }
 
 
-bool
-Client::handle_delete_instance ()
+int
+Client::handle_delete_instance (
+    socket_wrapper& sock,
+    MI_Context::Ptr const& pContext)
 {
     SCX_BOOKEND ("Client::handle_delete_instance");
     MI_Value<MI_STRING>::Ptr pNameSpace;
     MI_Value<MI_STRING>::Ptr pClassName;
     MI_Instance::Ptr pInstance;
-    int rval = MI_Value<MI_STRING>::recv (&pNameSpace, *m_pSocket);
+    int rval = string_table::recv (&pNameSpace, sock);
     if (socket_wrapper::SUCCESS == rval)
     {
-        rval = MI_Value<MI_STRING>::recv (&pClassName, *m_pSocket);
+        rval = string_table::recv (&pClassName, sock);
         if (socket_wrapper::SUCCESS == rval)
         {
             rval = MI_Instance::recv (
-                &pInstance, m_pModule->getSchemaDecl (), *m_pSocket);
+                &pInstance, m_pModule->getSchemaDecl (), sock);
             if (socket_wrapper::SUCCESS != rval)
             {
                 // error
@@ -628,7 +776,7 @@ Client::handle_delete_instance ()
         {
             SCX_BOOKEND_PRINT ("MI_ClassDecl was found");
             rval = pClassDecl->getFunctionTable ()->DeleteInstance (
-                m_pContext, pNameSpace, pClassName, pInstance);
+                pContext, pNameSpace, pClassName, pInstance);
         }
         else
         {
@@ -647,15 +795,17 @@ Client::handle_delete_instance ()
 }
 
 
-bool
-Client::handle_invoke ()
+int
+Client::handle_invoke (
+    socket_wrapper& sock,
+    MI_Context::Ptr const& pContext)
 {
     SCX_BOOKEND ("Client::handle_invoke");
     MI_Value<MI_STRING>::Ptr pNameSpace;
     int rval = socket_wrapper::SUCCESS;
     {
         SCX_BOOKEND ("read namespace");
-        rval = MI_Value<MI_STRING>::recv (&pNameSpace, *m_pSocket);
+        rval = string_table::recv (&pNameSpace, sock);
         if (socket_wrapper::SUCCESS != rval)
         {
             SCX_BOOKEND ("recv namespace failed");
@@ -665,7 +815,7 @@ Client::handle_invoke ()
     if (socket_wrapper::SUCCESS == rval)
     {
         SCX_BOOKEND ("read class name");
-        rval = MI_Value<MI_STRING>::recv (&pClassName, *m_pSocket);
+        rval = string_table::recv (&pClassName, sock);
         if (socket_wrapper::SUCCESS != rval)
         {
             SCX_BOOKEND ("recv class name failed");
@@ -675,7 +825,7 @@ Client::handle_invoke ()
     if (socket_wrapper::SUCCESS == rval)
     {
         SCX_BOOKEND ("read method name");
-        rval = MI_Value<MI_STRING>::recv (&pMethodName, *m_pSocket);
+        rval = string_table::recv (&pMethodName, sock);
         if (socket_wrapper::SUCCESS != rval)
         {
             SCX_BOOKEND ("recv method name failed");
@@ -695,7 +845,7 @@ Client::handle_invoke ()
     if (pClassDecl)
     {
         SCX_BOOKEND ("find MI_MethodDecl");
-        pMethodDecl = pClassDecl->getMethodDecl (pMethodName->getValue ());
+        pMethodDecl = pClassDecl->getMethodDecl (pMethodName);
         if (!pMethodDecl)
         {
             SCX_BOOKEND ("MI_MethodDecl not found");
@@ -705,7 +855,7 @@ Client::handle_invoke ()
     if (socket_wrapper::SUCCESS == rval)
     {
         SCX_BOOKEND ("read flags");
-        rval = protocol::recv (&flags, *m_pSocket);
+        rval = protocol::recv (&flags, sock);
         if (socket_wrapper::SUCCESS != rval)
         {
             SCX_BOOKEND ("recv flags failed");
@@ -719,12 +869,12 @@ Client::handle_invoke ()
         SCX_BOOKEND ("read instance");
         MI_Value<MI_STRING>::Ptr pExtraClassName;
         SCX_BOOKEND_PRINT ("recv extra class name");
-        rval = MI_Value<MI_STRING>::recv (&pExtraClassName, *m_pSocket);
+        rval = string_table::recv (&pExtraClassName, sock);
         if (socket_wrapper::SUCCESS == rval)
         {
             rval = MI_Instance::recv (
                 &pInstance, MI_ObjectDecl::ConstPtr (pClassDecl.get ()),
-                m_pModule->getSchemaDecl (), *m_pSocket);
+                m_pModule->getSchemaDecl (), sock);
             if (socket_wrapper::SUCCESS != rval)
             {
                 SCX_BOOKEND ("recv instance failed");
@@ -740,12 +890,12 @@ Client::handle_invoke ()
         SCX_BOOKEND ("read input parameters");
         MI_Value<MI_STRING>::Ptr pExtraClassName;
         SCX_BOOKEND_PRINT ("recv extra class name");
-        rval = MI_Value<MI_STRING>::recv (&pExtraClassName, *m_pSocket);
+        rval = string_table::recv (&pExtraClassName, sock);
         if (socket_wrapper::SUCCESS == rval)
         {
             rval = MI_Instance::recv (
                 &pInputParameters, MI_ObjectDecl::ConstPtr (pMethodDecl.get ()),
-                m_pModule->getSchemaDecl (), *m_pSocket);
+                m_pModule->getSchemaDecl (), sock);
             if (socket_wrapper::SUCCESS != rval)
             {
                 SCX_BOOKEND ("recv input parameters failed");
@@ -757,7 +907,7 @@ Client::handle_invoke ()
     {
         SCX_BOOKEND ("call Invoke");
         pMethodDecl->Invoke (
-            m_pContext, pNameSpace, pClassName, pMethodName, pInstance,
+            pContext, pNameSpace, pClassName, pMethodName, pInstance,
             pInputParameters);
     }
 
@@ -13,17 +13,25 @@
 #define EXPORT_PUBLIC __attribute__ ((visibility ("default")))
 
 
+class shared_ring;
 class socket_wrapper;
+class thread_pool;
 
 
 namespace scx
 {
 
 
+class context_channel;
 class MI_Context;
 class MI_Module;
 
 
+// Client reads requests from the server and answers them.  Load and unload
+// requests are handled on the thread that calls run once everything before
+// them has finished, including requests whose results were deferred; the
+// other requests are handed to a pool of worker threads so that several of
+// them can be in progress at the same time.
 class Client : public util::ref_counted_obj
 {
 public:
@@ -33,38 +41,79 @@ public:
         SUCCESS = EXIT_SUCCESS,
     };
 
+    static size_t const DEFAULT_THREAD_COUNT = 1;
+
     EXPORT_PUBLIC static int create (
         unsigned short const& port,
         unsigned int (&key)[4],
         util::internal_counted_ptr<MI_Module> const& pModule,
-        Ptr* ppClientOut);
+        Ptr* ppClientOut,
+        size_t const& nThreads = DEFAULT_THREAD_COUNT);
+    EXPORT_PUBLIC static int create (
+        int const& fd,
+        int const& ringFD,
+        util::internal_counted_ptr<MI_Module> const& pModule,
+        Ptr* ppClientOut,
+        size_t const& nThreads = DEFAULT_THREAD_COUNT);
     EXPORT_PUBLIC virtual /*dtor*/ ~Client ();
 
     EXPORT_PUBLIC int run ();
 
 private:
-    /*ctor*/ Client (
-        util::internal_counted_ptr<socket_wrapper> const& pSocket,
-        util::internal_counted_ptr<MI_Module> const& pModule);
+    class request_task;
 
-    int handle_module_load ();
-    int handle_module_unload ();
-    int handle_class_load ();
-    int handle_class_unload ();
-    int handle_enumerate_instances ();
-    bool handle_get_instance ();
-    bool handle_create_instance ();
-    bool handle_modify_instance ();
-    bool handle_delete_instance ();
+    typedef int (Client::*handler_fn)(
+        socket_wrapper&,
+        util::internal_counted_ptr<MI_Context> const&);
 
-    bool handle_invoke ();
+    /*ctor*/ Client (
+        util::internal_counted_ptr<socket_wrapper> const& pSocket,
+        util::internal_counted_ptr<shared_ring> const& pRing,
+        util::internal_counted_ptr<MI_Module> const& pModule,
+        size_t const& nThreads);
+
+    // wait for the requests in progress to finish
+    void wait_idle (thread_pool& workers);
+
+    int handle_module_load (
+        socket_wrapper& sock,
+        util::internal_counted_ptr<MI_Context> const& pContext);
+    int handle_module_unload (
+        socket_wrapper& sock,
+        util::internal_counted_ptr<MI_Context> const& pContext);
+    int handle_class_load (
+        socket_wrapper& sock,
+        util::internal_counted_ptr<MI_Context> const& pContext);
+    int handle_class_unload (
+        socket_wrapper& sock,
+        util::internal_counted_ptr<MI_Context> const& pContext);
+    int handle_enumerate_instances (
+        socket_wrapper& sock,
+        util::internal_counted_ptr<MI_Context> const& pContext);
+    int handle_get_instance (
+        socket_wrapper& sock,
+        util::internal_counted_ptr<MI_Context> const& pContext);
+    int handle_create_instance (
+        socket_wrapper& sock,
+        util::internal_counted_ptr<MI_Context> const& pContext);
+    int handle_modify_instance (
+        socket_wrapper& sock,
+        util::internal_counted_ptr<MI_Context> const& pContext);
+    int handle_delete_instance (
+        socket_wrapper& sock,
+        util::internal_counted_ptr<MI_Context> const& pContext);
+
+    int handle_invoke (
+        socket_wrapper& sock,
+        util::internal_counted_ptr<MI_Context> const& pContext);
 
     /*ctor*/ Client (Client const&); // = delete
     Client& operator = (Client const&); // = delete
     
     util::internal_counted_ptr<socket_wrapper> const m_pSocket;
     util::internal_counted_ptr<MI_Module> const m_pModule;
-    util::internal_counted_ptr<MI_Context> const m_pContext;
+    util::internal_counted_ptr<context_channel> const m_pChannel;
+    size_t const m_nThreads;
 };
 
 
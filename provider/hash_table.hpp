@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#ifndef INCLUDED_UTIL_HASH_TABLE_HPP
+#define INCLUDED_UTIL_HASH_TABLE_HPP
+
+
+#include <cctype>
+#include <cstddef>
+
+
+// The open addressed hash tables over names (schema_index, the parameter and
+// method indexes of the schema declarations and the string_table) share these
+// helpers.  A table is a power of 2 in size and at most half full so a probe
+// always ends at an empty slot.  Names are hashed with FNV-1a.
+
+
+namespace util
+{
+
+
+// exact_char
+// purpose: Names are compared as they are.
+//------------------------------------------------------------------------------
+struct exact_char
+{
+    unsigned char operator () (char const ch) const
+    {
+        return static_cast<unsigned char>(ch);
+    }
+};
+
+
+// folded_char
+// purpose: Names are compared without regard to case, as CIM names are.
+//------------------------------------------------------------------------------
+struct folded_char
+{
+    unsigned char operator () (char const ch) const
+    {
+        return static_cast<unsigned char>(
+            tolower (static_cast<unsigned char>(ch)));
+    }
+};
+
+
+// FNV-1a over the NUL terminated name, the seed is mixed into the offset
+// basis
+template<typename FOLD>
+size_t
+hash_name (
+    char const* name,
+    size_t const seed = 0)
+{
+    FOLD const fold = FOLD ();
+    size_t value = static_cast<size_t>(2166136261u) ^ seed;
+    for (; *name; ++name)
+    {
+        value ^= fold (*name);
+        value *= static_cast<size_t>(16777619u);
+    }
+    return value;
+}
+
+
+template<typename FOLD>
+bool
+equal_names (
+    char const* pLHS,
+    char const* pRHS)
+{
+    FOLD const fold = FOLD ();
+    while (*pLHS && fold (*pLHS) == fold (*pRHS))
+    {
+        ++pLHS;
+        ++pRHS;
+    }
+    return fold (*pLHS) == fold (*pRHS);
+}
+
+
+// the smallest power of 2 that holds count items at most half full
+inline size_t
+hash_table_size (
+    size_t const count)
+{
+    size_t size = 0 < count ? 2 : 0;
+    while (size < 2 * count)
+    {
+        size *= 2;
+    }
+    return size;
+}
+
+
+// the position of the first slot from hash on, wrapping around, for which
+// stop is true; stop has to be true for an empty slot
+template<typename SLOTS, typename STOP>
+size_t
+hash_probe (
+    SLOTS const& slots,
+    size_t const hash,
+    STOP const& stop)
+{
+    size_t const mask = slots.size () - 1;
+    size_t pos = hash & mask;
+    while (!stop (slots[pos]))
+    {
+        pos = (pos + 1) & mask;
+    }
+    return pos;
+}
+
+
+} // namespace util
+
+
+#endif // INCLUDED_UTIL_HASH_TABLE_HPP
@@ -39,12 +39,27 @@ public:
     /*ctor*/ internal_counted_ptr (
         internal_counted_ptr<T2, D2> const& ref);
 
+#if (UTIL_HAS_RVALUE_REFERENCES)
+    // the move operations take over ref's count, ref is left empty
+    /*ctor*/ internal_counted_ptr (internal_counted_ptr&& ref) UTIL_NOEXCEPT;
+
+    template<typename T2, typename D2>
+    /*ctor*/ internal_counted_ptr (
+        internal_counted_ptr<T2, D2>&& ref) UTIL_NOEXCEPT;
+#endif
+
     /*dtor*/ ~internal_counted_ptr ();
 
     internal_counted_ptr& operator = (pointer pT);
     internal_counted_ptr& operator = (internal_counted_ptr const& rhs);
     template<typename T2, typename D2>
     internal_counted_ptr& operator = (internal_counted_ptr<T2, D2> const& rhs);
+#if (UTIL_HAS_RVALUE_REFERENCES)
+    internal_counted_ptr& operator = (internal_counted_ptr&& rhs) UTIL_NOEXCEPT;
+    template<typename T2, typename D2>
+    internal_counted_ptr& operator = (
+        internal_counted_ptr<T2, D2>&& rhs) UTIL_NOEXCEPT;
+#endif
 
     void swap (internal_counted_ptr& ref);
 
@@ -72,6 +87,13 @@ private:
 };
 
 
+#if (UTIL_HAS_RVALUE_REFERENCES)
+// make_counted constructs a T from args and returns the only pointer to it
+template<typename T, typename... Args>
+internal_counted_ptr<T> make_counted (Args&&... args);
+#endif
+
+
 // ref_counted_obj
 //------------------------------------------------------------------------------
 class ref_counted_obj
@@ -157,6 +179,29 @@ internal_counted_ptr<T, D>::internal_counted_ptr (
     }
 }
 
+#if (UTIL_HAS_RVALUE_REFERENCES)
+template<typename T, typename D>
+/*ctor*/
+internal_counted_ptr<T, D>::internal_counted_ptr (
+    internal_counted_ptr<T, D>&& ref) UTIL_NOEXCEPT
+    : m_pT (ref.m_pT)
+    , m_deleter (ref.m_deleter)
+{
+    ref.m_pT = 0;
+}
+
+template<typename T, typename D>
+template<typename T2, typename D2>
+/*ctor*/
+internal_counted_ptr<T, D>::internal_counted_ptr (
+    internal_counted_ptr<T2, D2>&& ref) UTIL_NOEXCEPT
+    : m_pT (ref.m_pT)
+    , m_deleter ()
+{
+    ref.m_pT = 0;
+}
+#endif
+
 template<typename T, typename D>
 /*dtor*/
 internal_counted_ptr<T, D>::~internal_counted_ptr ()
@@ -228,6 +273,35 @@ internal_counted_ptr<T, D>::operator = (
     return *this;
 }
 
+#if (UTIL_HAS_RVALUE_REFERENCES)
+template<typename T, typename D>
+internal_counted_ptr<T, D>&
+internal_counted_ptr<T, D>::operator = (
+    internal_counted_ptr<T, D>&& rhs) UTIL_NOEXCEPT
+{
+    if (this != &rhs)
+    {
+        reset ();
+        m_pT = rhs.m_pT;
+        m_deleter = rhs.m_deleter;
+        rhs.m_pT = 0;
+    }
+    return *this;
+}
+
+template<typename T, typename D>
+template<typename T2, typename D2>
+internal_counted_ptr<T, D>&
+internal_counted_ptr<T, D>::operator = (
+    internal_counted_ptr<T2, D2>&& rhs) UTIL_NOEXCEPT
+{
+    reset ();
+    m_pT = rhs.m_pT;
+    rhs.m_pT = 0;
+    return *this;
+}
+#endif
+
 template<typename T, typename D>
 void
 internal_counted_ptr<T, D>::swap (
@@ -324,6 +398,19 @@ internal_counted_ptr<T, D>::operator ! () const
 }
 
 
+#if (UTIL_HAS_RVALUE_REFERENCES)
+// make_counted definition
+//------------------------------------------------------------------------------
+template<typename T, typename... Args>
+internal_counted_ptr<T>
+make_counted (
+    Args&&... args)
+{
+    return internal_counted_ptr<T> (new T (std::forward<Args>(args)...));
+}
+#endif
+
+
 // ref_counted_obj definitions
 //------------------------------------------------------------------------------
 inline /*ctor*/
@@ -348,22 +435,23 @@ ref_counted_obj::operator = (
     return *this;
 }
 
+// the count is atomic, objects are shared by the client's worker threads
 inline size_t
 ref_counted_obj::inc_ref_count () const
 {
-    return ++m_count;
+    return __atomic_add_fetch (&m_count, 1, __ATOMIC_RELAXED);
 }
 
 inline size_t
 ref_counted_obj::dec_ref_count () const
 {
-    return --m_count;
+    return __atomic_sub_fetch (&m_count, 1, __ATOMIC_ACQ_REL);
 }
 
 inline size_t
 ref_counted_obj::use_count () const
 {
-    return m_count;
+    return __atomic_load_n (&m_count, __ATOMIC_RELAXED);
 }
 
 
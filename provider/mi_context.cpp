@@ -7,20 +7,108 @@
 #include "mi_schema.hpp"
 
 
+#include <algorithm>
 #include <cassert>
 
 
+// Instances after the first of their class in a request are sent as the
+// values that changed.
+#if (1)
+#define USE_DELTA_ENCODING (1)
+#else
+#define USE_DELTA_ENCODING (0)
+#endif
+
+
 namespace scx
 {
 
 
+namespace
+{
+
+
+class scoped_lock
+{
+public:
+    explicit /*ctor*/ scoped_lock (pthread_mutex_t* const pMutex)
+        : m_pMutex (pMutex)
+    {
+        if (0 != pthread_mutex_trylock (m_pMutex))
+        {
+            // the holder may be blocked in a send that has to get back
+            // whatever the blocking hooks release before it can unlock
+            socket_wrapper::blocking_section blocking;
+            pthread_mutex_lock (m_pMutex);
+        }
+    }
+
+    /*dtor*/ ~scoped_lock ()
+    {
+        pthread_mutex_unlock (m_pMutex);
+    }
+
+private:
+    /*ctor*/ scoped_lock (scoped_lock const&); // = delete
+    scoped_lock& operator = (scoped_lock const&); // = delete
+
+    pthread_mutex_t* const m_pMutex;
+};
+
+
+} // namespace (unnamed)
+
+
 /*ctor*/
-MI_Context::MI_Context (
+context_channel::context_channel (
     socket_wrapper::Ptr const& pSocket,
-    MI_SchemaDecl::ConstPtr const& pSchemaDecl)
+    MI_SchemaDecl::ConstPtr const& pSchemaDecl,
+    shared_ring::Ptr const& pRing)
     : m_pSocket (pSocket)
     , m_pSchemaDecl (pSchemaDecl)
+    , m_pRing (pRing)
+    , m_RingPending (false)
+    , m_nDeferred (0)
+{
+    SCX_BOOKEND ("context_channel::ctor");
+    pthread_mutex_init (&m_Lock, NULL);
+    pthread_cond_init (&m_NoneDeferred, NULL);
+}
+
+
+/*dtor*/
+context_channel::~context_channel ()
+{
+    SCX_BOOKEND ("context_channel::dtor");
+    pthread_cond_destroy (&m_NoneDeferred);
+    pthread_mutex_destroy (&m_Lock);
+}
+
+
+void
+context_channel::waitDeferred ()
+{
+    SCX_BOOKEND ("context_channel::waitDeferred");
+    scoped_lock lock (&m_Lock);
+    while (0 < m_nDeferred)
+    {
+        socket_wrapper::blocking_section blocking;
+        pthread_cond_wait (&m_NoneDeferred, &m_Lock);
+    }
+}
+
+
+/*static*/ size_t const MI_Context::MAX_INSTANCE_BATCH;
+
+
+/*ctor*/
+MI_Context::MI_Context (
+    context_channel::Ptr const& pChannel,
+    protocol::request_id_t const& requestID)
+    : m_pChannel (pChannel)
+    , m_RequestID (requestID)
     , m_ResultSent (false)
+    , m_ResultDeferred (false)
 {
     SCX_BOOKEND ("MI_Context::ctor");
 }
@@ -30,6 +118,24 @@ MI_Context::MI_Context (
 MI_Context::~MI_Context ()
 {
     SCX_BOOKEND ("MI_Context::dtor");
+    if (m_ResultDeferred)
+    {
+        postResult (MI_RESULT_FAILED);
+    }
+}
+
+
+void
+MI_Context::deferResult ()
+{
+    SCX_BOOKEND ("MI_Context::deferResult");
+    scoped_lock lock (&(m_pChannel->m_Lock));
+    if (!m_ResultSent &&
+        !m_ResultDeferred)
+    {
+        m_ResultDeferred = true;
+        ++(m_pChannel->m_nDeferred);
+    }
 }
 
 
@@ -41,15 +147,37 @@ MI_Context::postResult (
     int rval = socket_wrapper::SEND_FAILED;
     if (!m_ResultSent)
     {
-        rval = protocol::send_opcode (protocol::POST_RESULT, *m_pSocket);
+        socket_wrapper& sock = *(m_pChannel->m_pSocket);
+        scoped_lock lock (&(m_pChannel->m_Lock));
+        // instances in the ring have to be drained before the result
+        rval = notify_ring ();
         if (socket_wrapper::SUCCESS == rval)
         {
-            rval = protocol::send<MI_Uint32> (result, *m_pSocket);
+            rval = protocol::send_opcode (protocol::POST_RESULT, m_RequestID,
+                                          sock);
+        }
+        if (socket_wrapper::SUCCESS == rval)
+        {
+            rval = protocol::send<MI_Uint32> (result, sock);
+            if (socket_wrapper::SUCCESS == rval)
+            {
+                // POST_RESULT ends the response, push it to the server
+                rval = sock.flush ();
+            }
             if (socket_wrapper::SUCCESS == rval)
             {
                 m_ResultSent = true;
             }
         }
+        if (m_ResultDeferred)
+        {
+            // a failed send is the last attempt too, the channel is lost
+            m_ResultDeferred = false;
+            if (0 == --(m_pChannel->m_nDeferred))
+            {
+                pthread_cond_broadcast (&(m_pChannel->m_NoneDeferred));
+            }
+        }
     }
     return rval;
 }
@@ -65,10 +193,89 @@ MI_Context::postInstance (
     if (!m_ResultSent &&
         pInstance)
     {
-        rval = protocol::send_opcode (protocol::POST_INSTANCE, *m_pSocket);
-        if (socket_wrapper::SUCCESS == rval)
+        if (m_pChannel->m_pRing)
         {
-            rval = pInstance->send (*m_pSocket);
+            // the delta is taken and the record written under one lock so
+            // an instance posted from another thread can't come between them
+            std::vector<socket_wrapper::byte_t> buffer;
+            socket_wrapper record (&buffer);
+            scoped_lock lock (&(m_pChannel->m_Lock));
+            rval = protocol::send (m_RequestID, record);
+            if (socket_wrapper::SUCCESS == rval)
+            {
+                rval = send_instance (*pInstance, record);
+            }
+            if (socket_wrapper::SUCCESS == rval)
+            {
+                rval = post_to_ring (buffer);
+            }
+        }
+        else
+        {
+            socket_wrapper& sock = *(m_pChannel->m_pSocket);
+            scoped_lock lock (&(m_pChannel->m_Lock));
+            rval = protocol::send_opcode (protocol::POST_INSTANCE,
+                                          m_RequestID, sock);
+            if (socket_wrapper::SUCCESS == rval)
+            {
+                rval = send_instance (*pInstance, sock);
+            }
+        }
+    }
+    return rval;
+}
+
+
+int
+MI_Context::postInstances (
+    instance_list const& instances)
+{
+    SCX_BOOKEND ("MI_Context::postInstances");
+    int rval = socket_wrapper::SEND_FAILED;
+    if (!m_ResultSent)
+    {
+        rval = socket_wrapper::SUCCESS;
+        if (m_pChannel->m_pRing)
+        {
+            // each instance is a ring record of its own, and the server is
+            // only notified once for the lot of them
+            for (instance_list::const_iterator pos = instances.begin (),
+                     endPos = instances.end ();
+                 socket_wrapper::SUCCESS == rval &&
+                     pos != endPos;
+                 ++pos)
+            {
+                rval = postInstance (*pos);
+            }
+        }
+        else
+        {
+            socket_wrapper& sock = *(m_pChannel->m_pSocket);
+            scoped_lock lock (&(m_pChannel->m_Lock));
+            for (instance_list::const_iterator pos = instances.begin (),
+                     endPos = instances.end ();
+                 socket_wrapper::SUCCESS == rval &&
+                     pos != endPos;)
+            {
+                // a batch is limited so that its message stays well inside
+                // the largest frame
+                size_t const count = std::min<size_t> (
+                    MAX_INSTANCE_BATCH, endPos - pos);
+                rval = protocol::send_opcode (protocol::POST_INSTANCES,
+                                              m_RequestID, sock);
+                if (socket_wrapper::SUCCESS == rval)
+                {
+                    rval = protocol::send_item_count (count, sock);
+                }
+                for (instance_list::const_iterator batchEnd = pos + count;
+                     socket_wrapper::SUCCESS == rval &&
+                         pos != batchEnd;
+                     ++pos)
+                {
+                    assert (NULL != pos->get ());
+                    rval = send_instance (**pos, sock);
+                }
+            }
         }
     }
     return rval;
@@ -86,7 +293,7 @@ MI_Context::newInstance (
     if (pClassName)
     {
         MI_ClassDecl::ConstPtr pClassDecl (
-            m_pSchemaDecl->getClassDecl (pClassName));
+            m_pChannel->getSchemaDecl ()->getClassDecl (pClassName));
         if (pClassDecl)
         {
             // correct: create the instance
@@ -118,11 +325,11 @@ MI_Context::newParameters (
     if (pClassName)
     {
         MI_ClassDecl::ConstPtr pClassDecl (
-            m_pSchemaDecl->getClassDecl (pClassName));
+            m_pChannel->getSchemaDecl ()->getClassDecl (pClassName));
         if (pClassDecl)
         {
             MI_MethodDecl::ConstPtr pMethodDecl (
-                pClassDecl->getMethodDecl (pMethodName->getValue ()));
+                pClassDecl->getMethodDecl (pMethodName));
             if (pMethodDecl)
             {
                 // correct: create the instance
@@ -147,4 +354,101 @@ MI_Context::newParameters (
 }
 
 
+
+int
+MI_Context::send_instance (
+    MI_Instance const& instance,
+    socket_wrapper& sock)
+{
+    // called with the channel locked: instances reach the server in the
+    // order they are sent whether they go through the ring or the socket, so
+    // the server's templates follow m_SentValues
+#if (USE_DELTA_ENCODING)
+    MI_ObjectDecl const& decl = *(instance.getObjectDecl ());
+    if (!decl.isMethodDecl () &&
+        protocol::NO_ORDINAL != decl.getOrdinal ())
+    {
+        return instance.sendDelta (&(m_SentValues[decl.getOrdinal ()]), sock);
+    }
+#endif
+    return instance.send (sock);
+}
+
+
+int
+MI_Context::post_to_ring (
+    std::vector<socket_wrapper::byte_t> const& record)
+{
+    // called with the channel locked
+    SCX_BOOKEND ("MI_Context::post_to_ring");
+    shared_ring& ring = *(m_pChannel->m_pRing);
+    socket_wrapper& sock = *(m_pChannel->m_pSocket);
+    int rval = socket_wrapper::SUCCESS;
+    int result = ring.write (&record[0], record.size ());
+    while (socket_wrapper::SUCCESS == rval &&
+           shared_ring::FULL == result)
+    {
+        // have the server drain the ring, then wait for it to make room
+        rval = notify_ring ();
+        if (socket_wrapper::SUCCESS == rval)
+        {
+            result = ring.waitForSpace (record.size (), sock.getFD ());
+            if (shared_ring::SUCCESS == result)
+            {
+                result = ring.write (&record[0], record.size ());
+            }
+        }
+    }
+    if (socket_wrapper::SUCCESS == rval)
+    {
+        if (shared_ring::SUCCESS == result)
+        {
+            m_pChannel->m_RingPending = true;
+        }
+        else if (shared_ring::TOO_LARGE == result)
+        {
+            // send it on the socket, after what is already in the ring; the
+            // message carries the request id in place of the record's
+            rval = notify_ring ();
+            if (socket_wrapper::SUCCESS == rval)
+            {
+                rval = protocol::send_opcode (protocol::POST_INSTANCE,
+                                              m_RequestID, sock);
+            }
+            if (socket_wrapper::SUCCESS == rval)
+            {
+                rval = sock.send (
+                    &record[sizeof (protocol::request_id_t)],
+                    record.size () - sizeof (protocol::request_id_t));
+            }
+        }
+        else
+        {
+            SCX_BOOKEND_PRINT ("shared_ring::waitForSpace failed");
+            rval = socket_wrapper::SEND_FAILED;
+        }
+    }
+    return rval;
+}
+
+
+int
+MI_Context::notify_ring ()
+{
+    // called with the channel locked
+    int rval = socket_wrapper::SUCCESS;
+    if (m_pChannel->m_RingPending)
+    {
+        socket_wrapper& sock = *(m_pChannel->m_pSocket);
+        rval = protocol::send_opcode (protocol::POST_RING, m_RequestID, sock);
+        if (socket_wrapper::SUCCESS == rval)
+        {
+            rval = sock.flush ();
+        }
+        m_pChannel->m_RingPending = false;
+    }
+    return rval;
+}
+
+
 } // namespace scx
@@ -5,10 +5,18 @@
 
 
 #include "internal_counted_ptr.hpp"
+#include "mi_instance.hpp"
 #include "mi_value.hpp"
+#include "shared_protocol.hpp"
+#include "shared_ring.hpp"
 #include "socket_wrapper.hpp"
 
 
+#include <map>
+#include <pthread.h>
+#include <vector>
+
+
 #ifndef EXPORT_PUBLIC
 #define EXPORT_PUBLIC __attribute__ ((visibility ("default")))
 #endif
@@ -18,23 +26,67 @@ namespace scx
 {
 
 
-class MI_Instance;
 class MI_SchemaDecl;
 
 
+// context_channel is the connection to the server that the contexts of all
+// of the requests in progress share.  Each message is sent whole while the
+// lock is held, so messages from different requests never interleave.  It
+// also counts the requests whose results have been deferred.
+class EXPORT_PUBLIC context_channel : public util::ref_counted_obj
+{
+public:
+    typedef util::internal_counted_ptr<context_channel> Ptr;
+
+    EXPORT_PUBLIC /*ctor*/ context_channel (
+        socket_wrapper::Ptr const& pSocket,
+        util::internal_counted_ptr<MI_SchemaDecl const> const& pSchemaDecl,
+        shared_ring::Ptr const& pRing = shared_ring::Ptr ());
+    EXPORT_PUBLIC /*dtor*/ ~context_channel ();
+
+    util::internal_counted_ptr<MI_SchemaDecl const> const&
+        getSchemaDecl () const;
+
+    // block until every deferred result has been posted
+    EXPORT_PUBLIC void waitDeferred ();
+
+private:
+    /*ctor*/ context_channel (context_channel const&); // = delete
+    context_channel& operator = (context_channel const&); // = delete
+
+    socket_wrapper::Ptr const m_pSocket;
+    util::internal_counted_ptr<MI_SchemaDecl const> const m_pSchemaDecl;
+    shared_ring::Ptr const m_pRing;
+    pthread_mutex_t m_Lock;
+    bool m_RingPending;
+    size_t m_nDeferred;
+    pthread_cond_t m_NoneDeferred;
+
+    friend class MI_Context;
+};
+
+
+// MI_Context is what a provider uses to answer one request.
 class EXPORT_PUBLIC MI_Context : public util::ref_counted_obj
 {
 public:
     typedef util::internal_counted_ptr<MI_Context> Ptr;
+    typedef std::vector<MI_Instance::ConstPtr> instance_list;
+
+    // the most instances postInstances sends in one message
+    static size_t const MAX_INSTANCE_BATCH = 256;
 
     EXPORT_PUBLIC /*ctor*/ MI_Context (
-        socket_wrapper::Ptr const& pSocket,
-        util::internal_counted_ptr<MI_SchemaDecl const> const& pSchemaDecl);
+        context_channel::Ptr const& pChannel,
+        protocol::request_id_t const& requestID);
     EXPORT_PUBLIC virtual /*dtor*/ ~MI_Context ();
 
     EXPORT_PUBLIC int postResult (MI_Result const& result);
     EXPORT_PUBLIC int postInstance (
         util::internal_counted_ptr<MI_Instance const> const& pInstance);
+    // postInstances posts the instances in order as though postInstance had
+    // been called for each one, but sends them in as few messages as it can
+    EXPORT_PUBLIC int postInstances (instance_list const& instances);
 
     EXPORT_PUBLIC int newInstance (
         MI_Value<MI_STRING>::ConstPtr const& pClassName,
@@ -44,19 +96,40 @@ public:
         MI_Value<MI_STRING>::ConstPtr const& pMethodName,
         util::internal_counted_ptr<MI_Instance>* ppInstanceOut);
 
+    // deferResult keeps the request in progress after its handler returns,
+    // for a provider that finishes it later from another thread.  The
+    // result is posted then, or as MI_RESULT_FAILED when the last reference
+    // to the context goes without one.
+    EXPORT_PUBLIC void deferResult ();
+
     bool getResultSent () const;
-    void resetResultSent ();
+    bool getResultDeferred () const;
 
 private:
     /*ctor*/ MI_Context (MI_Context const&); // = delete
     MI_Context& operator = (MI_Context const&); // = delete
 
-    socket_wrapper::Ptr const m_pSocket;
-    util::internal_counted_ptr<MI_SchemaDecl const> const m_pSchemaDecl;
+    int send_instance (MI_Instance const& instance, socket_wrapper& sock);
+    int post_to_ring (std::vector<socket_wrapper::byte_t> const& record);
+    int notify_ring ();
+
+    context_channel::Ptr const m_pChannel;
+    protocol::request_id_t const m_RequestID;
+    // what the last instance of each class posted held, by class ordinal;
+    // only used with the channel locked
+    std::map<MI_Uint32, MI_Instance::sent_values_t> m_SentValues;
     bool m_ResultSent;
+    bool m_ResultDeferred;
 };
 
 
+inline util::internal_counted_ptr<MI_SchemaDecl const> const&
+context_channel::getSchemaDecl () const
+{
+    return m_pSchemaDecl;
+}
+
+
 inline bool
 MI_Context::getResultSent () const
 {
@@ -64,10 +137,10 @@ MI_Context::getResultSent () const
 }
 
 
-inline void
-MI_Context::resetResultSent ()
+inline bool
+MI_Context::getResultDeferred () const
 {
-    m_ResultSent = false;
+    return m_ResultDeferred;
 }
 
 
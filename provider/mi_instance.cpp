@@ -3,8 +3,10 @@
 #include "mi_instance.hpp"
 
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <utility>
 
 
 #include "debug_tags.hpp"
@@ -20,9 +22,15 @@ namespace scx
 MI_Instance::MI_Instance (
     MI_ObjectDecl::ConstPtr const& pObjectDecl)
     : m_pObjectDecl (pObjectDecl)
+    , m_Values ()
+    , m_Names ()
 {
     //SCX_BOOKEND ("MI_Instance::ctor");
     //assert (pObjectDecl);
+    if (pObjectDecl)
+    {
+        m_Values.resize (pObjectDecl->getParameterDecls ().size ());
+    }
 }
 
 
@@ -30,7 +38,8 @@ MI_Instance::MI_Instance (
 MI_Instance::MI_Instance (
     MI_Instance const& ref)
     : m_pObjectDecl (ref.m_pObjectDecl)
-    , m_ValueMap (ref.m_ValueMap)
+    , m_Values (ref.m_Values)
+    , m_Names (ref.m_Names)
 {
     //SCX_BOOKEND ("MI_Instance::ctor (copy)");
 }
@@ -60,7 +69,8 @@ MI_Instance::operator = (
         SCX_BOOKEND_PRINT ("Different object type");
     }
     m_pObjectDecl = rval.m_pObjectDecl;
-    m_ValueMap = rval.m_ValueMap;
+    m_Values = rval.m_Values;
+    m_Names = rval.m_Names;
     return *this;
 }
 
@@ -80,18 +90,18 @@ MI_Instance::getValue (
     //SCX_BOOKEND ("MI_Instance::getValue");
     assert (ppValueOut);
     int rval = EXIT_FAILURE;
-    value_map_t::const_iterator pos = m_ValueMap.find (name);
-    if (m_ValueMap.end () != pos)
+    size_t const index = find_value (name);
+    if (index < m_Values.size ())
     {
-        // correct: the value was found, return it
-        *ppValueOut = pos->second;
+        // correct: the value is part of the MI_ObjectDecl or it was set, a
+        // value that was never set is NULL
+        *ppValueOut = m_Values[index];
         rval = EXIT_SUCCESS;
     }
-    else if (!m_pObjectDecl ||
-             m_pObjectDecl->getParameterDecl (name))
+    else if (!m_pObjectDecl)
     {
-        // correct: the value was not found in the instance but it is part
-        // of the MI_ObjectDecl
+        // correct: the value was not found in an instance without an
+        // MI_ObjectDecl
         rval = EXIT_SUCCESS;
     }
     else
@@ -109,47 +119,15 @@ MI_Instance::setValue (
 {
     //SCX_BOOKEND ("MI_Instance::setValue");
     int rval = EXIT_FAILURE;
+    size_t const index = find_value (name);
     if (m_pObjectDecl)
     {
-        MI_ParameterDecl::ConstPtr pParameterDecl =
-            m_pObjectDecl->getParameterDecl (name);
-        if (pParameterDecl)
+        if (index < m_Values.size ())
         {
             SCX_BOOKEND_PRINT ("the parameter does exist");
-            // correct: the parameter name is part of the MI_ObjectDecl
-            if (pValue)
-            {
-                // if the value is not NULL, check that the value type matches
-                // the MI_ParameterDecl
-                if ((pParameterDecl->getType ()->getValue ()) ==
-                        pValue->getType ())
-                {
-                    SCX_BOOKEND_PRINT ("the type matches");
-                    // correct: the type matches, set the new value
-                    std::pair<value_map_t::iterator, bool> ret =
-                        m_ValueMap.insert (std::make_pair (name, pValue));
-                    if (!ret.second)
-                    {
-                        //SCX_BOOKEND_PRINT ("replace an existing value");
-                        // correct: the value already existed, so replace the
-                        // value
-                        ret.first->second = pValue;
-                    }
-                    rval = EXIT_SUCCESS;
-                }
-                else
-                {
-                    SCX_BOOKEND_PRINT ("the type doesn't match");
-                    // error: the type does not match
-                }
-            }
-            else
-            {
-                SCX_BOOKEND_PRINT ("erase the value");
-                // correct: erase the value
-                m_ValueMap.erase (name);
-                rval = EXIT_SUCCESS;
-            }
+            // correct: the parameter name is part of the MI_ObjectDecl,
+            // setValueAt checks that the type matches
+            rval = setValueAt (static_cast<MI_Uint32>(index), pValue);
         }
         else
         {
@@ -159,25 +137,62 @@ MI_Instance::setValue (
     }
     else
     {
-        if (pValue)
+        if (index < m_Values.size ())
         {
-            std::pair<value_map_t::iterator, bool> ret =
-                m_ValueMap.insert (std::make_pair (name, pValue));
-            if (!ret.second)
-            {
-                //SCX_BOOKEND_PRINT ("replace an existing value");
-                // correct: the value already existed, so replace the
-                // value
-                ret.first->second = pValue;
-            }
+            // correct: the value already existed, so replace the value or
+            // clear it
+            m_Values[index] = pValue;
+        }
+        else if (pValue)
+        {
+            m_Names.push_back (name);
+            m_Values.push_back (pValue);
+        }
+        rval = EXIT_SUCCESS;
+    }
+    return rval;
+}
+
+
+int
+MI_Instance::getValueAt (
+    MI_Uint32 const& ordinal,
+    MI_ValueBase::Ptr* ppValueOut) const
+{
+    //SCX_BOOKEND ("MI_Instance::getValueAt");
+    assert (ppValueOut);
+    int rval = EXIT_FAILURE;
+    if (m_pObjectDecl &&
+        ordinal < m_Values.size ())
+    {
+        // a value that was never set is NULL
+        *ppValueOut = m_Values[ordinal];
+        rval = EXIT_SUCCESS;
+    }
+    return rval;
+}
+
+
+int
+MI_Instance::setValueAt (
+    MI_Uint32 const& ordinal,
+    MI_ValueBase::Ptr const& pValue)
+{
+    //SCX_BOOKEND ("MI_Instance::setValueAt");
+    int rval = EXIT_FAILURE;
+    if (m_pObjectDecl &&
+        ordinal < m_Values.size ())
+    {
+        if (!pValue ||
+            m_pObjectDecl->getParameterDecls ()[ordinal]->getType ()->
+                getValue () == pValue->getType ())
+        {
+            m_Values[ordinal] = pValue;
             rval = EXIT_SUCCESS;
         }
         else
         {
-            SCX_BOOKEND_PRINT ("erase the value");
-            // correct: erase the value
-            m_ValueMap.erase (name);
-            rval = EXIT_SUCCESS;
+            SCX_BOOKEND_PRINT ("the type doesn't match");
         }
     }
     return rval;
@@ -191,47 +206,210 @@ MI_Instance::send (
     SCX_BOOKEND ("MI_Instance::send");
     int rval = socket_wrapper::SUCCESS;
     unsigned int flags = m_pObjectDecl->isMethodDecl () ? 1 : 0;
+    MI_MethodDecl const* pMethodDecl = NULL;
+    MI_Uint32 classOrdinal = m_pObjectDecl->getOrdinal ();
+    if (protocol::MI_METHOD_FLAG == (protocol::MI_METHOD_FLAG & flags))
+    {
+        pMethodDecl = static_cast<MI_MethodDecl const*>(m_pObjectDecl.get ());
+        classOrdinal = pMethodDecl->getClassOrdinal ();
+    }
+    // the server has the same schema, so a declaration that is part of it
+    // is sent as its ordinal
+    if (protocol::NO_ORDINAL != classOrdinal &&
+        protocol::NO_ORDINAL != m_pObjectDecl->getOrdinal ())
+    {
+        flags |= protocol::MI_ORDINAL_FLAG;
+    }
     if (socket_wrapper::SUCCESS == rval)
     {
         SCX_BOOKEND ("send flags");
         rval = protocol::send (flags, sock);
     }
     if (socket_wrapper::SUCCESS == rval &&
-        protocol::MI_METHOD_FLAG == (protocol::MI_METHOD_FLAG & flags))
+        protocol::MI_ORDINAL_FLAG == (protocol::MI_ORDINAL_FLAG & flags))
     {
-        SCX_BOOKEND ("send origin");
-        MI_MethodDecl const* pMethodDecl =
-            static_cast<MI_MethodDecl const*>(m_pObjectDecl.get ());
-        rval = pMethodDecl->getOrigin ()->send (sock);
+        SCX_BOOKEND ("send ordinals");
+        rval = protocol::send (classOrdinal, sock);
+        if (socket_wrapper::SUCCESS == rval &&
+            NULL != pMethodDecl)
+        {
+            rval = protocol::send (pMethodDecl->getOrdinal (), sock);
+        }
     }
-    if (socket_wrapper::SUCCESS == rval)
+    else
     {
-        SCX_BOOKEND ("send Name");
-        rval = m_pObjectDecl->getName ()->send (sock);
+        if (socket_wrapper::SUCCESS == rval &&
+            NULL != pMethodDecl)
+        {
+            SCX_BOOKEND ("send origin");
+            rval = pMethodDecl->getOrigin ()->send (sock);
+        }
+        if (socket_wrapper::SUCCESS == rval)
+        {
+            SCX_BOOKEND ("send Name");
+            rval = m_pObjectDecl->getName ()->send (sock);
+        }
     }
     if (socket_wrapper::SUCCESS == rval)
     {
         SCX_BOOKEND ("send Size");
-        rval = protocol::send_item_count (m_ValueMap.size (), sock);
+        rval = protocol::send_item_count (
+            m_Values.size () -
+                std::count (m_Values.begin (), m_Values.end (),
+                            MI_ValueBase::Ptr ()),
+            sock);
+    }
+    // the values go in declaration order
+    for (MI_Uint32 ordinal = 0;
+         socket_wrapper::SUCCESS == rval &&
+             ordinal < m_Values.size ();
+         ++ordinal)
+    {
+        MI_ValueBase::Ptr const& pValue = m_Values[ordinal];
+        if (pValue)
+        {
+            SCX_BOOKEND ("send Value");
+            if (protocol::MI_ORDINAL_FLAG ==
+                    (protocol::MI_ORDINAL_FLAG & flags))
+            {
+                SCX_BOOKEND_PRINT ("-- ordinal --");
+                rval = protocol::send (ordinal, sock);
+            }
+            else
+            {
+                SCX_BOOKEND_PRINT ("-- name --");
+                rval = protocol::send (
+                    m_pObjectDecl->getParameterDecls ()[ordinal]->
+                        getName ()->getValue (),
+                    sock);
+            }
+            if (socket_wrapper::SUCCESS == rval)
+            {
+                SCX_BOOKEND_PRINT ("-- type --");
+                rval = protocol::send_type (pValue->getType (), sock);
+            }
+            if (socket_wrapper::SUCCESS == rval)
+            {
+                SCX_BOOKEND_PRINT ("-- value --");
+                rval = pValue->send (sock);
+            }
+        }
+    }
+    return rval;
+}
+
+
+int
+MI_Instance::sendDelta (
+    sent_values_t* const pSentValues,
+    socket_wrapper& sock) const
+{
+    SCX_BOOKEND ("MI_Instance::sendDelta");
+    assert (pSentValues);
+    if (m_pObjectDecl->isMethodDecl () ||
+        protocol::NO_ORDINAL == m_pObjectDecl->getOrdinal ())
+    {
+        return send (sock);
     }
-    for (value_map_t::const_iterator pos = m_ValueMap.begin (),
-             endPos = m_ValueMap.end ();
+    // the first instance of the class replaces the server's template, the
+    // ones after it are applied to it
+    unsigned int const flags = protocol::MI_ORDINAL_FLAG |
+        (pSentValues->empty () ?
+            protocol::MI_TEMPLATE_FLAG : protocol::MI_DELTA_FLAG);
+    // encode each value to find the ones that changed, a value can't be
+    // compared with what was sent any other way since it may have been
+    // changed in place
+    std::vector<MI_Uint32> changed;
+    std::vector<socket_wrapper::byte_t> encoded;
+    int rval = socket_wrapper::SUCCESS;
+    for (MI_Uint32 ordinal = 0;
+         socket_wrapper::SUCCESS == rval &&
+             ordinal < m_Values.size ();
+         ++ordinal)
+    {
+        MI_ValueBase::Ptr const& pValue = m_Values[ordinal];
+        if (pValue)
+        {
+            encoded.clear ();
+            socket_wrapper value (&encoded);
+            rval = protocol::send_type (pValue->getType (), value);
+            if (socket_wrapper::SUCCESS == rval)
+            {
+                rval = pValue->send (value);
+            }
+            if (socket_wrapper::SUCCESS == rval)
+            {
+                std::vector<socket_wrapper::byte_t>& sent =
+                    (*pSentValues)[ordinal];
+                if (sent != encoded)
+                {
+                    sent.swap (encoded);
+                    changed.push_back (ordinal);
+                }
+            }
+        }
+    }
+    typedef std::vector<std::pair<MI_Uint32, protocol::data_type_t> >
+        removed_list_t;
+    removed_list_t removed;
+    for (sent_values_t::iterator pos = pSentValues->begin ();
+         socket_wrapper::SUCCESS == rval &&
+             pos != pSentValues->end ();)
+    {
+        if (m_Values.size () <= pos->first ||
+            !m_Values[pos->first])
+        {
+            // the type is the first byte of the encoding
+            removed.push_back (std::make_pair (
+                pos->first,
+                static_cast<protocol::data_type_t>(pos->second[0])));
+            pSentValues->erase (pos++);
+        }
+        else
+        {
+            ++pos;
+        }
+    }
+    if (socket_wrapper::SUCCESS == rval)
+    {
+        rval = protocol::send (flags, sock);
+    }
+    if (socket_wrapper::SUCCESS == rval)
+    {
+        rval = protocol::send (m_pObjectDecl->getOrdinal (), sock);
+    }
+    if (socket_wrapper::SUCCESS == rval)
+    {
+        rval = protocol::send_item_count (
+            changed.size () + removed.size (), sock);
+    }
+    for (std::vector<MI_Uint32>::const_iterator pos = changed.begin (),
+             endPos = changed.end ();
          socket_wrapper::SUCCESS == rval &&
              pos != endPos;
          ++pos)
     {
-        SCX_BOOKEND ("send Value");
-        SCX_BOOKEND_PRINT ("-- name --");
-        rval = protocol::send (pos->first, sock);
+        std::vector<socket_wrapper::byte_t> const& sent =
+            (*pSentValues)[*pos];
+        rval = protocol::send (*pos, sock);
         if (socket_wrapper::SUCCESS == rval)
         {
-            SCX_BOOKEND_PRINT ("-- type --");
-            rval = protocol::send_type (pos->second->getType (), sock);
+            rval = sock.send (&sent[0], sent.size ());
         }
+    }
+    for (removed_list_t::const_iterator pos = removed.begin (),
+             endPos = removed.end ();
+         socket_wrapper::SUCCESS == rval &&
+             pos != endPos;
+         ++pos)
+    {
+        rval = protocol::send (pos->first, sock);
         if (socket_wrapper::SUCCESS == rval)
         {
-            SCX_BOOKEND_PRINT ("-- value --");
-            rval = pos->second->send (sock);
+            rval = protocol::send_type (
+                static_cast<protocol::data_type_t>(
+                    pos->second | protocol::MI_NULL_FLAG),
+                sock);
         }
     }
     return rval;
@@ -246,7 +424,7 @@ MI_Instance::recv (
 {
     SCX_BOOKEND ("MI_Instance::recv");
     MI_Value<MI_STRING>::Ptr pClassName;
-    int rval = MI_Value<MI_STRING>::recv (&pClassName, sock);
+    int rval = string_table::recv (&pClassName, sock);
     if (socket_wrapper::SUCCESS == rval)
     {
         MI_ObjectDecl::ConstPtr pObjectDecl =
@@ -279,22 +457,12 @@ MI_Instance::recv (
     assert (ppInstanceOut);
     assert (pObjectDecl);
     assert (pSchemaDecl);
-    value_map_t valueMap;
-    int rval = recv_values (&valueMap, pSchemaDecl, sock);
+    MI_Instance::Ptr pInstance (new MI_Instance (pObjectDecl));
+    int rval = pInstance->recv_values (pSchemaDecl, sock);
     if (socket_wrapper::SUCCESS == rval)
     {
         SCX_BOOKEND_PRINT ("values read successfully");
-        rval = confirm_values (valueMap, pObjectDecl);
-        if (EXIT_SUCCESS == rval)
-        {
-            SCX_BOOKEND_PRINT ("value confirmation succeeded");
-            ppInstanceOut->reset (new MI_Instance (pObjectDecl));
-            std::swap ((*ppInstanceOut)->m_ValueMap, valueMap);
-        }
-        else 
-        {
-            SCX_BOOKEND_PRINT ("value confirmation failed");
-        }
+        *ppInstanceOut = UTIL_MOVE (pInstance);
     }
     else
     {
@@ -304,9 +472,8 @@ MI_Instance::recv (
 }
 
 
-/*static*/ int
+int
 MI_Instance::recv_values (
-    value_map_t* const pValueMapOut,
     MI_SchemaDecl::ConstPtr const& pSchemaDecl,
     socket_wrapper& sock)
 {
@@ -320,7 +487,10 @@ MI_Instance::recv_values (
         strm << "item count: " << itemCount;
         SCX_BOOKEND_PRINT (strm.str ());
     }
-    value_map_t values;
+    // every value is read before a name that isn't part of the
+    // MI_ObjectDecl, or a value that isn't of the declared type, fails the
+    // instance
+    bool confirmed = true;
     if (socket_wrapper::SUCCESS == rval)
     {
         SCX_BOOKEND ("read values");
@@ -331,7 +501,7 @@ MI_Instance::recv_values (
             SCX_BOOKEND ("read value");
             MI_Value<MI_STRING>::Ptr pValueName;
             SCX_BOOKEND_PRINT ("-- name --");
-            rval = MI_Value<MI_STRING>::recv (&pValueName, sock);
+            rval = string_table::recv (&pValueName, sock);
             protocol::data_type_t type;
             if (socket_wrapper::SUCCESS == rval)
             {
@@ -347,98 +517,98 @@ MI_Instance::recv_values (
                 {
                     MI_Value<MI_BOOLEAN>::Ptr pTemp;
                     rval = MI_Value<MI_BOOLEAN>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_UINT8:
                 {
                     MI_Value<MI_UINT8>::Ptr pTemp;
                     rval = MI_Value<MI_UINT8>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_SINT8:
                 {
                     MI_Value<MI_SINT8>::Ptr pTemp;
                     rval = MI_Value<MI_SINT8>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_UINT16:
                 {
                     MI_Value<MI_UINT16>::Ptr pTemp;
                     rval = MI_Value<MI_UINT16>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_SINT16:
                 {
                     MI_Value<MI_SINT16>::Ptr pTemp;
                     rval = MI_Value<MI_SINT16>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_UINT32:
                 {
                     MI_Value<MI_UINT32>::Ptr pTemp;
                     rval = MI_Value<MI_UINT32>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_SINT32:
                 {
                     MI_Value<MI_SINT32>::Ptr pTemp;
                     rval = MI_Value<MI_SINT32>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_UINT64:
                 {
                     MI_Value<MI_UINT64>::Ptr pTemp;
                     rval = MI_Value<MI_UINT64>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_SINT64:
                 {
-                    MI_Value<MI_SINT16>::Ptr pTemp;
-                    rval = MI_Value<MI_SINT16>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    MI_Value<MI_SINT64>::Ptr pTemp;
+                    rval = MI_Value<MI_SINT64>::recv (&pTemp, sock);
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_REAL32:
                 {
                     MI_Value<MI_REAL32>::Ptr pTemp;
                     rval = MI_Value<MI_REAL32>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_REAL64:
                 {
                     MI_Value<MI_REAL64>::Ptr pTemp;
                     rval = MI_Value<MI_REAL64>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_CHAR16:
                 {
                     MI_Value<MI_CHAR16>::Ptr pTemp;
                     rval = MI_Value<MI_CHAR16>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_DATETIME:
                 {
                     MI_Datetime::Ptr pTemp;
                     rval = MI_Datetime::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_STRING:
                 {
                     MI_Value<MI_STRING>::Ptr pTemp;
                     rval = MI_Value<MI_STRING>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_REFERENCE:
@@ -452,105 +622,105 @@ MI_Instance::recv_values (
                 {
                     MI_Instance::Ptr pTemp;
                     rval = recv (&pTemp, pSchemaDecl, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_BOOLEANA:
                 {
                     MI_Array<MI_BOOLEANA>::Ptr pTemp;
                     rval = MI_Array<MI_BOOLEANA>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_UINT8A:
                 {
                     MI_Array<MI_UINT8A>::Ptr pTemp;
                     rval = MI_Array<MI_UINT8A>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_SINT8A:
                 {
                     MI_Array<MI_SINT8A>::Ptr pTemp;
                     rval = MI_Array<MI_SINT8A>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_UINT16A:
                 {
                     MI_Array<MI_UINT16A>::Ptr pTemp;
                     rval = MI_Array<MI_UINT16A>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_SINT16A:
                 {
                     MI_Array<MI_SINT16A>::Ptr pTemp;
                     rval = MI_Array<MI_SINT16A>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_UINT32A:
                 {
                     MI_Array<MI_UINT32A>::Ptr pTemp;
                     rval = MI_Array<MI_UINT32A>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_SINT32A:
                 {
                     MI_Array<MI_SINT32A>::Ptr pTemp;
                     rval = MI_Array<MI_SINT32A>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_UINT64A:
                 {
                     MI_Array<MI_UINT64A>::Ptr pTemp;
                     rval = MI_Array<MI_UINT64A>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_SINT64A:
                 {
                     MI_Array<MI_SINT64A>::Ptr pTemp;
                     rval = MI_Array<MI_SINT64A>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_REAL32A:
                 {
                     MI_Array<MI_REAL32A>::Ptr pTemp;
                     rval = MI_Array<MI_REAL32A>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_REAL64A:
                 {
                     MI_Array<MI_REAL64A>::Ptr pTemp;
                     rval = MI_Array<MI_REAL64A>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_CHAR16A:
                 {
                     MI_Array<MI_CHAR16A>::Ptr pTemp;
                     rval = MI_Array<MI_CHAR16A>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_DATETIMEA:
                 {
                     MI_Array<MI_DATETIMEA>::Ptr pTemp;
                     rval = MI_Array<MI_DATETIMEA>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_STRINGA:
                 {
                     MI_Array<MI_STRINGA>::Ptr pTemp;
                     rval = MI_Array<MI_STRINGA>::recv (&pTemp, sock);
-                    pValue = pTemp.get ();
+                    pValue = UTIL_MOVE (pTemp);
                     break;
                 }
                 case MI_REFERENCEA:
@@ -563,19 +733,36 @@ MI_Instance::recv_values (
                     SCX_BOOKEND_PRINT ("MI_INSTANCEA not implemented");
                     rval = EXIT_FAILURE;
                     break;
+                default:
+                    SCX_BOOKEND_PRINT ("unknown type");
+                    rval = EXIT_FAILURE;
+                    break;
                 }
                 if (socket_wrapper::SUCCESS == rval)
                 {
                     //std::ostringstream strm;
                     //strm << "adding value: " << pValueName->getValue ();
                     //SCX_BOOKEND_PRINT (strm.str ().c_str ());
-                    std::pair<value_map_t::iterator, bool> ret =
-                        values.insert (
-                            std::make_pair (pValueName->getValue (), pValue));
-                    if (!ret.second)
+                    size_t const index = find_value (pValueName);
+                    if (index < m_Values.size ())
+                    {
+                        if (m_pObjectDecl->getParameterDecls ()[index]->
+                                getType ()->getValue () == pValue->getType ())
+                        {
+                            m_Values[index] = UTIL_MOVE (pValue);
+                        }
+                        else
+                        {
+                            // as setValueAt, a value of another type is not
+                            // stored
+                            SCX_BOOKEND_PRINT ("the type does not match");
+                            confirmed = false;
+                        }
+                    }
+                    else
                     {
-                        //SCX_BOOKEND_PRINT ("replace an existing value");
-                        ret.first->second = pValue;
+                        SCX_BOOKEND_PRINT ("the parameter does not exist");
+                        confirmed = false;
                     }
                 }
                 else
@@ -585,42 +772,56 @@ MI_Instance::recv_values (
             }
         }
     }
-    if (EXIT_SUCCESS == rval)
+    if (EXIT_SUCCESS == rval &&
+        !confirmed)
     {
-        std::swap (values, *pValueMapOut);
+        rval = EXIT_FAILURE;
     }
     return rval;
 }
 
 
-/*static*/ int
-MI_Instance::confirm_values (
-    value_map_t const& valueMap,
-    MI_ObjectDecl::ConstPtr const& pObjectDecl)
+size_t
+MI_Instance::find_value (
+    MI_Value<MI_STRING>::type_t const& name) const
 {
-    SCX_BOOKEND ("MI_Instance::confirm_values");
-    int rval = EXIT_SUCCESS;
-    for (value_map_t::const_iterator pos = valueMap.begin (),
-             endPos = valueMap.end ();
-         EXIT_SUCCESS == rval && pos != endPos;
-         ++pos)
+    size_t index = m_Values.size ();
+    if (m_pObjectDecl)
     {
-        MI_ParameterDecl::ConstPtr pParameterDecl =
-            pObjectDecl->getParameterDecl (pos->first);
-        if (!pParameterDecl)
+        MI_Uint32 const ordinal = m_pObjectDecl->getParameterOrdinal (name);
+        if (protocol::NO_ORDINAL != ordinal)
         {
-            //std::ostringstream strm;
-            //strm << "the parameter does not exist: " << pos->first;
-            //SCX_BOOKEND_PRINT (strm.str ().c_str ());
-            rval = EXIT_FAILURE;
+            index = ordinal;
         }
-        else if (pParameterDecl->getType ()->getValue () !=
-                 pos->second->getType ())
+    }
+    else
+    {
+        index = std::find (m_Names.begin (), m_Names.end (), name) -
+            m_Names.begin ();
+    }
+    return index;
+}
+
+
+size_t
+MI_Instance::find_value (
+    MI_Value<MI_STRING>::ConstPtr const& pName) const
+{
+    size_t index = m_Values.size ();
+    if (m_pObjectDecl)
+    {
+        // a received name is interned and usually is the declaration's own
+        MI_Uint32 const ordinal = m_pObjectDecl->getParameterOrdinal (pName);
+        if (protocol::NO_ORDINAL != ordinal)
         {
-            SCX_BOOKEND_PRINT ("the type does not match");
+            index = ordinal;
         }
     }
-    return rval;
+    else if (pName)
+    {
+        index = find_value (pName->getValue ());
+    }
+    return index;
 }
 
 
@@ -10,6 +10,7 @@
 
 
 #include <map>
+#include <vector>
 
 
 namespace scx
@@ -30,7 +31,13 @@ class EXPORT_PUBLIC MI_Instance : public MI_ValueBase
 public:
     typedef util::internal_counted_ptr<MI_Instance> Ptr;
     typedef util::internal_counted_ptr<MI_Instance const> ConstPtr;
-    typedef std::map<MI_Type<MI_STRING>::type_t, MI_ValueBase::Ptr> value_map_t;
+    // the values, by the ordinal of their declaration, or for an instance
+    // without an MI_ObjectDecl, in the order they were first set
+    typedef std::vector<MI_ValueBase::Ptr> value_list_t;
+    // the encoded type and value last sent for each value of a class, by
+    // ordinal (see sendDelta)
+    typedef std::map<MI_Uint32, std::vector<socket_wrapper::byte_t> >
+        sent_values_t;
 
     EXPORT_PUBLIC explicit /*ctor*/ MI_Instance (
         util::internal_counted_ptr<MI_ObjectDecl const> const& pObjectDecl);
@@ -51,7 +58,24 @@ public:
         MI_Value<MI_STRING>::type_t const& name,
         MI_ValueBase::Ptr const& pValue);
 
+    // get and set a value by its ordinal in the declaration, which saves
+    // looking up the declaration by name
+    EXPORT_PUBLIC int getValueAt (
+        MI_Uint32 const& ordinal,
+        MI_ValueBase::Ptr* ppValueOut) const;
+    EXPORT_PUBLIC int setValueAt (
+        MI_Uint32 const& ordinal,
+        MI_ValueBase::Ptr const& pValue);
+
     EXPORT_PUBLIC int send (socket_wrapper& sock) const;
+    // sendDelta sends only the values that differ from *pSentValues, what
+    // the last instance of the class that was sent held, and updates it.  An
+    // instance that can't be sent that way (a method's parameters, or one
+    // that isn't part of the schema) is sent whole and leaves *pSentValues
+    // alone.
+    EXPORT_PUBLIC int sendDelta (
+        sent_values_t* const pSentValues,
+        socket_wrapper& sock) const;
 
     static int recv (
         Ptr* const ppInstanceOut,
@@ -65,17 +89,18 @@ public:
         socket_wrapper& sock);
 
 private:
-    static int recv_values (
-        value_map_t* const pValueMapOut,
+    // the index of name in m_Values or m_Values.size () if there is none
+    size_t find_value (MI_Value<MI_STRING>::type_t const& name) const;
+    size_t find_value (MI_Value<MI_STRING>::ConstPtr const& pName) const;
+
+    int recv_values (
         util::internal_counted_ptr<MI_SchemaDecl const> const& pSchemaDecl,
         socket_wrapper& sock);
 
-    static int confirm_values (
-        value_map_t const& valueMap,
-        util::internal_counted_ptr<MI_ObjectDecl const> const& pObjectDecl);
-
     util::internal_counted_ptr<MI_ObjectDecl const> m_pObjectDecl;
-    value_map_t m_ValueMap;
+    value_list_t m_Values;
+    // the names of the values of an instance without an MI_ObjectDecl
+    std::vector<MI_Value<MI_STRING>::type_t> m_Names;
 };
 
 
@@ -1,17 +1,48 @@
 // Copyright (c) Microsoft Corporation.  All rights reserved.
 // Licensed under the MIT license.
 #include "debug_tags.hpp"
-#include "server_protocol.hpp"
-#include "server.hpp"
+#include "server_pool.hpp"
 #include "unique_ptr.hpp"
 #include "mi_module_self.hpp"
 #include "mi_value.hpp"
 
 
 #include <MI.h>
+#include <cstdlib>
 #include <sstream>
 
 
+namespace
+{
+
+
+// the number of workers set by the environment variable name, or
+// defaultCount if it isn't set to a positive number
+size_t
+get_worker_count (
+    char const* const name,
+    size_t const& defaultCount)
+{
+    size_t count = defaultCount;
+    char const* const value = getenv (name);
+    if (NULL != value)
+    {
+        char* pEnd = NULL;
+        unsigned long const parsed = strtoul (value, &pEnd, 10);
+        if (pEnd != value &&
+            '\0' == *pEnd &&
+            0 < parsed)
+        {
+            count = parsed;
+        }
+    }
+    return count;
+}
+
+
+} // namespace (unnamed)
+
+
 void
 MI_CALL Load (
     MI_Module_Self** ppSelf,
@@ -22,7 +53,7 @@ MI_CALL Load (
     strm << " ModuleName=\"" << (*ppSelf)->ModuleName << "\"";
     SCX_BOOKEND_EX ("Load: mi_main.cpp", strm.str ().c_str ());
 #endif
-    (*ppSelf)->pServer->Module_Load (ppSelf, pContext);
+    (*ppSelf)->pPool->Module_Load (ppSelf, pContext);
 }
 
 
@@ -36,7 +67,7 @@ MI_CALL Unload (
     strm << " ModuleName=\"" << pSelf->ModuleName << "\"";
     SCX_BOOKEND_EX ("Unload: mi_main.cpp", strm.str ().c_str ());
 #endif
-    pSelf->pServer->Module_Unload (pSelf, pContext);
+    pSelf->pPool->Module_Unload (pSelf, pContext);
     delete pSelf;
 }
 
@@ -74,13 +105,19 @@ Start (
     pSelf->Module.Load = Load;
     pSelf->Module.Unload = Unload;
     pSelf->Module.dynamicProviderFT = NULL;
-    pSelf->pServer.reset (new Server (interpreter, startup, moduleName));
-    if (Server::SUCCESS == pSelf->pServer->open () &&
-        socket_wrapper::SUCCESS ==
-            protocol::recv (&(pSelf->Module.schemaDecl),
-                            *(pSelf->pServer->getSocket ())))
+    // OMI_SCRIPT_PROVIDER_WORKERS client processes are started with the
+    // module, and more are started while they are all busy up to
+    // OMI_SCRIPT_PROVIDER_MAX_WORKERS
+    size_t const minWorkers = get_worker_count (
+        "OMI_SCRIPT_PROVIDER_WORKERS", server_pool::DEFAULT_WORKER_COUNT);
+    size_t const maxWorkers = get_worker_count (
+        "OMI_SCRIPT_PROVIDER_MAX_WORKERS", minWorkers);
+    pSelf->pPool.reset (new server_pool (
+        interpreter, startup, moduleName, minWorkers, maxWorkers));
+    if (Server::SUCCESS == pSelf->pPool->open ())
     {
-        pSelf->pServer->setSchema (pSelf->Module.schemaDecl);
+        pSelf->Module.schemaDecl =
+            const_cast<MI_SchemaDecl*>(pSelf->pPool->getSchemaDecl ());
         *ppSelf = pSelf.release ();
         return &((*ppSelf)->Module);
     }
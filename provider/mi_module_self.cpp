@@ -4,7 +4,7 @@
 
 
 #include "debug_tags.hpp"
-#include "server.hpp"
+#include "server_pool.hpp"
 
 
 #include <sstream>
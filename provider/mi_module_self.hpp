@@ -11,7 +11,7 @@
 #include <string>
 
 
-class Server;
+class server_pool;
 
 
 struct _MI_Module_Self
@@ -20,7 +20,7 @@ struct _MI_Module_Self
     /*dtor*/ ~_MI_Module_Self ();
 
     std::string ModuleName;
-    util::unique_ptr<Server> pServer;
+    util::unique_ptr<server_pool> pPool;
     MI_Module Module;
 };
 
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cctype>
+#include "hash_table.hpp"
 #include "shared_protocol.hpp"
 
 
@@ -78,24 +79,82 @@ findClassDecl (
 }
 
 
-template<typename OBJECT>
-struct Finder
+// stops a probe of an index of ordinals into decls at an empty slot or at
+// the declaration named name; a name that is the declaration's own interned
+// value matches without comparing the text
+template<typename FOLD, typename DECLS>
+class ordinal_probe
 {
-    /*ctor*/ Finder (scx::MI_Value<MI_STRING>::type_t const& name)
-        : m_Name (name)
+public:
+    /*ctor*/ ordinal_probe (
+        DECLS const& decls,
+        scx::MI_Value<MI_STRING> const* const pName,
+        MI_Char const* const name)
+        : m_Decls (decls)
+        , m_pName (pName)
+        , m_Name (name)
     {
         // empty
     }
 
-    bool operator () (typename OBJECT::ConstPtr const& pObject)
+    bool operator () (MI_Uint32 const ordinal) const
     {
-        return m_Name == pObject->getName ()->getValue ();
+        return protocol::NO_ORDINAL == ordinal ||
+            m_pName == m_Decls[ordinal]->getName ().get () ||
+            util::equal_names<FOLD> (
+                m_Name, m_Decls[ordinal]->getName ()->getValue ().c_str ());
     }
 
-    scx::MI_Value<MI_STRING>::type_t const& m_Name;
+private:
+    DECLS const& m_Decls;
+    scx::MI_Value<MI_STRING> const* const m_pName;
+    MI_Char const* const m_Name;
 };
 
 
+// fill *pIndex with the ordinals of decls by name; the first of any
+// duplicate names wins
+template<typename FOLD, typename DECLS>
+void
+build_index (
+    DECLS const& decls,
+    std::vector<MI_Uint32>* const pIndex)
+{
+    pIndex->assign (util::hash_table_size (decls.size ()),
+                    protocol::NO_ORDINAL);
+    for (size_t i = 0; i < decls.size (); ++i)
+    {
+        scx::MI_Value<MI_STRING> const* const pName =
+            decls[i]->getName ().get ();
+        MI_Char const* const name = pName->getValue ().c_str ();
+        size_t const pos = util::hash_probe (
+            *pIndex, util::hash_name<FOLD> (name),
+            ordinal_probe<FOLD, DECLS> (decls, pName, name));
+        if (protocol::NO_ORDINAL == (*pIndex)[pos])
+        {
+            (*pIndex)[pos] = static_cast<MI_Uint32>(i);
+        }
+    }
+}
+
+
+// the ordinal of the declaration named name (pName when it is interned) or
+// protocol::NO_ORDINAL
+template<typename FOLD, typename DECLS>
+MI_Uint32
+find_ordinal (
+    DECLS const& decls,
+    std::vector<MI_Uint32> const& index,
+    scx::MI_Value<MI_STRING> const* const pName,
+    MI_Char const* const name)
+{
+    return index.empty () ? protocol::NO_ORDINAL :
+        index[util::hash_probe (
+            index, util::hash_name<FOLD> (name),
+            ordinal_probe<FOLD, DECLS> (decls, pName, name))];
+}
+
+
 } // namespace (unnamed)
 
 
@@ -325,7 +384,7 @@ MI_ParameterDecl::MI_ParameterDecl (
     MI_Value<MI_STRING>::ConstPtr const& className)
     : m_pFlags (flags)
     , m_pCode (code)
-    , m_pName (name)
+    , m_pName (string_table::intern (name))
     , m_Qualifiers (ppQualifiersBegin, ppQualifiersBegin + qualifiersCount)
     , m_pType (type)
     , m_pClassName (className)
@@ -626,14 +685,17 @@ MI_ObjectDecl::MI_ObjectDecl (
     size_t const& parametersCount)
     : m_pFlags (pFlags)
     , m_pCode (pCode)
-    , m_pName (pName)
+    , m_pName (string_table::intern (pName))
     , m_Qualifiers (ppQualifiersBegin, ppQualifiersBegin + qualifiersCount)
     , m_Parameters (ppParametersBegin, ppParametersBegin + parametersCount)
+    , m_ParameterIndex ()
+    , m_Ordinal (protocol::NO_ORDINAL)
 {
     OBJ_BOOKEND ("MI_ObjectDecl::ctor");
     assert (pFlags);
     assert (pCode);
     assert (pName);
+    build_index<util::exact_char> (m_Parameters, &m_ParameterIndex);
 }
 
 
@@ -656,18 +718,32 @@ MI_ObjectDecl::getParameterDecl (
     MI_Value<MI_STRING>::type_t const& parameterName) const
 {
     OBJ_BOOKEND ("MI_ObjectDecl::getParameterDecl");
-    MI_ParameterDecl::ConstPtr pParameterDecl;
-    std::vector<MI_ParameterDecl::ConstPtr>::const_iterator
-        parameterDeclPos = std::find_if (
-            m_Parameters.begin (), m_Parameters.end (),
-            Finder<MI_ParameterDecl> (parameterName));
-    if (m_Parameters.end () != parameterDeclPos)
-    {
-        // correct: the parameter name is part of the MI_ClassDecl
-        // clear the return value and return success
-        pParameterDecl = *parameterDeclPos;
-    }
-    return pParameterDecl;
+    MI_Uint32 const ordinal = getParameterOrdinal (parameterName);
+    return protocol::NO_ORDINAL != ordinal ?
+        m_Parameters[ordinal] : MI_ParameterDecl::ConstPtr ();
+}
+
+
+MI_Uint32
+MI_ObjectDecl::getParameterOrdinal (
+    MI_Value<MI_STRING>::type_t const& parameterName) const
+{
+    OBJ_BOOKEND ("MI_ObjectDecl::getParameterOrdinal");
+    return find_ordinal<util::exact_char> (
+        m_Parameters, m_ParameterIndex, NULL, parameterName.c_str ());
+}
+
+
+MI_Uint32
+MI_ObjectDecl::getParameterOrdinal (
+    MI_Value<MI_STRING>::ConstPtr const& pParameterName) const
+{
+    OBJ_BOOKEND ("MI_ObjectDecl::getParameterOrdinal");
+    return pParameterName ?
+        find_ordinal<util::exact_char> (
+            m_Parameters, m_ParameterIndex, pParameterName.get (),
+            pParameterName->getValue ().c_str ()) :
+        protocol::NO_ORDINAL;
 }
 
 
@@ -692,6 +768,20 @@ MI_ObjectDecl::getName () const
 }
 
 
+MI_Uint32
+MI_ObjectDecl::getOrdinal () const
+{
+    return m_Ordinal;
+}
+
+
+std::vector<MI_ParameterDecl::ConstPtr> const&
+MI_ObjectDecl::getParameterDecls () const
+{
+    return m_Parameters;
+}
+
+
 int
 MI_ObjectDecl::send (
     socket_wrapper& sock) const
@@ -778,6 +868,7 @@ MI_MethodDecl::MI_MethodDecl (
     , m_pPropagator (pPropagator)
     , m_pSchemaDecl (NULL)
     , m_pInvokeFn (pInvokeFn)
+    , m_ClassOrdinal (protocol::NO_ORDINAL)
 {
     METH_BOOKEND ("MI_MethodDecl::ctor");
     assert (pFlags);
@@ -830,6 +921,13 @@ MI_MethodDecl::getInvokeFn () const
 }
 
 
+MI_Uint32
+MI_MethodDecl::getClassOrdinal () const
+{
+    return m_ClassOrdinal;
+}
+
+
 int
 MI_MethodDecl::send (
     socket_wrapper& sock) const
@@ -921,7 +1019,7 @@ MI_ClassDecl::MI_ClassDecl (
     , m_pFunctionTable (pFunctionTable)
 {
     CLASS_BOOKEND ("MI_ClassDecl::ctor");
-    // empty
+    build_index<util::folded_char> (m_MethodDecls, &m_MethodIndex);
 }
 
 
@@ -949,28 +1047,26 @@ MI_ClassDecl::getMethodDecl (
     MI_Value<MI_STRING>::type_t const& methodName) const
 {
     CLASS_BOOKEND ("MI_ClassDecl::getMethodDecl");
-    MI_MethodDecl::ConstPtr pMethodDecl;
-    std::vector<MI_MethodDecl::Ptr>::const_iterator
-        methodDeclPos = std::find_if (
-            m_MethodDecls.begin (), m_MethodDecls.end (),
-            Finder<MI_MethodDecl> (methodName));
-    if (m_MethodDecls.end () != methodDeclPos)
-    {
-        // correct: the property name is part of the MI_ClassDecl
-        // clear the return value and return success
-        pMethodDecl = *methodDeclPos;
-#if (PRINT_CLASS)
-        if (NULL == methodDeclPos->get ())
-        {
-            CLASS_PRINT ("methodDeclPos->get () is NULL");
-        }
-        else
-        {
-            CLASS_PRINT ("methodDeclPos->get () is not NULL");
-        }
-#endif
-    }
-    return pMethodDecl;
+    // method names are not case sensitive, as they aren't for the server
+    MI_Uint32 const ordinal = find_ordinal<util::folded_char> (
+        m_MethodDecls, m_MethodIndex, NULL, methodName.c_str ());
+    return protocol::NO_ORDINAL != ordinal ?
+        m_MethodDecls[ordinal] : MI_MethodDecl::Ptr ();
+}
+
+
+MI_MethodDecl::ConstPtr
+MI_ClassDecl::getMethodDecl (
+    MI_Value<MI_STRING>::ConstPtr const& pMethodName) const
+{
+    CLASS_BOOKEND ("MI_ClassDecl::getMethodDecl");
+    MI_Uint32 const ordinal = pMethodName ?
+        find_ordinal<util::folded_char> (
+            m_MethodDecls, m_MethodIndex, pMethodName.get (),
+            pMethodName->getValue ().c_str ()) :
+        protocol::NO_ORDINAL;
+    return protocol::NO_ORDINAL != ordinal ?
+        m_MethodDecls[ordinal] : MI_MethodDecl::Ptr ();
 }
 
 
@@ -1101,13 +1197,16 @@ MI_SchemaDecl::MI_SchemaDecl (
     SCHEMA_BOOKEND ("MI_SchemaDecl::ctor");
     // sort the class decls by name
     std::sort (m_ClassDecls.begin (), m_ClassDecls.end (), classDeclSort);
-    // loop through all of the class decls to set schema decl members
+    // loop through all of the class decls to set schema decl members, the
+    // ordinals match the order the schema is sent in
     for (std::vector<MI_ClassDecl::Ptr>::iterator pos = m_ClassDecls.begin (),
              endPos = m_ClassDecls.end ();
          pos != endPos;
          ++pos)
     {
         (*pos)->m_pSchemaDecl = this;
+        (*pos)->m_Ordinal =
+            static_cast<MI_Uint32>(pos - m_ClassDecls.begin ());
         for (std::vector<MI_MethodDecl::Ptr>::iterator
                  methodPos = (*pos)->m_MethodDecls.begin (),
                  methodEndPos = (*pos)->m_MethodDecls.end ();
@@ -1115,6 +1214,9 @@ MI_SchemaDecl::MI_SchemaDecl (
              ++methodPos)
         {
             (*methodPos)->m_pSchemaDecl = this;
+            (*methodPos)->m_Ordinal = static_cast<MI_Uint32>(
+                methodPos - (*pos)->m_MethodDecls.begin ());
+            (*methodPos)->m_ClassOrdinal = (*pos)->m_Ordinal;
         }
     }
 }
@@ -1127,6 +1229,13 @@ MI_SchemaDecl::~MI_SchemaDecl ()
 }
 
 
+std::vector<MI_ClassDecl::Ptr> const&
+MI_SchemaDecl::getClassDecls () const
+{
+    return m_ClassDecls;
+}
+
+
 MI_ClassDecl::ConstPtr
 MI_SchemaDecl::getClassDecl (
     MI_Value<MI_STRING>::ConstPtr const& pClassName) const
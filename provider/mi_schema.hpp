@@ -197,10 +197,25 @@ public:
     EXPORT_PUBLIC MI_ParameterDecl::ConstPtr getParameterDecl (
         MI_Value<MI_STRING>::type_t const& parameterName) const;
 
+    // the index of the parameter in the declaration or protocol::NO_ORDINAL
+    EXPORT_PUBLIC MI_Uint32 getParameterOrdinal (
+        MI_Value<MI_STRING>::type_t const& parameterName) const;
+    // as above, a name that is the declaration's own interned value is
+    // matched without comparing the text
+    EXPORT_PUBLIC MI_Uint32 getParameterOrdinal (
+        MI_Value<MI_STRING>::ConstPtr const& pParameterName) const;
+
+    // the parameters (or properties) in declaration order, by ordinal
+    std::vector<MI_ParameterDecl::ConstPtr> const& getParameterDecls () const;
+
     MI_Value<MI_UINT32>::ConstPtr const& getFlags () const;
     MI_Value<MI_UINT32>::ConstPtr const& getCode () const;
     MI_Value<MI_STRING>::ConstPtr const& getName () const;
 
+    // the index of a class in its MI_SchemaDecl, or of a method in its
+    // MI_ClassDecl; protocol::NO_ORDINAL until the schema is built
+    MI_Uint32 getOrdinal () const;
+
     virtual int send (socket_wrapper& sock) const;
 
 private:
@@ -212,6 +227,10 @@ private:
     MI_Value<MI_STRING>::ConstPtr const m_pName;
     std::vector<MI_Qualifier::ConstPtr> const m_Qualifiers;
     std::vector<MI_ParameterDecl::ConstPtr> const m_Parameters;
+    // an open addressed hash table of the parameter ordinals by name; a
+    // power of 2 in size with empty slots holding protocol::NO_ORDINAL
+    std::vector<MI_Uint32> m_ParameterIndex;
+    MI_Uint32 m_Ordinal;
 
     friend class MI_SchemaDecl;
 };
@@ -253,6 +272,8 @@ public:
     MI_Value<MI_STRING>::ConstPtr const& getOrigin () const;
     MI_Value<MI_STRING>::ConstPtr const& getPropagator () const;
     InvokeFn::ConstPtr const& getInvokeFn () const;
+    // the ordinal of the MI_ClassDecl the method belongs to
+    MI_Uint32 getClassOrdinal () const;
 
     int send (socket_wrapper& sock) const;
 
@@ -273,6 +294,7 @@ private:
     MI_Value<MI_STRING>::ConstPtr const m_pPropagator;
     MI_SchemaDecl const* m_pSchemaDecl;
     InvokeFn::ConstPtr const m_pInvokeFn;
+    MI_Uint32 m_ClassOrdinal;
 
     friend class MI_SchemaDecl;
 };
@@ -308,6 +330,8 @@ public:
 
     EXPORT_PUBLIC MI_MethodDecl::ConstPtr getMethodDecl (
         MI_Value<MI_STRING>::type_t const& methodName) const;
+    EXPORT_PUBLIC MI_MethodDecl::ConstPtr getMethodDecl (
+        MI_Value<MI_STRING>::ConstPtr const& pMethodName) const;
 
     MI_Value<MI_STRING>::ConstPtr const& getSuperClassName () const;
     MI_ClassDecl::ConstPtr const& getSuperClassDecl () const;
@@ -327,6 +351,10 @@ private:
     MI_Value<MI_STRING>::ConstPtr const m_pSuperClassName;
     MI_ClassDecl::ConstPtr m_pSuperClassDecl;
     std::vector<MI_MethodDecl::Ptr> m_MethodDecls;
+    // an open addressed hash table of the method ordinals by case folded
+    // name; a power of 2 in size with empty slots holding
+    // protocol::NO_ORDINAL
+    std::vector<MI_Uint32> m_MethodIndex;
     MI_SchemaDecl const* m_pSchemaDecl;
     MI_FunctionTable::ConstPtr m_pFunctionTable;
     MI_ClassDecl::ConstPtr m_pOwningClassDecl;
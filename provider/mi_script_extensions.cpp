@@ -4,61 +4,149 @@
 
 
 #include "debug_tags.hpp"
-#include <algorithm>
-#include <string>
+#include "hash_table.hpp"
 
 
 namespace
 {
 
 
-template<typename T>
-class Finder
+// stops a probe of a schema_index table at an empty slot or at the slot of
+// name under pOwner
+class slot_probe
 {
 public:
-    /*ctor*/ Finder (MI_Char const* const pName)
-        : m_Name (pName) {}
+    /*ctor*/ slot_probe (
+        void const* const pOwner,
+        MI_Char const* const name)
+        : m_pOwner (pOwner)
+        , m_Name (name)
+    {
+        // empty
+    }
 
-    bool operator () (T const* pItem)
+    template<typename SLOT>
+    bool operator () (SLOT const& item) const
     {
-        return m_Name == pItem->name;
+        return NULL == item.name ||
+            (item.pOwner == m_pOwner &&
+             util::equal_names<util::folded_char> (item.name, m_Name));
     }
 
 private:
-    std::basic_string<MI_Char> const m_Name;
+    void const* const m_pOwner;
+    MI_Char const* const m_Name;
 };
 
 
 }
 
 
-MI_ClassDeclEx const*
-findClassDecl (
-    MI_Char const* const pClassName,
+/*ctor*/
+schema_index::schema_index ()
+    : m_pSchemaDecl (NULL)
+{
+    // empty
+}
+
+
+void
+schema_index::reset (
     MI_SchemaDecl const* const pSchemaDecl)
 {
-    SCX_BOOKEND ("mi_script_extensions.cpp findClassDecl");
-    MI_ClassDecl const* const* ppClassDecl =
-        std::find_if (
-            pSchemaDecl->classDecls,
-            pSchemaDecl->classDecls + pSchemaDecl->numClassDecls,
-            Finder<MI_ClassDecl> (pClassName));
-    return (ppClassDecl != (pSchemaDecl->classDecls + pSchemaDecl->numClassDecls))
-        ? static_cast<MI_ClassDeclEx const*>(*ppClassDecl) : NULL;
+    SCX_BOOKEND ("schema_index::reset");
+    m_pSchemaDecl = pSchemaDecl;
+    size_t nClasses = 0;
+    size_t nMethods = 0;
+    if (NULL != pSchemaDecl)
+    {
+        nClasses = pSchemaDecl->numClassDecls;
+        for (MI_Uint32 i = 0; i < pSchemaDecl->numClassDecls; ++i)
+        {
+            nMethods += pSchemaDecl->classDecls[i]->numMethods;
+        }
+    }
+    slot const empty = { NULL, NULL, NULL };
+    slot_table (util::hash_table_size (nClasses), empty).swap (m_Classes);
+    slot_table (util::hash_table_size (nMethods), empty).swap (m_Methods);
+    for (size_t i = 0; i < nClasses; ++i)
+    {
+        MI_ClassDecl const* const pClassDecl = pSchemaDecl->classDecls[i];
+        insert (&m_Classes, NULL, pClassDecl->name, pClassDecl);
+        for (MI_Uint32 j = 0; j < pClassDecl->numMethods; ++j)
+        {
+            MI_MethodDecl const* const pMethodDecl = pClassDecl->methods[j];
+            insert (&m_Methods, pClassDecl, pMethodDecl->name, pMethodDecl);
+        }
+    }
+}
+
+
+MI_ClassDeclEx const*
+schema_index::findClassDecl (
+    MI_Char const* const pClassName) const
+{
+    return static_cast<MI_ClassDeclEx const*>(
+        static_cast<MI_ClassDecl const*>(
+            find (m_Classes, NULL, pClassName)));
 }
 
 
 MI_MethodDecl const*
-findMethodDecl (
-    MI_Char const* const pMethodName,
-    MI_ClassDecl const* const pClassDecl)
+schema_index::findMethodDecl (
+    MI_ClassDecl const* const pClassDecl,
+    MI_Char const* const pMethodName) const
 {
-    SCX_BOOKEND ("mi_script_extensions.cpp findMethodDecl");
-    MI_MethodDecl const* const* ppMethodDecl =
-        std::find_if (
-            pClassDecl->methods,
-            pClassDecl->methods + pClassDecl->numMethods,
-            Finder<MI_MethodDecl> (pMethodName));
-    return (ppMethodDecl != (pClassDecl->methods + pClassDecl->numMethods))
-        ? *ppMethodDecl : NULL;
+    return static_cast<MI_MethodDecl const*>(
+        find (m_Methods, pClassDecl, pMethodName));
+}
+
+
+/*static*/ size_t
+schema_index::hash (
+    void const* const pOwner,
+    MI_Char const* const name)
+{
+    // the case folded name, seeded with the owner
+    return util::hash_name<util::folded_char> (
+        name, reinterpret_cast<size_t>(pOwner));
+}
+
+
+/*static*/ void
+schema_index::insert (
+    slot_table* const pTable,
+    void const* const pOwner,
+    MI_Char const* const name,
+    void const* const pDecl)
+{
+    if (NULL != name)
+    {
+        size_t const pos = util::hash_probe (
+            *pTable, hash (pOwner, name), slot_probe (pOwner, name));
+        // the first of any duplicate names wins, as it does for a linear
+        // search
+        if (NULL == (*pTable)[pos].name)
+        {
+            slot const item = { pOwner, name, pDecl };
+            (*pTable)[pos] = item;
+        }
+    }
+}
+
+
+/*static*/ void const*
+schema_index::find (
+    slot_table const& table,
+    void const* const pOwner,
+    MI_Char const* const name)
+{
+    void const* pDecl = NULL;
+    if (NULL != name &&
+        !table.empty ())
+    {
+        pDecl = table[util::hash_probe (
+            table, hash (pOwner, name), slot_probe (pOwner, name))].pDecl;
+    }
+    return pDecl;
 }
@@ -7,6 +7,10 @@
 #include <MI.h>
 
 
+#include <cstddef>
+#include <vector>
+
+
 #define EXPORT_PUBLIC __attribute__ ((visibility ("default")))
 
 
@@ -20,16 +24,70 @@ struct MI_ClassDeclEx : public MI_ClassDecl
 };
 
 
-EXPORT_PUBLIC MI_ClassDeclEx const*
-findClassDecl (
-    MI_Char const* const pClassName,
-    MI_SchemaDecl const* const pSchemaDecl);
+// class schema_index
+// purpose: A hash index over the class and method names of an MI_SchemaDecl.
+//          Names are compared without regard to case, as CIM names are.  The
+//          index is built once for a schema and lookups don't allocate.  The
+//          index does not own the schema, which has to outlive it.
+//------------------------------------------------------------------------------
+class EXPORT_PUBLIC schema_index
+{
+public:
+    /*ctor*/ schema_index ();
+
+    // rebuild the index for pSchemaDecl, which may be NULL
+    void reset (MI_SchemaDecl const* const pSchemaDecl);
+
+    MI_SchemaDecl const* getSchemaDecl () const;
+
+    MI_ClassDeclEx const* findClassDecl (
+        MI_Char const* const pClassName) const;
+
+    MI_MethodDecl const* findMethodDecl (
+        MI_ClassDecl const* const pClassDecl,
+        MI_Char const* const pMethodName) const;
+
+private:
+    // a slot is empty while its name is NULL; a method slot is owned by its
+    // class decl, a class slot has no owner
+    struct slot
+    {
+        void const* pOwner;
+        MI_Char const* name;
+        void const* pDecl;
+    };
 
+    typedef std::vector<slot> slot_table;
 
-EXPORT_PUBLIC MI_MethodDecl const*
-findMethodDecl (
-    MI_Char const* const pMethodName,
-    MI_ClassDecl const* const pClassDecl);
+    static size_t hash (
+        void const* const pOwner,
+        MI_Char const* const name);
+
+    static void insert (
+        slot_table* const pTable,
+        void const* const pOwner,
+        MI_Char const* const name,
+        void const* const pDecl);
+
+    static void const* find (
+        slot_table const& table,
+        void const* const pOwner,
+        MI_Char const* const name);
+
+    /*ctor*/ schema_index (schema_index const&); // = delete
+    schema_index& operator = (schema_index const&); // = delete
+
+    MI_SchemaDecl const* m_pSchemaDecl;
+    slot_table m_Classes;
+    slot_table m_Methods;
+};
+
+
+inline MI_SchemaDecl const*
+schema_index::getSchemaDecl () const
+{
+    return m_pSchemaDecl;
+}
 
 
 #undef EXPORT_PUBLIC
@@ -3,6 +3,10 @@
 #include "mi_value.hpp"
 
 
+#include "hash_table.hpp"
+#include <pthread.h>
+
+
 namespace
 {
 
@@ -24,6 +28,68 @@ struct KeyFinder
 };
 
 
+// the interned strings are an open addressed hash table, a power of 2 in
+// size and at most half full, guarded by g_StringLock
+typedef std::vector<scx::MI_Value<MI_STRING>::Ptr> string_slots_t;
+
+pthread_mutex_t g_StringLock = PTHREAD_MUTEX_INITIALIZER;
+string_slots_t g_StringSlots;
+size_t g_StringCount = 0;
+
+
+// stops a probe of the string slots at an empty slot or at the slot of str
+class string_probe
+{
+public:
+    /*ctor*/ string_probe (
+        MI_Char const* const str)
+        : m_Str (str)
+    {
+        // empty
+    }
+
+    bool operator () (scx::MI_Value<MI_STRING>::Ptr const& pItem) const
+    {
+        return !pItem ||
+            util::equal_names<util::exact_char> (
+                pItem->getValue ().c_str (), m_Str);
+    }
+
+private:
+    MI_Char const* const m_Str;
+};
+
+
+// the slot that holds str or the empty slot where it belongs
+size_t
+find_slot (
+    string_slots_t const& slots,
+    MI_Char const* const str)
+{
+    return util::hash_probe (
+        slots, util::hash_name<util::exact_char> (str), string_probe (str));
+}
+
+
+void
+grow_slots ()
+{
+    string_slots_t slots (g_StringSlots.empty () ?
+                          64 : 2 * g_StringSlots.size ());
+    for (string_slots_t::const_iterator pos = g_StringSlots.begin (),
+             endPos = g_StringSlots.end ();
+         pos != endPos;
+         ++pos)
+    {
+        if (*pos)
+        {
+            slots[find_slot (slots, (*pos)->getValue ().c_str ())] = *pos;
+        }
+    }
+    slots.swap (g_StringSlots);
+}
+
+
 }
 
 
@@ -187,6 +253,74 @@ MI_Value<MI_STRING>::recv (
 }
 
 
+/*static*/ MI_Value<MI_STRING>::Ptr
+string_table::intern (
+    MI_Char const* const str)
+{
+    MI_Char const* const text = str ? str : "";
+    MI_Value<MI_STRING>::Ptr pValue;
+    pthread_mutex_lock (&g_StringLock);
+    if (2 * (g_StringCount + 1) > g_StringSlots.size () &&
+        MAX_STRINGS > g_StringCount)
+    {
+        grow_slots ();
+    }
+    size_t const pos = find_slot (g_StringSlots, text);
+    if (g_StringSlots[pos])
+    {
+        pValue = g_StringSlots[pos];
+    }
+    else if (MAX_STRINGS > g_StringCount)
+    {
+        g_StringSlots[pos] = new MI_Value<MI_STRING> (text);
+        ++g_StringCount;
+        pValue = g_StringSlots[pos];
+    }
+    pthread_mutex_unlock (&g_StringLock);
+    if (!pValue)
+    {
+        // the table is full
+        pValue = new MI_Value<MI_STRING> (text);
+    }
+    return pValue;
+}
+
+
+/*static*/ MI_Value<MI_STRING>::Ptr
+string_table::intern (
+    MI_Value<MI_STRING>::type_t const& str)
+{
+    return intern (str.c_str ());
+}
+
+
+/*static*/ MI_Value<MI_STRING>::Ptr
+string_table::intern (
+    MI_Value<MI_STRING>::ConstPtr const& pStr)
+{
+    return pStr ? intern (pStr->getValue ().c_str ()) :
+        MI_Value<MI_STRING>::Ptr ();
+}
+
+
+/*static*/ int
+string_table::recv (
+    MI_Value<MI_STRING>::Ptr* const ppValueOut,
+    socket_wrapper& sock)
+{
+    //SCX_BOOKEND ("string_table::recv");
+    assert (ppValueOut);
+    MI_Char const* pText = NULL;
+    util::unique_ptr<MI_Char[]> holder;
+    int rval = protocol::recv_in_place (&pText, &holder, sock);
+    if (socket_wrapper::SUCCESS == rval)
+    {
+        *ppValueOut = intern (pText);
+    }
+    return rval;
+}
+
+
 /*ctor*/
 MI_Datetime::MI_Datetime ()
 {
@@ -233,13 +367,13 @@ MI_Datetime::recv (
         {
             MI_Timestamp::Ptr pTimestamp;
             rval = MI_Timestamp::recv (&pTimestamp, sock);
-            *ppValueOut = pTimestamp;
+            *ppValueOut = UTIL_MOVE (pTimestamp);
         }
         else
         {
             MI_Interval::Ptr pInterval;
             rval = MI_Interval::recv (&pInterval, sock);
-            *ppValueOut = pInterval;
+            *ppValueOut = UTIL_MOVE (pInterval);
         }
     }
     else
@@ -428,6 +562,53 @@ template<>
 int
 MI_Array<MI_BOOLEANA>::send (
     socket_wrapper& sock) const
+{
+    int rval = protocol::send_item_count (m_Array.size (), sock);
+    if (socket_wrapper::SUCCESS == rval &&
+        !m_Array.empty ())
+    {
+        std::vector<protocol::boolean_t> items (m_Array.size ());
+        for (size_t i = 0; i < m_Array.size (); ++i)
+        {
+            items[i] = m_Array[i] ? 1 : 0;
+        }
+        rval = protocol::send_items (&(items[0]), items.size (), sock);
+    }
+    return rval;
+}
+
+
+template<>
+/*static*/ int
+MI_Array<MI_BOOLEANA>::recv (
+    MI_Array<MI_BOOLEANA>::Ptr* ppArrayOut,
+    socket_wrapper& sock)
+{
+    SCX_BOOKEND ("MI_Array<MI_BOOLEANA>::recv");
+    assert (ppArrayOut);
+    protocol::item_count_t count;
+    int rval = protocol::recv_item_count (&count, sock);
+    if (socket_wrapper::SUCCESS == rval)
+    {
+        std::vector<protocol::boolean_t> items (count);
+        if (0 < count)
+        {
+            rval = protocol::recv_items (&(items[0]), count, sock);
+        }
+        if (socket_wrapper::SUCCESS == rval)
+        {
+            *ppArrayOut = new MI_Array<MI_BOOLEANA>;
+            (*ppArrayOut)->m_Array.assign (items.begin (), items.end ());
+        }
+    }
+    return rval;
+}
+
+
+template<>
+int
+MI_Array<MI_STRINGA>::send (
+    socket_wrapper& sock) const
 {
     int rval = protocol::send_item_count (m_Array.size (), sock);
     for (Array_t::const_iterator pos = m_Array.begin (),
@@ -436,7 +617,7 @@ MI_Array<MI_BOOLEANA>::send (
              pos != endPos;
          ++pos)
     {
-        rval = protocol::send_boolean (*pos, sock);
+        rval = protocol::send (*pos, sock);
     }
     return rval;
 }
@@ -444,17 +625,17 @@ MI_Array<MI_BOOLEANA>::send (
 
 template<>
 /*static*/ int
-MI_Array<MI_BOOLEANA>::recv (
-    MI_Array<MI_BOOLEANA>::Ptr* ppArrayOut,
+MI_Array<MI_STRINGA>::recv (
+    MI_Array<MI_STRINGA>::Ptr* ppArrayOut,
     socket_wrapper& sock)
 {
-    SCX_BOOKEND ("MI_Array<MI_BOOLEANA>::recv");
+    SCX_BOOKEND ("MI_Array<MI_STRINGA>::recv");
     assert (ppArrayOut);
     protocol::item_count_t count;
     int rval = protocol::recv_item_count (&count, sock);
     if (socket_wrapper::SUCCESS == rval)
     {
-        MI_Array<MI_BOOLEANA>::Array_t array;
+        MI_Array<MI_STRINGA>::Array_t array;
         array.reserve (count);
         for (protocol::item_count_t i = 0;
              socket_wrapper::SUCCESS == rval &&
@@ -470,7 +651,7 @@ MI_Array<MI_BOOLEANA>::recv (
         }
         if (socket_wrapper::SUCCESS == rval)
         {
-            *ppArrayOut = new MI_Array<MI_BOOLEANA>;
+            *ppArrayOut = new MI_Array<MI_STRINGA>;
             (*ppArrayOut)->m_Array.swap (array);
         }
     }
@@ -645,7 +826,7 @@ MI_Array<MI_DATETIMEA>::recv (
         rval = MI_Datetime::recv (&pValue, sock);
         if (socket_wrapper::SUCCESS == rval)
         {
-            array.push_back (pValue);
+            array.push_back (UTIL_MOVE (pValue));
         }
     }
     if (socket_wrapper::SUCCESS == rval)
@@ -741,17 +922,17 @@ MI_PropertySet::recv (
             {
                 MI_Value<MI_STRING>::Ptr pKey;
                 SCX_BOOKEND_PRINT ("read property");
-                rval = MI_Value<MI_STRING>::recv (&pKey, sock);
+                rval = string_table::recv (&pKey, sock);
                 if (socket_wrapper::SUCCESS == rval)
                 {
-                    properties.push_back (pKey);
+                    properties.push_back (UTIL_MOVE (pKey));
                 }
             }
             if (socket_wrapper::SUCCESS == rval)
             {
                 MI_PropertySet::Ptr pPropertySet (new MI_PropertySet);
                 pPropertySet->m_Keys.swap (properties);
-                *ppPropertySetOut = pPropertySet;
+                *ppPropertySetOut = UTIL_MOVE (pPropertySet);
             }
         }
         else
@@ -12,6 +12,7 @@
 #include "mi_type.hpp"
 #include "shared_protocol.hpp"
 #include "socket_wrapper.hpp"
+#include "value_pool.hpp"
 
 
 #include <string>
@@ -32,10 +33,14 @@ public:
     typedef util::internal_counted_ptr<MI_ValueBase> Ptr;
     typedef util::internal_counted_ptr<MI_ValueBase const> ConstPtr;
 
+    // s_count is only kept when PRINT_BOOKENDS is set, it isn't atomic and
+    // every value would otherwise write to it
     EXPORT_PUBLIC /*ctor*/ MI_ValueBase ()
     {
         //SCX_BOOKEND ("MI_ValueBase::ctor");
+#if (PRINT_BOOKENDS)
         ++s_count;
+#endif
         //std::ostringstream strm;
         //strm << "MI_ValueBase::s_count: " << s_count;
         //SCX_BOOKEND_PRINT (strm.str ().c_str ());
@@ -44,7 +49,9 @@ public:
     EXPORT_PUBLIC /*ctor*/ MI_ValueBase (MI_ValueBase const&)
     {
         //SCX_BOOKEND ("MI_ValueBase::ctor (copy)");
+#if (PRINT_BOOKENDS)
         ++s_count;
+#endif
         //std::ostringstream strm;
         //strm << "MI_ValueBase::s_count: " << s_count;
         //SCX_BOOKEND_PRINT (strm.str ().c_str ());
@@ -53,6 +60,7 @@ public:
     EXPORT_PUBLIC virtual /*dtor*/ ~MI_ValueBase ()
     {
         //SCX_BOOKEND ("MI_ValueBase::dtor");
+#if (PRINT_BOOKENDS)
         --s_count;
         if (0 == s_count)
         {
@@ -60,6 +68,7 @@ public:
             strm << "MI_ValueBase::s_count: " << s_count;
             SCX_BOOKEND_PRINT (strm.str ().c_str ());
         }
+#endif
     }
 
     EXPORT_PUBLIC virtual TypeID_t getType () const = 0;
@@ -99,6 +108,10 @@ public:
 
     static int recv (Ptr* ppValueOut, socket_wrapper& sock);
 
+    // scalar values come from value_pool
+    static void* operator new (size_t size);
+    static void operator delete (void* pValue, size_t size);
+
 private:
     type_t m_Value;
 };
@@ -153,6 +166,41 @@ private:
 };
 
 
+// class string_table
+// purpose: The process wide table of interned names (name spaces, classes,
+//          methods and properties).  Every lookup of a name that is in the
+//          table returns the same shared MI_Value, so one doesn't have to be
+//          allocated for each request.  The schema declarations adopt the
+//          interned values for their names, so a received name can be
+//          matched to a declaration by pointer.  An interned value is shared
+//          and must not be changed in place.
+//------------------------------------------------------------------------------
+class EXPORT_PUBLIC string_table
+{
+public:
+    // the most strings the table will hold, a name beyond that is returned
+    // in a new MI_Value
+    static size_t const MAX_STRINGS = 4096;
+
+    EXPORT_PUBLIC static MI_Value<MI_STRING>::Ptr intern (
+        MI_Char const* const str);
+    EXPORT_PUBLIC static MI_Value<MI_STRING>::Ptr intern (
+        MI_Value<MI_STRING>::type_t const& str);
+    // the interned value with the same text as pStr, which the caller
+    // adopts in place of pStr; NULL for NULL
+    EXPORT_PUBLIC static MI_Value<MI_STRING>::Ptr intern (
+        MI_Value<MI_STRING>::ConstPtr const& pStr);
+
+    // recv a string the same as MI_Value<MI_STRING>::recv and intern it
+    EXPORT_PUBLIC static int recv (
+        MI_Value<MI_STRING>::Ptr* const ppValueOut,
+        socket_wrapper& sock);
+
+private:
+    /*ctor*/ string_table (); // = delete
+};
+
+
 // class MI_Datetime
 //------------------------------------------------------------------------------
 class EXPORT_PUBLIC MI_Datetime : public MI_ValueBase
@@ -173,6 +221,10 @@ public:
     virtual int send (socket_wrapper& sock) const;
 
     static int recv (Ptr* ppValueOut, socket_wrapper& sock);
+
+    // timestamps and intervals come from value_pool
+    static void* operator new (size_t size);
+    static void operator delete (void* pValue, size_t size);
 };
 
 
@@ -312,6 +364,11 @@ public:
     EXPORT_PUBLIC void insert (size_t index, Value_t const& value);
     EXPORT_PUBLIC void erase (size_t index);
 
+    // the items are contiguous, getData is NULL when the array is empty
+    EXPORT_PUBLIC Value_t* getData ();
+    // replace the items with a copy of [pBegin, pEnd)
+    EXPORT_PUBLIC void assign (Value_t const* pBegin, Value_t const* pEnd);
+
     int send (socket_wrapper& sock) const;
 
     static int recv (Ptr* ppValueOut, socket_wrapper& sock);
@@ -323,14 +380,27 @@ private:
 
 template<>
 int
-MI_Array<MI_BOOLEAN>::send (
+MI_Array<MI_BOOLEANA>::send (
+    socket_wrapper& sock) const;
+
+
+template<>
+/*static*/ int
+MI_Array<MI_BOOLEANA>::recv (
+    MI_Array<MI_BOOLEANA>::Ptr* ppValueOut,
+    socket_wrapper& sock);
+
+
+template<>
+int
+MI_Array<MI_STRINGA>::send (
     socket_wrapper& sock) const;
 
 
 template<>
 /*static*/ int
-MI_Array<MI_BOOLEAN>::recv (
-    MI_Array<MI_BOOLEAN>::Ptr* ppValueOut,
+MI_Array<MI_STRINGA>::recv (
+    MI_Array<MI_STRINGA>::Ptr* ppValueOut,
     socket_wrapper& sock);
 
 
@@ -530,6 +600,44 @@ MI_Value<TYPE_ID>::recv (
 }
 
 
+template<TypeID_t TYPE_ID>
+/*static*/ inline void*
+MI_Value<TYPE_ID>::operator new (
+    size_t size)
+{
+    return value_pool::allocate (size);
+}
+
+
+template<TypeID_t TYPE_ID>
+/*static*/ inline void
+MI_Value<TYPE_ID>::operator delete (
+    void* pValue,
+    size_t size)
+{
+    value_pool::deallocate (pValue, size);
+}
+
+
+// class MI_Datetime definitions
+//------------------------------------------------------------------------------
+/*static*/ inline void*
+MI_Datetime::operator new (
+    size_t size)
+{
+    return value_pool::allocate (size);
+}
+
+
+/*static*/ inline void
+MI_Datetime::operator delete (
+    void* pValue,
+    size_t size)
+{
+    value_pool::deallocate (pValue, size);
+}
+
+
 // class MI_Timestamp definitions
 //------------------------------------------------------------------------------
 inline MI_Uint32 const&
@@ -832,19 +940,35 @@ MI_Array<TYPE_ID>::erase (
 }
 
 
+template<TypeID_t TYPE_ID>
+typename MI_Array<TYPE_ID>::Value_t*
+MI_Array<TYPE_ID>::getData ()
+{
+    return m_Array.empty () ? NULL : &(m_Array[0]);
+}
+
+
+template<TypeID_t TYPE_ID>
+void
+MI_Array<TYPE_ID>::assign (
+    typename MI_Array<TYPE_ID>::Value_t const* pBegin,
+    typename MI_Array<TYPE_ID>::Value_t const* pEnd)
+{
+    m_Array.assign (pBegin, pEnd);
+}
+
+
 template<TypeID_t TYPE_ID>
 int
 MI_Array<TYPE_ID>::send (
     socket_wrapper& sock) const
 {
+    // the items are fixed size, so they are sent as one block
     int rval = protocol::send_item_count (m_Array.size (), sock);
-    for (typename Array_t::const_iterator pos = m_Array.begin (),
-             endPos = m_Array.end ();
-         socket_wrapper::SUCCESS == rval &&
-             pos != endPos;
-         ++pos)
+    if (socket_wrapper::SUCCESS == rval &&
+        !m_Array.empty ())
     {
-        rval = protocol::send (*pos, sock);
+        rval = protocol::send_items (&(m_Array[0]), m_Array.size (), sock);
     }
     return rval;
 }
@@ -865,20 +989,10 @@ MI_Array<TYPE_ID>::recv (
         //std::ostringstream strm;
         //strm << "count: " << count;
         //SCX_BOOKEND_PRINT (strm.str ().c_str ());
-        Array_t array;
-        array.reserve (count);
-        for (protocol::item_count_t i = 0;
-             socket_wrapper::SUCCESS == rval &&
-                 i < count;
-             ++i)
+        Array_t array (count);
+        if (0 < count)
         {
-            Value_t value;
-            rval = protocol::recv (&value, sock);
-            if (socket_wrapper::SUCCESS == rval)
-            {
-                //SCX_BOOKEND_PRINT ("--- add value");
-                array.push_back (value);
-            }
+            rval = protocol::recv_items (&(array[0]), count, sock);
         }
         if (socket_wrapper::SUCCESS == rval)
         {
@@ -6,6 +6,7 @@
 #include "debug_tags.hpp"
 #include "mi_module_self.hpp"
 #include "mi_script_extensions.hpp"
+#include "server_pool.hpp"
 #include "server_protocol.hpp"
 #include "repeat.hpp"
 #include "unique_ptr.hpp"
@@ -29,216 +30,29 @@
 extern util::unique_ptr<Server> g_pServer;
 
 
-namespace
-{
-
-
-typedef util::unique_ptr<char[]> char_array;
-
-
-template<typename CHAR_t>
-inline int
-compare_case_insensitive (
-    CHAR_t const* pLHS,
-    CHAR_t const* pRHS)
-{
-    for (; *pLHS || *pRHS; ++pLHS, ++pRHS)
-    {
-        CHAR_t l = tolower (*pLHS);
-        CHAR_t r = tolower (*pRHS);
-        if (l != r)
-        {
-            return l < r ? -1 : 1;
-        }
-    }
-    return 0;
-}
-
-
-class ClassFinder
-{
-public:
-    /*ctor*/ ClassFinder (MI_Char const* const name)
-        : m_Name (name) {}
-
-    bool operator () (MI_ClassDecl const* pClass)
-    {
-//#if (PRINT_BOOKENDS)
-//        SCX_BOOKEND ("ClassFinder::operator ()");
-//        std::ostringstream strm;
-//        strm << "m_Name: \"" << m_Name << '\"';
-//        SCX_BOOKEND_PRINT (strm.str ());
-//        strm.str ("");
-//        strm.clear ();
-//        strm << "pClass->name: \"" << pClass->name << '\"';
-//        SCX_BOOKEND_PRINT (strm.str ());
-//#endif
-        return 0 == compare_case_insensitive (m_Name.c_str (), pClass->name);
-    }
-
-private:
-    std::string const m_Name;
-};
-
-
-class MethodFinder
-{
-public:
-    /*ctor*/ MethodFinder (MI_Char const* const name)
-        : m_Name (name) {}
-
-    bool operator () (MI_MethodDecl const* pMethod)
-    {
-#if (PRINT_BOOKENDS)
-        SCX_BOOKEND ("MethodFinder::operator ()");
-        std::ostringstream strm;
-        strm << "m_Name: \"" << m_Name << '\"';
-        SCX_BOOKEND_PRINT (strm.str ());
-        strm.str ("");
-        strm.clear ();
-        strm << "pMethod->name: \"" << pMethod->name << '\"';
-        SCX_BOOKEND_PRINT (strm.str ());
-        strm.str ("");
-        strm.clear ();
-        strm << (m_Name == pMethod->name ? "Equal" : "Not Equal");
-        SCX_BOOKEND_PRINT (strm.str ());
+// Connect to the client through an AF_UNIX socketpair created before the
+// fork instead of a loopback TCP listener and key handshake.
+#if (1)
+#define USE_SOCKETPAIR (1)
+#else
+#define USE_SOCKETPAIR (0)
 #endif
-        return m_Name == pMethod->name;
-    }
-
-private:
-    std::string const m_Name;
-};
-
-
-MI_MethodDecl const*
-findMethodDecl (
-    MI_ClassDeclEx const* const pClassDecl,
-    MI_Char const* const methodName)
-{
-    SCX_BOOKEND ("findMethodDecl");
-    MI_MethodDecl const* const* ppMethodDecl =
-        std::find_if (
-            pClassDecl->methods,
-            pClassDecl->methods + pClassDecl->numMethods,
-            MethodFinder (methodName));
-    return ppMethodDecl != (pClassDecl->methods + pClassDecl->numMethods) ?
-        *ppMethodDecl : NULL;
-}
 
 
-int
-handle_post_instance (
-    MI_Context* const pContext,
-    MI_SchemaDecl const* const pSchema,
-    MI_Filter const* const pFilter,
-    socket_wrapper& sock)
-{
-    SCX_BOOKEND ("handle_post_instance");
-    int rval = socket_wrapper::SUCCESS;
-    MI_Instance* pInstance = NULL;
-    if (socket_wrapper::SUCCESS == (
-            rval = (protocol::recv (&pInstance, pContext, pSchema, sock))))
-    {
-        //SCX_BOOKEND_PRINT ("recv instance succeeded");
-        MI_Boolean post = MI_TRUE;
-        if (NULL != pFilter)
-        {
-            if (MI_RESULT_OK == MI_Filter_Evaluate (pFilter, pInstance, &post))
-            {
-                if (MI_FALSE == post)
-                {
-                    //SCX_BOOKEND_PRINT ("Filtered out");
-                }
-            }
-            else
-            {
-                //SCX_BOOKEND_PRINT ("MI_Filter_Evaluate failed");
-                post = MI_FALSE;
-            }
-        }
-        if (MI_FALSE != post)
-        {
-            if (MI_RESULT_OK == MI_Context_PostInstance (pContext, pInstance))
-            {
-                //SCX_BOOKEND_PRINT ("PostInstance succeeded");
-            }
-            else
-            {
-                //SCX_BOOKEND_PRINT ("PostInstance failed");
-            }
-        }
-        MI_Instance_Delete (pInstance);
-    }
-    else
-    {
-        //SCX_BOOKEND_PRINT ("something went wrong");
-    }
-    return rval;
-}
+// Send POST_INSTANCE traffic from the client through a shared memory ring
+// instead of the socket (requires USE_SOCKETPAIR).
+#if (1)
+#define USE_SHARED_RING (USE_SOCKETPAIR)
+#else
+#define USE_SHARED_RING (0)
+#endif
 
 
-int
-handle_post_result (
-    MI_Context* const pContext,
-    socket_wrapper& sock)
+namespace
 {
-    SCX_BOOKEND ("handle_post_result");
-    MI_Result result;
-    int rval = protocol::recv (&result, sock);
-    if (socket_wrapper::SUCCESS == rval)
-    {
-        SCX_BOOKEND_PRINT ("rec'd result");
-        MI_Context_PostResult (pContext, result);
-    }
-    else
-    {
-        SCX_BOOKEND_PRINT ("recv result failed");
-    }
-    return rval;
-}
 
 
-int
-handle_return (
-    MI_Context* const pContext,
-    MI_SchemaDecl const* const pSchema,
-    MI_Filter const* const pFilter,
-    socket_wrapper& sock)
-{
-    SCX_BOOKEND ("handle_return");
-    int rval = socket_wrapper::SUCCESS;
-    protocol::opcode_t opcode;
-    do
-    {
-        rval = protocol::recv_opcode (&opcode, sock);
-        if (socket_wrapper::SUCCESS == rval)
-        {
-            switch (opcode)
-            {
-            case protocol::POST_INSTANCE:
-                SCX_BOOKEND_PRINT ("rec'ved POST_INSTANCE");
-                rval = handle_post_instance (pContext, pSchema, pFilter, sock);
-                break;
-            case protocol::POST_RESULT:
-                SCX_BOOKEND_PRINT ("rec'ved POST_RESULT");
-                rval = handle_post_result (pContext, sock);
-                break;
-            default:
-                SCX_BOOKEND_PRINT ("unexpected opcode");
-                // todo: error
-                break;
-            }
-        }
-        else
-        {
-            SCX_BOOKEND_PRINT ("error receiving opcode");
-            // todo: error
-        }
-    } while (socket_wrapper::SUCCESS == rval &&
-             protocol::POST_RESULT != opcode);
-    return rval;
-}
+typedef util::unique_ptr<char[]> char_array;
 
 
 void
@@ -611,7 +425,7 @@ MI_CALL Load##I ( \
     MI_Module_Self* pSelfModule, \
     MI_Context* pContext) \
 { \
-    pSelfModule->pServer->Load (I, ppSelf, pSelfModule, pContext); \
+    pSelfModule->pPool->Load (I, ppSelf, pSelfModule, pContext); \
 }
 
 #define LOAD_DECL(I) Load##I,
@@ -629,7 +443,7 @@ MI_CALL Unload##I ( \
     void* pSelf, \
     MI_Context* pContext) \
 { \
-    reinterpret_cast<MI_Module_Self*>(pSelf)->pServer->Unload ( \
+    reinterpret_cast<MI_Module_Self*>(pSelf)->pPool->Unload ( \
         I, pSelf, pContext); \
 }
 
@@ -651,9 +465,18 @@ Server::Server (
     , m_Startup (startup)
     , m_ModuleName (moduleName)
     , m_pSocket ()
+    , m_pRing ()
     , m_pSchemaDecl ()
+    , m_Index ()
+    , m_NextRequestID (0)
+    , m_Reading (false)
+    , m_pDispatching (NULL)
+    , m_Lost (false)
 {
     SCX_BOOKEND ("Server::ctor");
+    pthread_mutex_init (&m_SendLock, NULL);
+    pthread_mutex_init (&m_Lock, NULL);
+    pthread_cond_init (&m_Changed, NULL);
 }
 
 
@@ -661,6 +484,9 @@ Server::Server (
 Server::~Server ()
 {
     SCX_BOOKEND ("Server::dtor");
+    pthread_cond_destroy (&m_Changed);
+    pthread_mutex_destroy (&m_Lock);
+    pthread_mutex_destroy (&m_SendLock);
 }
 
 
@@ -676,6 +502,30 @@ Server::open ()
 }
 
 
+void
+Server::disconnect ()
+{
+    SCX_BOOKEND ("Server::disconnect");
+    pthread_mutex_lock (&m_SendLock);
+    pthread_mutex_lock (&m_Lock);
+    m_pSocket.reset ();
+    m_pRing.reset ();
+    m_Lost = false;
+    pthread_mutex_unlock (&m_Lock);
+    pthread_mutex_unlock (&m_SendLock);
+}
+
+
+bool
+Server::isConnected ()
+{
+    pthread_mutex_lock (&m_Lock);
+    bool const connected = m_pSocket && !m_Lost;
+    pthread_mutex_unlock (&m_Lock);
+    return connected;
+}
+
+
 void
 Server::setSchema (
     MI_SchemaDecl const* const pSchema)
@@ -697,6 +547,7 @@ Server::setSchema (
         }
     }
     m_pSchemaDecl.reset (pSchema);
+    m_Index.reset (pSchema);
 }
 
 
@@ -705,51 +556,28 @@ Server::findClassDecl (
     MI_Char const* const className)
 {
     //SCX_BOOKEND ("Server::findClassDecl");
-    MI_ClassDecl const* const* ppClassDecl =
-        std::find_if (
-            m_pSchemaDecl->classDecls,
-            m_pSchemaDecl->classDecls + m_pSchemaDecl->numClassDecls,
-            ClassFinder (className));
-    return (ppClassDecl != (
-        m_pSchemaDecl->classDecls + m_pSchemaDecl->numClassDecls) ?
-        static_cast<MI_ClassDeclEx const*>(*ppClassDecl) : NULL);
+    return m_Index.findClassDecl (className);
 }
 
 
 void
 Server::Module_Load (
     MI_Module_Self** ppSelf,
-    struct _MI_Context* pContext)
+    struct _MI_Context* pContext,
+    MI_Result* const pResult)
 {
     SCX_BOOKEND ("Server::Module_Load");
-    int rval = protocol::send_opcode (protocol::MODULE_LOAD, *m_pSocket);
-    if (socket_wrapper::SUCCESS == rval)
+    pending_request request (pContext, NULL, pResult);
+    int rval = begin_request (&request);
+    if (SUCCESS == rval)
     {
-        protocol::opcode_t opcode;
-        rval = protocol::recv_opcode (&opcode, *m_pSocket);
-        if (socket_wrapper::SUCCESS == rval)
-        {
-            if (protocol::POST_RESULT == opcode)
-            {
-                SCX_BOOKEND_PRINT ("rec'ved POST_RESULT");
-                rval = handle_post_result (pContext, *m_pSocket);
-            }
-            else
-            {
-                SCX_BOOKEND_PRINT ("rec'd unhandled opcode");
-                // todo: error
-            }
-        }
-        else
-        {
-            SCX_BOOKEND_PRINT ("socket error");
-            // socket error
-            // todo: error
-        }
+        rval = protocol::send_opcode (
+            protocol::MODULE_LOAD, request.id, *m_pSocket);
     }
+    rval = end_request (&request, rval);
     if (socket_wrapper::SUCCESS != rval)
     {
-        MI_Context_PostResult (pContext, MI_RESULT_FAILED);
+        post_result (request, MI_RESULT_FAILED);
     }
 }
 
@@ -757,37 +585,21 @@ Server::Module_Load (
 void
 Server::Module_Unload (
     MI_Module_Self* pSelf,
-    struct _MI_Context* pContext)
+    struct _MI_Context* pContext,
+    MI_Result* const pResult)
 {
     SCX_BOOKEND ("Server::Module_Unload");
-    int rval = protocol::send_opcode (protocol::MODULE_UNLOAD, *m_pSocket);
-    if (socket_wrapper::SUCCESS == rval)
+    pending_request request (pContext, NULL, pResult);
+    int rval = begin_request (&request);
+    if (SUCCESS == rval)
     {
-        protocol::opcode_t opcode;
-        rval = protocol::recv_opcode (&opcode, *m_pSocket);
-        if (socket_wrapper::SUCCESS == rval)
-        {
-            if (protocol::POST_RESULT == opcode)
-            {
-                SCX_BOOKEND_PRINT ("rec'ved POST_RESULT");
-                rval = handle_post_result (pContext, *m_pSocket);
-            }
-            else
-            {
-                SCX_BOOKEND_PRINT ("rec'd unhandled opcode");
-                // todo: error
-            }
-        }
-        else
-        {
-            SCX_BOOKEND_PRINT ("socket error");
-            // socket error
-            // todo: error
-        }
+        rval = protocol::send_opcode (
+            protocol::MODULE_UNLOAD, request.id, *m_pSocket);
     }
+    rval = end_request (&request, rval);
     if (socket_wrapper::SUCCESS != rval)
     {
-        MI_Context_PostResult (pContext, MI_RESULT_FAILED);
+        post_result (request, MI_RESULT_FAILED);
     }
 }
 
@@ -797,7 +609,8 @@ Server::Load (
     size_t const& index,
     void** ppSelf,
     MI_Module_Self* pSelfModule,
-    MI_Context* pContext)
+    MI_Context* pContext,
+    MI_Result* const pResult)
 {
     SCX_BOOKEND ("Server::Load (index)");
 #if (PRINT_BOOKENDS)
@@ -810,37 +623,21 @@ Server::Load (
     SCX_BOOKEND_PRINT (strm.str ());
 #endif
     *ppSelf = pSelfModule;
+    pending_request request (pContext, NULL, pResult);
     int rval = SUCCESS;
-    if (socket_wrapper::SUCCESS == (
-            rval = protocol::send_opcode (protocol::CLASS_LOAD, *m_pSocket)) &&
+    if (SUCCESS == (rval = begin_request (&request)) &&
+        socket_wrapper::SUCCESS == (
+            rval = protocol::send_opcode (
+                protocol::CLASS_LOAD, request.id, *m_pSocket)) &&
         socket_wrapper::SUCCESS == (
             rval = protocol::send (m_ClassNames[index], *m_pSocket)))
     {
-        protocol::opcode_t opcode;
-        rval = protocol::recv_opcode (&opcode, *m_pSocket);
-        if (socket_wrapper::SUCCESS == rval)
-        {
-            if (protocol::POST_RESULT == opcode)
-            {
-                SCX_BOOKEND_PRINT ("rec'ved POST_RESULT");
-                rval = handle_post_result (pContext, *m_pSocket);
-            }
-            else
-            {
-                SCX_BOOKEND_PRINT ("rec'd unhandled opcode");
-                // todo: error
-            }
-        }
-        else
-        {
-            SCX_BOOKEND_PRINT ("socket error");
-            // socket error
-            // todo: error
-        }
+        SCX_BOOKEND_PRINT ("request sent");
     }
+    rval = end_request (&request, rval);
     if (SUCCESS != rval)
     {
-        MI_Context_PostResult (pContext, MI_RESULT_FAILED);
+        post_result (request, MI_RESULT_FAILED);
     }
 }
 
@@ -849,7 +646,8 @@ void
 Server::Unload (
     size_t const& index,
     void* pSelf,
-    MI_Context* pContext)
+    MI_Context* pContext,
+    MI_Result* const pResult)
 {
     SCX_BOOKEND ("Server::Unload (index)");
 #if (PRINT_BOOKENDS)
@@ -861,37 +659,21 @@ Server::Unload (
     strm << "class: " << m_ClassNames[index];
     SCX_BOOKEND_PRINT (strm.str ());
 #endif
+    pending_request request (pContext, NULL, pResult);
     int rval = SUCCESS;
-    if (socket_wrapper::SUCCESS == (
-            rval = protocol::send_opcode (protocol::CLASS_UNLOAD, *m_pSocket)) &&
+    if (SUCCESS == (rval = begin_request (&request)) &&
+        socket_wrapper::SUCCESS == (
+            rval = protocol::send_opcode (
+                protocol::CLASS_UNLOAD, request.id, *m_pSocket)) &&
         socket_wrapper::SUCCESS == (
             rval = protocol::send (m_ClassNames[index], *m_pSocket)))
     {
-        protocol::opcode_t opcode;
-        rval = protocol::recv_opcode (&opcode, *m_pSocket);
-        if (socket_wrapper::SUCCESS == rval)
-        {
-            if (protocol::POST_RESULT == opcode)
-            {
-                SCX_BOOKEND_PRINT ("rec'ved POST_RESULT");
-                rval = handle_post_result (pContext, *m_pSocket);
-            }
-            else
-            {
-                SCX_BOOKEND_PRINT ("rec'd unhandled opcode");
-                // todo: error
-            }
-        }
-        else
-        {
-            SCX_BOOKEND_PRINT ("socket error");
-            // socket error
-            // todo: error
-        }
+        SCX_BOOKEND_PRINT ("request sent");
     }
+    rval = end_request (&request, rval);
     if (SUCCESS != rval)
     {
-        MI_Context_PostResult (pContext, MI_RESULT_FAILED);
+        post_result (request, MI_RESULT_FAILED);
     }
 }
 
@@ -924,10 +706,12 @@ Server::EnumerateInstances (
 #endif
     if (NULL != pClassDecl)
     {
-        if (SUCCESS == open () &&
+        pending_request request (pContext, pFilter);
+        if (SUCCESS == (rval = begin_request (&request)) &&
             socket_wrapper::SUCCESS == (
                 rval = protocol::send_opcode (
-                    protocol::ENUMERATE_INSTANCES, *m_pSocket)) &&
+                    protocol::ENUMERATE_INSTANCES, request.id,
+                    *m_pSocket)) &&
             socket_wrapper::SUCCESS == (
                 rval = protocol::send (nameSpace, *m_pSocket)) &&
             socket_wrapper::SUCCESS == (
@@ -937,9 +721,9 @@ Server::EnumerateInstances (
             socket_wrapper::SUCCESS == (
                 rval = protocol::send_boolean (keysOnly, *m_pSocket)))
         {
-            rval = handle_return (pContext, m_pSchemaDecl.get (), pFilter,
-                                  *m_pSocket);
+            SCX_BOOKEND_PRINT ("request sent");
         }
+        rval = end_request (&request, rval);
         if (SUCCESS != rval)
         {
             SCX_BOOKEND_PRINT ("send FAILED somewhere");
@@ -982,9 +766,11 @@ Server::GetInstance (
         NULL != pClassDecl)
     {
         // skipping: nameSpace, pPropertySet
-        if (socket_wrapper::SUCCESS == (
+        pending_request request (pContext);
+        if (SUCCESS == (rval = begin_request (&request)) &&
+            socket_wrapper::SUCCESS == (
                 rval = protocol::send_opcode (
-                    protocol::GET_INSTANCE, *m_pSocket)) &&
+                    protocol::GET_INSTANCE, request.id, *m_pSocket)) &&
             socket_wrapper::SUCCESS == (
                 rval = protocol::send (nameSpace, *m_pSocket)) &&
             socket_wrapper::SUCCESS == (
@@ -994,9 +780,9 @@ Server::GetInstance (
             socket_wrapper::SUCCESS == (
                 rval = protocol::send (pPropertySet, *m_pSocket)))
         {
-            rval = handle_return (pContext, m_pSchemaDecl.get (), NULL,
-                                  *m_pSocket);
+            SCX_BOOKEND_PRINT ("request sent");
         }
+        rval = end_request (&request, rval);
         if (SUCCESS != rval)
         {
             MI_Context_PostResult (pContext, MI_RESULT_FAILED);
@@ -1037,9 +823,11 @@ Server::CreateInstance (
         NULL != pClassDecl)
     {
         // skipping: nameSpace
-        if (socket_wrapper::SUCCESS == (
+        pending_request request (pContext);
+        if (SUCCESS == (rval = begin_request (&request)) &&
+            socket_wrapper::SUCCESS == (
                 rval = protocol::send_opcode (
-                    protocol::CREATE_INSTANCE, *m_pSocket)) &&
+                    protocol::CREATE_INSTANCE, request.id, *m_pSocket)) &&
             socket_wrapper::SUCCESS == (
                 rval = protocol::send (nameSpace, *m_pSocket)) &&
             socket_wrapper::SUCCESS == (
@@ -1047,14 +835,9 @@ Server::CreateInstance (
             socket_wrapper::SUCCESS == (
                 rval = protocol::send (*pNewInstance, *m_pSocket)))
         {
-            SCX_BOOKEND ("send succeeded");
-            rval = handle_return (pContext, m_pSchemaDecl.get (), NULL,
-                                  *m_pSocket);
-            if (SUCCESS != rval)
-            {
-                MI_Context_PostResult (pContext, MI_RESULT_FAILED);
-            }
+            SCX_BOOKEND_PRINT ("send succeeded");
         }
+        rval = end_request (&request, rval);
         if (SUCCESS != rval)
         {
             MI_Context_PostResult (pContext, MI_RESULT_FAILED);
@@ -1096,9 +879,11 @@ Server::ModifyInstance (
         NULL != pClassDecl)
     {
         // skipping: nameSpace, pPropertySet
-        if (socket_wrapper::SUCCESS == (
+        pending_request request (pContext);
+        if (SUCCESS == (rval = begin_request (&request)) &&
+            socket_wrapper::SUCCESS == (
                 rval = protocol::send_opcode (
-                    protocol::MODIFY_INSTANCE, *m_pSocket)) &&
+                    protocol::MODIFY_INSTANCE, request.id, *m_pSocket)) &&
             socket_wrapper::SUCCESS == (
                 rval = protocol::send (nameSpace, *m_pSocket)) &&
             socket_wrapper::SUCCESS == (
@@ -1108,28 +893,9 @@ Server::ModifyInstance (
             socket_wrapper::SUCCESS == (
                 rval = protocol::send (pPropertySet, *m_pSocket)))
         {
-            protocol::opcode_t opcode;
-            rval = protocol::recv_opcode (&opcode, *m_pSocket);
-            if (socket_wrapper::SUCCESS == rval)
-            {
-                if (protocol::POST_RESULT == opcode)
-                {
-                    SCX_BOOKEND_PRINT ("rec'ved POST_RESULT");
-                    rval = handle_post_result (pContext, *m_pSocket);
-                }
-                else
-                {
-                    SCX_BOOKEND_PRINT ("rec'd unhandled opcode");
-                    // todo: error
-                }
-            }
-            else
-            {
-                SCX_BOOKEND_PRINT ("socket error");
-                // socket error
-                // todo: error
-            }
+            SCX_BOOKEND_PRINT ("request sent");
         }
+        rval = end_request (&request, rval);
         if (SUCCESS != rval)
         {
             MI_Context_PostResult (pContext, MI_RESULT_FAILED);
@@ -1170,9 +936,11 @@ Server::DeleteInstance (
         NULL != pClassDecl)
     {
         // skipping: nameSpace
-        if (socket_wrapper::SUCCESS == (
+        pending_request request (pContext);
+        if (SUCCESS == (rval = begin_request (&request)) &&
+            socket_wrapper::SUCCESS == (
                 rval = protocol::send_opcode (
-                    protocol::DELETE_INSTANCE, *m_pSocket)) &&
+                    protocol::DELETE_INSTANCE, request.id, *m_pSocket)) &&
             socket_wrapper::SUCCESS == (
                 rval = protocol::send (nameSpace, *m_pSocket)) &&
             socket_wrapper::SUCCESS == (
@@ -1180,28 +948,9 @@ Server::DeleteInstance (
             socket_wrapper::SUCCESS == (
                 rval = protocol::send (*pInstanceName, *m_pSocket)))
         {
-            protocol::opcode_t opcode;
-            rval = protocol::recv_opcode (&opcode, *m_pSocket);
-            if (socket_wrapper::SUCCESS == rval)
-            {
-                if (protocol::POST_RESULT == opcode)
-                {
-                    SCX_BOOKEND_PRINT ("rec'ved POST_RESULT");
-                    rval = handle_post_result (pContext, *m_pSocket);
-                }
-                else
-                {
-                    SCX_BOOKEND_PRINT ("rec'd unhandled opcode");
-                    // todo: error
-                }
-            }
-            else
-            {
-                SCX_BOOKEND_PRINT ("socket error");
-                // socket error
-                // todo: error
-            }
+            SCX_BOOKEND_PRINT ("request sent");
         }
+        rval = end_request (&request, rval);
         if (SUCCESS != rval)
         {
             MI_Context_PostResult (pContext, MI_RESULT_FAILED);
@@ -1243,16 +992,20 @@ Server::Invoke (
     if (NULL != pClassDecl)
     {
         MI_MethodDecl const* pMethodDecl =
-            findMethodDecl (pClassDecl, methodName);
+            m_Index.findMethodDecl (pClassDecl, methodName);
         if (NULL != pMethodDecl)
         {
             SCX_BOOKEND_PRINT ("class and method where found");
             MI_Uint32 flags =
                 (pInstance ? protocol::HAS_INSTANCE_FLAG : 0) |
                 (pInputParameters ? protocol::HAS_INPUT_PARAMETERS_FLAG : 0);
+            pending_request request (pContext);
+            rval = begin_request (&request);
+            if (socket_wrapper::SUCCESS == rval)
             {
                 SCX_BOOKEND ("send opcode");
-                rval = protocol::send_opcode (protocol::INVOKE, *m_pSocket);
+                rval = protocol::send_opcode (
+                    protocol::INVOKE, request.id, *m_pSocket);
             }
             if (socket_wrapper::SUCCESS == rval)
             {
@@ -1267,7 +1020,9 @@ Server::Invoke (
             if (socket_wrapper::SUCCESS == rval)
             {
                 SCX_BOOKEND ("send method name");
-                rval = protocol::send (methodName, *m_pSocket);
+                // the name the schema declares, the method was matched
+                // without regard to case
+                rval = protocol::send (pMethodDecl->name, *m_pSocket);
             }
             if (socket_wrapper::SUCCESS == rval)
             {
@@ -1302,10 +1057,7 @@ Server::Invoke (
             }
             if (socket_wrapper::SUCCESS == rval)
             {
-                {
-                    rval = handle_return (pContext, m_pSchemaDecl.get (), NULL,
-                                          *m_pSocket);
-                }
+                rval = end_request (&request, rval);
                 if (SUCCESS != rval)
                 {
                     MI_Context_PostResult (pContext, MI_RESULT_FAILED);
@@ -1314,6 +1066,7 @@ Server::Invoke (
             else
             {
                 SCX_BOOKEND_PRINT ("something failed");
+                end_request (&request, rval);
                 MI_Context_PostResult (pContext, MI_RESULT_FAILED);
             }
         }
@@ -1345,7 +1098,7 @@ MI_CALL EnumerateInstances (
     MI_Boolean keysOnly,
     MI_Filter const* pFilter)
 {
-    reinterpret_cast<MI_Module_Self*>(pSelf)->pServer->EnumerateInstances (
+    reinterpret_cast<MI_Module_Self*>(pSelf)->pPool->EnumerateInstances (
         pSelf, pContext, nameSpace, className, pPropertySet, keysOnly, pFilter);
 }
 
@@ -1359,7 +1112,7 @@ MI_CALL GetInstance (
     MI_Instance const* pInstanceName,
     MI_PropertySet const* pPropertySet)
 {
-    reinterpret_cast<MI_Module_Self*>(pSelf)->pServer->GetInstance (
+    reinterpret_cast<MI_Module_Self*>(pSelf)->pPool->GetInstance (
         pSelf, pContext, nameSpace, className, pInstanceName, pPropertySet);
 }
 
@@ -1372,7 +1125,7 @@ MI_CALL CreateInstance (
     MI_Char const* className,
     MI_Instance const* pNewInstance)
 {
-    reinterpret_cast<MI_Module_Self*>(pSelf)->pServer->CreateInstance (
+    reinterpret_cast<MI_Module_Self*>(pSelf)->pPool->CreateInstance (
         pSelf, pContext, nameSpace, className, pNewInstance);
 }
 
@@ -1386,7 +1139,7 @@ MI_CALL ModifyInstance (
     MI_Instance const* pModifiedInstance,
     MI_PropertySet const* pPropertySet)
 {
-    reinterpret_cast<MI_Module_Self*>(pSelf)->pServer->ModifyInstance (
+    reinterpret_cast<MI_Module_Self*>(pSelf)->pPool->ModifyInstance (
         pSelf, pContext, nameSpace, className, pModifiedInstance, pPropertySet);
 }
 
@@ -1399,7 +1152,7 @@ MI_CALL DeleteInstance (
     MI_Char const* className,
     MI_Instance const* pInstanceName)
 {
-    reinterpret_cast<MI_Module_Self*>(pSelf)->pServer->DeleteInstance (
+    reinterpret_cast<MI_Module_Self*>(pSelf)->pPool->DeleteInstance (
         pSelf, pContext, nameSpace, className, pInstanceName);
 }
 
@@ -1511,7 +1264,7 @@ MI_CALL Invoke (
     MI_Instance const* pInputParameters)
 {
     SCX_BOOKEND ("Invoke: server.cpp");
-    reinterpret_cast<MI_Module_Self*>(pSelf)->pServer->Invoke (
+    reinterpret_cast<MI_Module_Self*>(pSelf)->pPool->Invoke (
         pSelf, pContext, nameSpace, className, methodName, pInstance,
         pInputParameters);
 }
@@ -1519,6 +1272,17 @@ MI_CALL Invoke (
 
 int
 Server::init ()
+{
+#if (USE_SOCKETPAIR)
+    return init_socketpair ();
+#else
+    return init_tcp ();
+#endif
+}
+
+
+int
+Server::init_tcp ()
 {
     int rval = SUCCESS;
 #if (PRINT_BOOKENDS)
@@ -1577,7 +1341,7 @@ Server::init ()
             rval = wait_for_client (listenerFD, key, &fd);
             if (SUCCESS == rval)
             {
-                m_pSocket = new socket_wrapper (fd);
+                m_pSocket = new socket_wrapper (fd, socket_wrapper::DUPLEX);
             }
         }
         else
@@ -1594,3 +1358,409 @@ Server::init ()
     }
     return rval;
 }
+
+
+int
+Server::init_socketpair ()
+{
+    int rval = SUCCESS;
+#if (PRINT_BOOKENDS)
+    std::ostringstream strm;
+    strm << " Module: \"" << m_ModuleName << "\" (libScriptProvider)";
+    SCX_BOOKEND_EX ("Server::open", strm.str ());
+#endif
+    shared_ring::Ptr pRing;
+#if (USE_SHARED_RING)
+    // the ring is optional, fall back to the socket if it can't be created
+    if (shared_ring::SUCCESS !=
+            shared_ring::create (shared_ring::DEFAULT_CAPACITY, &pRing))
+    {
+        SCX_BOOKEND_PRINT ("shared_ring::create failed");
+        pRing.reset ();
+    }
+#endif
+    // create the connected sockets: fds[0] is kept by the parent and fds[1]
+    // is inherited by the client.  Both are close-on-exec from the start so
+    // a client that another thread starts meanwhile can't inherit them and
+    // keep this one's connection from seeing EOF.
+    int fds[2];
+    if (0 == socketpair (AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds))
+    {
+        // fork
+        int pid = fork ();
+        if (0 == pid)
+        {
+            // fork succeded, this is the child process
+            SCX_BOOKEND_PRINT ("fork - succeeded: this is the client");
+            // close the parent socket
+            close (fds[0]);
+            // create the argument list including (path, fd, ring fd)
+            char fdStr[20];
+            sprintf (fdStr, "--fd=%d", fds[1]);
+            char ringStr[20];
+            sprintf (ringStr, "--ring=%d",
+                     pRing ? pRing->getFD () : shared_ring::INVALID_FD);
+            char* args[] = { const_cast<char*>(m_Interpreter.c_str ()),
+                             const_cast<char*>(m_Startup.c_str ()),
+                             const_cast<char*>(m_ModuleName.c_str ()),
+                             fdStr,
+                             ringStr,
+                             0 };
+            // only this client's own ends survive the exec
+            fcntl (fds[1], F_SETFD, 0);
+            if (pRing)
+            {
+                fcntl (pRing->getFD (), F_SETFD, 0);
+            }
+            // exec
+            chdir (CONFIG_LIBDIR);
+            execvp (args[0], args);
+            SCX_BOOKEND_PRINT ("execvp - failed");
+            // if we got here, exec failed!
+            // check errno { EACCES, ENOEXEC }
+            std::ostringstream strm;
+            strm << "Server::open - exec failed: " << errno << ": \""
+                 << errnoText << '\"';
+            SCX_BOOKEND_PRINT (strm.str ());
+            std::cerr << strm.str () << std::endl;
+            close (fds[1]);
+            rval = FORK_FAILED;
+        }
+        else if (-1 != pid)
+        {
+            // fork succeeded, this is the parent process
+            SCX_BOOKEND_PRINT ("fork - succeeded: this is the parent");
+            close (fds[1]);
+            m_pSocket = new socket_wrapper (fds[0], socket_wrapper::DUPLEX);
+            if (pRing)
+            {
+                // the mapping stays valid after the backing file is closed
+                pRing->closeFD ();
+                m_pRing = pRing;
+            }
+        }
+        else
+        {
+            // fork failed
+            // error (check errno { EAGAIN, ENOMEM })
+            std::ostringstream strm;
+            strm << "Server::open - fork failed: " << errno
+                 << ": \"" << errnoText << '\"';
+            SCX_BOOKEND_PRINT (strm.str ());
+            std::cerr << strm.str () << std::endl;
+            close (fds[0]);
+            close (fds[1]);
+            rval = FORK_FAILED;
+        }
+    }
+    else
+    {
+        // error (check errno { EAFNOSUPPORT, EFAULT, EMFILE, ENFILE,
+        //                      EOPNOTSUPP, EPROTONOSUPPORT })
+        std::ostringstream strm;
+        strm << "Server::open - socketpair failed: " << errno
+             << ": \"" << errnoText << '\"';
+        SCX_BOOKEND_PRINT (strm.str ());
+        std::cerr << strm.str () << std::endl;
+        rval = SOCKETPAIR_FAILED;
+    }
+    return rval;
+}
+
+
+/*ctor*/
+Server::pending_request::pending_request (
+    MI_Context* const pContext_,
+    MI_Filter const* const pFilter_,
+    MI_Result* const pResult_)
+    : id (0)
+    , pContext (pContext_)
+    , pFilter (pFilter_)
+    , pResult (pResult_)
+    , complete (false)
+    , rval (SUCCESS)
+{
+    // empty
+}
+
+
+int
+Server::begin_request (
+    pending_request* const pRequest)
+{
+    SCX_BOOKEND ("Server::begin_request");
+    pthread_mutex_lock (&m_SendLock);
+    int rval = open ();
+    if (SUCCESS == rval)
+    {
+        pthread_mutex_lock (&m_Lock);
+        pRequest->id = ++m_NextRequestID;
+        m_Requests[pRequest->id] = pRequest;
+        pthread_mutex_unlock (&m_Lock);
+    }
+    return rval;
+}
+
+
+int
+Server::end_request (
+    pending_request* const pRequest,
+    int rval)
+{
+    SCX_BOOKEND ("Server::end_request");
+    bool flushed = true;
+    if (SUCCESS == rval)
+    {
+        rval = m_pSocket->flush ();
+        flushed = (socket_wrapper::SUCCESS == rval);
+    }
+    pthread_mutex_unlock (&m_SendLock);
+    pthread_mutex_lock (&m_Lock);
+    if (!flushed)
+    {
+        m_Lost = true;
+    }
+    if (SUCCESS == rval)
+    {
+        while (!pRequest->complete)
+        {
+            if (m_Reading)
+            {
+                pthread_cond_wait (&m_Changed, &m_Lock);
+            }
+            else
+            {
+                // no other thread is reading the socket, so this one reads
+                // it for everybody until its own request is complete
+                m_Reading = true;
+                pthread_mutex_unlock (&m_Lock);
+                int result = read_message ();
+                pthread_mutex_lock (&m_Lock);
+                m_Reading = false;
+                if (SUCCESS != result)
+                {
+                    // the socket is gone, none of the requests will get
+                    // a reply
+                    m_Lost = true;
+                    for (request_map::iterator pos = m_Requests.begin (),
+                             endPos = m_Requests.end ();
+                         pos != endPos;
+                         ++pos)
+                    {
+                        pos->second->complete = true;
+                        pos->second->rval = result;
+                    }
+                }
+                pthread_cond_broadcast (&m_Changed);
+            }
+        }
+        rval = pRequest->rval;
+    }
+    else
+    {
+        // stop any more messages from being handed to the request and
+        // wait for the one that may be in progress
+        pRequest->complete = true;
+        while (pRequest == m_pDispatching)
+        {
+            pthread_cond_wait (&m_Changed, &m_Lock);
+        }
+    }
+    request_map::iterator pos = m_Requests.find (pRequest->id);
+    if (m_Requests.end () != pos &&
+        pRequest == pos->second)
+    {
+        m_Requests.erase (pos);
+    }
+    pthread_mutex_unlock (&m_Lock);
+    return rval;
+}
+
+
+/*static*/ void
+Server::post_result (
+    pending_request const& request,
+    MI_Result const& result)
+{
+    if (NULL != request.pResult)
+    {
+        *(request.pResult) = result;
+    }
+    else
+    {
+        MI_Context_PostResult (request.pContext, result);
+    }
+}
+
+
+int
+Server::read_message ()
+{
+    SCX_BOOKEND ("Server::read_message");
+    protocol::opcode_t opcode;
+    protocol::request_id_t requestID;
+    int rval = protocol::recv_opcode (&opcode, &requestID, *m_pSocket);
+    if (socket_wrapper::SUCCESS == rval)
+    {
+        pending_request* pRequest = NULL;
+        switch (opcode)
+        {
+        case protocol::POST_INSTANCE:
+            SCX_BOOKEND_PRINT ("rec'ved POST_INSTANCE");
+            // a message that fails to decode, or that belongs to a request
+            // that is gone, is skipped with the rest of its frame by the
+            // next recv_opcode
+            if (NULL != (pRequest = begin_dispatch (requestID)))
+            {
+                if (socket_wrapper::SUCCESS != protocol::recv_post_instance (
+                        pRequest->pContext, &m_Index,
+                        pRequest->pFilter, &(pRequest->state),
+                        *m_pSocket))
+                {
+                    SCX_BOOKEND_PRINT ("dropped a malformed POST_INSTANCE");
+                }
+                end_dispatch (pRequest);
+            }
+            break;
+        case protocol::POST_INSTANCES:
+            SCX_BOOKEND_PRINT ("rec'ved POST_INSTANCES");
+            if (NULL != (pRequest = begin_dispatch (requestID)))
+            {
+                // the instances after one that fails to decode can't be
+                // found, so the rest of the batch is dropped with it
+                protocol::item_count_t count = 0;
+                int result = protocol::recv_item_count (&count, *m_pSocket);
+                for (protocol::item_count_t i = 0;
+                     socket_wrapper::SUCCESS == result &&
+                         i < count;
+                     ++i)
+                {
+                    result = protocol::recv_post_instance (
+                        pRequest->pContext, &m_Index,
+                        pRequest->pFilter, &(pRequest->state),
+                        *m_pSocket);
+                }
+                if (socket_wrapper::SUCCESS != result)
+                {
+                    SCX_BOOKEND_PRINT ("dropped a malformed POST_INSTANCES");
+                }
+                end_dispatch (pRequest);
+            }
+            break;
+        case protocol::POST_RING:
+            SCX_BOOKEND_PRINT ("rec'ved POST_RING");
+            rval = handle_post_ring ();
+            break;
+        case protocol::POST_RESULT:
+            SCX_BOOKEND_PRINT ("rec'ved POST_RESULT");
+            if (NULL != (pRequest = begin_dispatch (requestID)))
+            {
+                end_dispatch (pRequest, true,
+                              protocol::recv_post_result (
+                                  pRequest->pContext, pRequest->pResult,
+                                  pRequest->state, *m_pSocket));
+            }
+            break;
+        default:
+            SCX_BOOKEND_PRINT ("unexpected opcode");
+            // todo: error
+            break;
+        }
+    }
+    else
+    {
+        SCX_BOOKEND_PRINT ("error receiving opcode");
+    }
+    return rval;
+}
+
+
+int
+Server::handle_post_ring ()
+{
+    SCX_BOOKEND ("Server::handle_post_ring");
+    int rval = socket_wrapper::SUCCESS;
+    if (m_pRing)
+    {
+        // drain the ring, the client keeps writing while this runs
+        socket_wrapper::byte_t const* pData = NULL;
+        size_t nBytes = 0;
+        int result = m_pRing->peek (&pData, &nBytes);
+        while (shared_ring::SUCCESS == result)
+        {
+            // decode the instance in place, a record that fails to decode
+            // is dropped without affecting the ones after it
+            socket_wrapper record (pData, nBytes);
+            protocol::request_id_t requestID;
+            pending_request* pRequest = NULL;
+            if (socket_wrapper::SUCCESS ==
+                    protocol::recv (&requestID, record) &&
+                NULL != (pRequest = begin_dispatch (requestID)))
+            {
+                if (socket_wrapper::SUCCESS != protocol::recv_post_instance (
+                        pRequest->pContext, &m_Index,
+                        pRequest->pFilter, &(pRequest->state),
+                        record))
+                {
+                    SCX_BOOKEND_PRINT ("dropped a malformed ring record");
+                }
+                end_dispatch (pRequest);
+            }
+            m_pRing->consume ();
+            result = m_pRing->peek (&pData, &nBytes);
+        }
+        if (shared_ring::INVALID_RECORD == result)
+        {
+            // the client wrote past what it published, nothing more from
+            // it can be trusted
+            SCX_BOOKEND_PRINT ("invalid ring record");
+            rval = socket_wrapper::RECV_FAILED;
+        }
+    }
+    else
+    {
+        SCX_BOOKEND_PRINT ("POST_RING without a shared ring");
+        rval = socket_wrapper::RECV_FAILED;
+    }
+    return rval;
+}
+
+
+Server::pending_request*
+Server::begin_dispatch (
+    protocol::request_id_t const& id)
+{
+    pending_request* pRequest = NULL;
+    pthread_mutex_lock (&m_Lock);
+    request_map::iterator pos = m_Requests.find (id);
+    if (m_Requests.end () != pos &&
+        !pos->second->complete)
+    {
+        pRequest = pos->second;
+        m_pDispatching = pRequest;
+    }
+    pthread_mutex_unlock (&m_Lock);
+    return pRequest;
+}
+
+
+void
+Server::end_dispatch (
+    pending_request* const pRequest,
+    bool const& complete,
+    int const& rval)
+{
+    pthread_mutex_lock (&m_Lock);
+    m_pDispatching = NULL;
+    if (complete)
+    {
+        pRequest->rval = rval;
+        pRequest->complete = true;
+    }
+    if (pRequest->complete)
+    {
+        // wake the owner of the request
+        pthread_cond_broadcast (&m_Changed);
+    }
+    pthread_mutex_unlock (&m_Lock);
+}
@@ -4,6 +4,9 @@
 #define INCLUDED_SERVER_HPP
 
 
+#include "server_protocol.hpp"
+#include "shared_protocol.hpp"
+#include "shared_ring.hpp"
 #include "socket_wrapper.hpp"
 
 
@@ -18,11 +21,17 @@
 #include <cstdlib>
 #include <errno.h>
 #include <iostream>
+#include <map>
+#include <pthread.h>
 #include <string>
 #include <sstream>
 #include <vector>
 
 
+// Server forwards the provider calls to the client process.  Each call is
+// sent as a request with its own id and the calls may come from any number
+// of threads: the thread that is waiting on a reply reads the socket for
+// all of them and hands each message to the request it belongs to.
 class Server
 {
 public:
@@ -42,6 +51,7 @@ public:
         BAD_ALLOC,
         UNDEFINED_CLASS,
         INSTANCE_ERROR,
+        SOCKETPAIR_FAILED,
     };
 
 
@@ -52,6 +62,11 @@ public:
     /*dtor*/ ~Server ();
 
     int open ();
+    // close the connection to the client, which ends it; the next open
+    // starts a new client.  No request may be in progress.
+    void disconnect ();
+    // false once the client has gone away, until it is disconnected
+    bool isConnected ();
 
     socket_wrapper::Ptr const& getSocket () const;
 
@@ -59,24 +74,32 @@ public:
     
     MI_ClassDeclEx const* findClassDecl (MI_Char const* const className);
 
+    MI_SchemaDecl const* getSchemaDecl () const;
+
+    // the load and unload calls store their result in pResult instead of
+    // posting it to pContext when pResult is not NULL
     void Module_Load (
         MI_Module_Self** ppSelf,
-        struct _MI_Context* pContext);
+        struct _MI_Context* pContext,
+        MI_Result* const pResult = NULL);
 
     void Load (
         size_t const& index,
         void** ppSelf,
         MI_Module_Self* pSelfModule,
-        MI_Context* pContext);
+        MI_Context* pContext,
+        MI_Result* const pResult = NULL);
 
     void Module_Unload (
         MI_Module_Self* pSelf,
-        struct _MI_Context* pContext);
+        struct _MI_Context* pContext,
+        MI_Result* const pResult = NULL);
 
     void Unload (
         size_t const& index,
         void* pSelf,
-        MI_Context* pContext);
+        MI_Context* pContext,
+        MI_Result* const pResult = NULL);
 
     void EnumerateInstances (
         void* const pSelf,
@@ -127,7 +150,48 @@ public:
         MI_Instance const* pInputParameters);
 
 private:
+    // a request that has been sent and is waiting on its POST_RESULT
+    struct pending_request
+    {
+        /*ctor*/ pending_request (
+            MI_Context* const pContext,
+            MI_Filter const* const pFilter = NULL,
+            MI_Result* const pResult = NULL);
+
+        protocol::request_id_t id;
+        MI_Context* const pContext;
+        MI_Filter const* const pFilter;
+        MI_Result* const pResult;
+        // the templates the request's POST_INSTANCE deltas apply to, and
+        // whether an instance was dropped
+        protocol::request_state state;
+        bool complete;
+        int rval;
+    };
+
+    typedef std::map<protocol::request_id_t, pending_request*> request_map;
+
     int init ();
+    int init_tcp ();
+    int init_socketpair ();
+
+    // begin_request takes the send lock and registers the request under a
+    // new id; the caller then sends the request and passes the result to
+    // end_request, which releases the send lock and waits for the reply
+    int begin_request (pending_request* const pRequest);
+    int end_request (pending_request* const pRequest, int rval);
+
+    static void post_result (
+        pending_request const& request,
+        MI_Result const& result);
+
+    int read_message ();
+    int handle_post_ring ();
+    pending_request* begin_dispatch (protocol::request_id_t const& id);
+    void end_dispatch (
+        pending_request* const pRequest,
+        bool const& complete = false,
+        int const& rval = SUCCESS);
 
     /*ctor*/ Server (Server const&); // delete
     Server& operator = (Server const&); // delete
@@ -136,9 +200,23 @@ private:
     std::string const m_Startup;
     std::string const m_ModuleName;
     socket_wrapper::Ptr m_pSocket;
+    shared_ring::Ptr m_pRing;
     util::unique_ptr<MI_SchemaDecl const, MI_Deleter<MI_SchemaDecl const> >
         m_pSchemaDecl;
+    // m_Index is built over m_pSchemaDecl by setSchema
+    schema_index m_Index;
     std::vector<MI_Char const*> m_ClassNames;
+    // m_SendLock is held while a request is written to the socket, m_Lock
+    // guards the state below it
+    pthread_mutex_t m_SendLock;
+    pthread_mutex_t m_Lock;
+    pthread_cond_t m_Changed;
+    protocol::request_id_t m_NextRequestID;
+    request_map m_Requests;
+    bool m_Reading;
+    pending_request* m_pDispatching;
+    // set when the socket fails, the client won't answer any more requests
+    bool m_Lost;
 };
 
 
@@ -149,6 +227,13 @@ Server::getSocket () const
 }
 
 
+inline MI_SchemaDecl const*
+Server::getSchemaDecl () const
+{
+    return m_pSchemaDecl.get ();
+}
+
+
 template<typename char_t, typename traits_t>
 std::basic_ostream<char_t, traits_t>& errnoText (
     std::basic_ostream<char_t, traits_t>& strm);
@@ -0,0 +1,730 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#include "server_pool.hpp"
+
+
+#include "debug_tags.hpp"
+#include "mi_module_self.hpp"
+#include "server_protocol.hpp"
+
+
+#include <algorithm>
+#include <cassert>
+#include <sstream>
+
+
+namespace
+{
+
+
+time_t
+now ()
+{
+    timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec;
+}
+
+
+} // namespace (unnamed)
+
+
+/*static*/ size_t const server_pool::DEFAULT_WORKER_COUNT;
+/*static*/ time_t const server_pool::IDLE_TIMEOUT;
+/*static*/ time_t const server_pool::REAP_INTERVAL;
+
+
+/*ctor*/
+server_pool::worker::worker (
+    Server* const pServer_)
+    : pServer (pServer_)
+    , nActive (0)
+    , idleSince (now ())
+    , ready (true)
+{
+    // empty
+}
+
+
+/*ctor*/
+server_pool::server_pool (
+    std::string const& interpreter,
+    std::string const& startup,
+    std::string const& moduleName,
+    size_t const& minWorkers,
+    size_t const& maxWorkers)
+    : m_Interpreter (interpreter)
+    , m_Startup (startup)
+    , m_ModuleName (moduleName)
+    , m_MinWorkers (std::max<size_t> (1, minWorkers))
+    , m_MaxWorkers (std::max (m_MinWorkers, maxWorkers))
+    , m_ModuleLoaded (false)
+    , m_Starting (false)
+    , m_Stopping (false)
+    , m_HaveReaper (false)
+{
+    SCX_BOOKEND ("server_pool::ctor");
+    pthread_mutex_init (&m_LoadLock, NULL);
+    pthread_mutex_init (&m_Lock, NULL);
+    // the reaper waits on the monotonic clock, like the idle times
+    pthread_condattr_t attr;
+    pthread_condattr_init (&attr);
+    pthread_condattr_setclock (&attr, CLOCK_MONOTONIC);
+    pthread_cond_init (&m_Wake, &attr);
+    pthread_condattr_destroy (&attr);
+}
+
+
+/*dtor*/
+server_pool::~server_pool ()
+{
+    SCX_BOOKEND ("server_pool::dtor");
+    close ();
+    for (worker_list::iterator pos = m_Workers.begin (),
+             endPos = m_Workers.end ();
+         pos != endPos;
+         ++pos)
+    {
+        delete *pos;
+    }
+    pthread_cond_destroy (&m_Wake);
+    pthread_mutex_destroy (&m_Lock);
+    pthread_mutex_destroy (&m_LoadLock);
+}
+
+
+int
+server_pool::open ()
+{
+    SCX_BOOKEND ("server_pool::open");
+#if (PRINT_BOOKENDS)
+    std::ostringstream strm;
+    strm << "minWorkers: " << m_MinWorkers << " maxWorkers: " << m_MaxWorkers;
+    SCX_BOOKEND_PRINT (strm.str ());
+#endif
+    int rval = Server::SUCCESS;
+    pthread_mutex_lock (&m_LoadLock);
+    while (Server::SUCCESS == rval &&
+           m_MinWorkers > m_Workers.size ())
+    {
+        worker* pWorker = start_worker ();
+        if (NULL != pWorker)
+        {
+            pthread_mutex_lock (&m_Lock);
+            m_Workers.push_back (pWorker);
+            pthread_mutex_unlock (&m_Lock);
+        }
+        else if (m_Workers.empty ())
+        {
+            rval = Server::FORK_FAILED;
+        }
+        else
+        {
+            // run with the workers that did start
+            SCX_BOOKEND_PRINT ("start_worker failed");
+            break;
+        }
+    }
+    pthread_mutex_unlock (&m_LoadLock);
+    if (Server::SUCCESS == rval &&
+        !m_HaveReaper)
+    {
+        m_HaveReaper = 0 == pthread_create (&m_Reaper, NULL, reaper_main, this);
+        if (!m_HaveReaper)
+        {
+            SCX_BOOKEND_PRINT ("pthread_create failed");
+        }
+    }
+    return rval;
+}
+
+
+void
+server_pool::close ()
+{
+    if (m_HaveReaper)
+    {
+        pthread_mutex_lock (&m_Lock);
+        m_Stopping = true;
+        pthread_cond_signal (&m_Wake);
+        pthread_mutex_unlock (&m_Lock);
+        pthread_join (m_Reaper, NULL);
+        m_HaveReaper = false;
+    }
+}
+
+
+MI_SchemaDecl const*
+server_pool::getSchemaDecl () const
+{
+    // the first worker is never stopped, only restarted
+    return m_Workers.empty () ?
+        NULL : m_Workers.front ()->pServer->getSchemaDecl ();
+}
+
+
+size_t
+server_pool::getWorkerCount ()
+{
+    pthread_mutex_lock (&m_Lock);
+    size_t const count = m_Workers.size ();
+    pthread_mutex_unlock (&m_Lock);
+    return count;
+}
+
+
+void
+server_pool::Module_Load (
+    MI_Module_Self** ppSelf,
+    struct _MI_Context* pContext)
+{
+    SCX_BOOKEND ("server_pool::Module_Load");
+    MI_Result result = MI_RESULT_OK;
+    pthread_mutex_lock (&m_LoadLock);
+    worker_list workers;
+    get_workers (&workers);
+    for (worker_list::iterator pos = workers.begin (), endPos = workers.end ();
+         pos != endPos;
+         ++pos)
+    {
+        MI_Result workerResult = MI_RESULT_FAILED;
+        (*pos)->pServer->Module_Load (ppSelf, pContext, &workerResult);
+        if (MI_RESULT_OK == result)
+        {
+            result = workerResult;
+        }
+    }
+    m_ModuleLoaded = (MI_RESULT_OK == result);
+    pthread_mutex_unlock (&m_LoadLock);
+    MI_Context_PostResult (pContext, result);
+}
+
+
+void
+server_pool::Load (
+    size_t const& index,
+    void** ppSelf,
+    MI_Module_Self* pSelfModule,
+    MI_Context* pContext)
+{
+    SCX_BOOKEND ("server_pool::Load (index)");
+    MI_Result result = MI_RESULT_OK;
+    pthread_mutex_lock (&m_LoadLock);
+    worker_list workers;
+    get_workers (&workers);
+    for (worker_list::iterator pos = workers.begin (), endPos = workers.end ();
+         pos != endPos;
+         ++pos)
+    {
+        MI_Result workerResult = MI_RESULT_FAILED;
+        (*pos)->pServer->Load (
+            index, ppSelf, pSelfModule, pContext, &workerResult);
+        if (MI_RESULT_OK == result)
+        {
+            result = workerResult;
+        }
+    }
+    if (MI_RESULT_OK == result)
+    {
+        m_LoadedClasses.insert (index);
+    }
+    pthread_mutex_unlock (&m_LoadLock);
+    MI_Context_PostResult (pContext, result);
+}
+
+
+void
+server_pool::Module_Unload (
+    MI_Module_Self* pSelf,
+    struct _MI_Context* pContext)
+{
+    SCX_BOOKEND ("server_pool::Module_Unload");
+    MI_Result result = MI_RESULT_OK;
+    pthread_mutex_lock (&m_LoadLock);
+    worker_list workers;
+    get_workers (&workers);
+    for (worker_list::iterator pos = workers.begin (), endPos = workers.end ();
+         pos != endPos;
+         ++pos)
+    {
+        MI_Result workerResult = MI_RESULT_FAILED;
+        (*pos)->pServer->Module_Unload (pSelf, pContext, &workerResult);
+        if (MI_RESULT_OK == result)
+        {
+            result = workerResult;
+        }
+    }
+    m_ModuleLoaded = false;
+    pthread_mutex_unlock (&m_LoadLock);
+    MI_Context_PostResult (pContext, result);
+}
+
+
+void
+server_pool::Unload (
+    size_t const& index,
+    void* pSelf,
+    MI_Context* pContext)
+{
+    SCX_BOOKEND ("server_pool::Unload (index)");
+    MI_Result result = MI_RESULT_OK;
+    pthread_mutex_lock (&m_LoadLock);
+    worker_list workers;
+    get_workers (&workers);
+    for (worker_list::iterator pos = workers.begin (), endPos = workers.end ();
+         pos != endPos;
+         ++pos)
+    {
+        MI_Result workerResult = MI_RESULT_FAILED;
+        (*pos)->pServer->Unload (index, pSelf, pContext, &workerResult);
+        if (MI_RESULT_OK == result)
+        {
+            result = workerResult;
+        }
+    }
+    m_LoadedClasses.erase (index);
+    pthread_mutex_unlock (&m_LoadLock);
+    MI_Context_PostResult (pContext, result);
+}
+
+
+void
+server_pool::EnumerateInstances (
+    void* const pSelf,
+    MI_Context* const pContext,
+    MI_Char const* const nameSpace,
+    MI_Char const* const className,
+    MI_PropertySet const* const pPropertySet,
+    MI_Boolean const keysOnly,
+    MI_Filter const* const pFilter)
+{
+    worker* pWorker = acquire ();
+    if (NULL != pWorker)
+    {
+        pWorker->pServer->EnumerateInstances (
+            pSelf, pContext, nameSpace, className, pPropertySet, keysOnly,
+            pFilter);
+        release (pWorker);
+    }
+    else
+    {
+        MI_Context_PostResult (pContext, MI_RESULT_FAILED);
+    }
+}
+
+
+void
+server_pool::GetInstance (
+    void* const pSelf,
+    MI_Context* const pContext,
+    MI_Char const* const nameSpace,
+    MI_Char const* const className,
+    MI_Instance const* pInstanceName,
+    MI_PropertySet const* const pPropertySet)
+{
+    worker* pWorker = acquire ();
+    if (NULL != pWorker)
+    {
+        pWorker->pServer->GetInstance (
+            pSelf, pContext, nameSpace, className, pInstanceName,
+            pPropertySet);
+        release (pWorker);
+    }
+    else
+    {
+        MI_Context_PostResult (pContext, MI_RESULT_FAILED);
+    }
+}
+
+
+void
+server_pool::CreateInstance (
+    void* pSelf,
+    MI_Context* pContext,
+    MI_Char const* nameSpace,
+    MI_Char const* className,
+    MI_Instance const* pNewInstance)
+{
+    worker* pWorker = acquire ();
+    if (NULL != pWorker)
+    {
+        pWorker->pServer->CreateInstance (
+            pSelf, pContext, nameSpace, className, pNewInstance);
+        release (pWorker);
+    }
+    else
+    {
+        MI_Context_PostResult (pContext, MI_RESULT_FAILED);
+    }
+}
+
+
+void
+server_pool::ModifyInstance (
+    void* pSelf,
+    MI_Context* pContext,
+    MI_Char const* nameSpace,
+    MI_Char const* className,
+    MI_Instance const* pModifiedInstance,
+    MI_PropertySet const* pPropertySet)
+{
+    worker* pWorker = acquire ();
+    if (NULL != pWorker)
+    {
+        pWorker->pServer->ModifyInstance (
+            pSelf, pContext, nameSpace, className, pModifiedInstance,
+            pPropertySet);
+        release (pWorker);
+    }
+    else
+    {
+        MI_Context_PostResult (pContext, MI_RESULT_FAILED);
+    }
+}
+
+
+void
+server_pool::DeleteInstance (
+    void* const pSelf,
+    MI_Context* const pContext,
+    MI_Char const* const nameSpace,
+    MI_Char const* const className,
+    MI_Instance const* pInstanceName)
+{
+    worker* pWorker = acquire ();
+    if (NULL != pWorker)
+    {
+        pWorker->pServer->DeleteInstance (
+            pSelf, pContext, nameSpace, className, pInstanceName);
+        release (pWorker);
+    }
+    else
+    {
+        MI_Context_PostResult (pContext, MI_RESULT_FAILED);
+    }
+}
+
+
+void
+server_pool::Invoke (
+    void* pSelf,
+    MI_Context* pContext,
+    MI_Char const* nameSpace,
+    MI_Char const* className,
+    MI_Char const* methodName,
+    MI_Instance const* pInstance,
+    MI_Instance const* pInputParameters)
+{
+    worker* pWorker = acquire ();
+    if (NULL != pWorker)
+    {
+        pWorker->pServer->Invoke (
+            pSelf, pContext, nameSpace, className, methodName, pInstance,
+            pInputParameters);
+        release (pWorker);
+    }
+    else
+    {
+        MI_Context_PostResult (pContext, MI_RESULT_FAILED);
+    }
+}
+
+
+server_pool::worker*
+server_pool::start_worker ()
+{
+    SCX_BOOKEND ("server_pool::start_worker");
+    util::unique_ptr<worker> pWorker (
+        new worker (new Server (m_Interpreter, m_Startup, m_ModuleName)));
+    if (Server::SUCCESS != connect_worker (pWorker->pServer.get ()))
+    {
+        SCX_BOOKEND_PRINT ("failed to start the new worker");
+        pWorker.reset ();
+    }
+    return pWorker.release ();
+}
+
+
+void
+server_pool::stop_worker (
+    worker* const pWorker)
+{
+    SCX_BOOKEND ("server_pool::stop_worker");
+    // the worker is going away whether or not the provider unloads cleanly
+    MI_Result result = MI_RESULT_OK;
+    for (std::set<size_t>::const_iterator pos = m_LoadedClasses.begin (),
+             endPos = m_LoadedClasses.end ();
+         pos != endPos;
+         ++pos)
+    {
+        pWorker->pServer->Unload (*pos, NULL, NULL, &result);
+    }
+    if (m_ModuleLoaded)
+    {
+        pWorker->pServer->Module_Unload (NULL, NULL, &result);
+    }
+    // closing the socket ends the client
+    delete pWorker;
+}
+
+
+bool
+server_pool::restart_worker (
+    worker* const pWorker)
+{
+    SCX_BOOKEND ("server_pool::restart_worker");
+    // the Server is kept, with the schema it was given first
+    pWorker->pServer->disconnect ();
+    return Server::SUCCESS == connect_worker (pWorker->pServer.get ());
+}
+
+
+bool
+server_pool::is_alive (
+    worker* const pWorker)
+{
+    return pWorker->pServer->isConnected ();
+}
+
+
+int
+server_pool::connect_worker (
+    Server* const pServer)
+{
+    MI_SchemaDecl* pSchemaDecl = NULL;
+    int rval = pServer->open ();
+    if (Server::SUCCESS == rval &&
+        socket_wrapper::SUCCESS !=
+            protocol::recv (&pSchemaDecl, *(pServer->getSocket ())))
+    {
+        rval = Server::RECV_FAILED;
+    }
+    if (Server::SUCCESS == rval)
+    {
+        if (NULL == pServer->getSchemaDecl ())
+        {
+            // every worker keeps its own copy of the schema
+            pServer->setSchema (pSchemaDecl);
+        }
+        else
+        {
+            // a restarted client sends the same schema again
+            util::unique_ptr<MI_SchemaDecl, MI_Deleter<MI_SchemaDecl> >
+                pDiscard (pSchemaDecl);
+        }
+        MI_Result result = MI_RESULT_OK;
+        if (m_ModuleLoaded)
+        {
+            MI_Module_Self* pSelf = NULL;
+            pServer->Module_Load (&pSelf, NULL, &result);
+        }
+        for (std::set<size_t>::const_iterator
+                 pos = m_LoadedClasses.begin (),
+                 endPos = m_LoadedClasses.end ();
+             MI_RESULT_OK == result && pos != endPos;
+             ++pos)
+        {
+            void* pSelf = NULL;
+            pServer->Load (*pos, &pSelf, NULL, NULL, &result);
+        }
+        if (MI_RESULT_OK != result)
+        {
+            SCX_BOOKEND_PRINT ("failed to load the worker");
+            rval = Server::INSTANCE_ERROR;
+        }
+    }
+    return rval;
+}
+
+
+server_pool::worker*
+server_pool::acquire ()
+{
+    pthread_mutex_lock (&m_Lock);
+    worker* pWorker = pick_worker ();
+    if ((NULL == pWorker || 0 < pWorker->nActive) &&
+        m_MaxWorkers > m_Workers.size () &&
+        !m_Starting)
+    {
+        // every worker is busy, start another one; the other requests
+        // keep using the workers that are running while it starts
+        m_Starting = true;
+        pthread_mutex_unlock (&m_Lock);
+        pthread_mutex_lock (&m_LoadLock);
+        worker* pNewWorker = start_worker ();
+        pthread_mutex_lock (&m_Lock);
+        pthread_mutex_unlock (&m_LoadLock);
+        m_Starting = false;
+        if (NULL != pNewWorker)
+        {
+            m_Workers.push_back (pNewWorker);
+            pWorker = pNewWorker;
+        }
+        else
+        {
+            // the worker picked before may have been stopped in the
+            // meantime
+            pWorker = pick_worker ();
+        }
+    }
+    if (NULL != pWorker)
+    {
+        ++(pWorker->nActive);
+    }
+    pthread_mutex_unlock (&m_Lock);
+    return pWorker;
+}
+
+
+void
+server_pool::release (
+    worker* const pWorker)
+{
+    pthread_mutex_lock (&m_Lock);
+    if (0 == --(pWorker->nActive))
+    {
+        pWorker->idleSince = now ();
+    }
+    pthread_mutex_unlock (&m_Lock);
+}
+
+
+void
+server_pool::reap (
+    time_t const& currentTime)
+{
+    pthread_mutex_lock (&m_LoadLock);
+    worker_list idle;
+    worker_list lost;
+    time_t const cutoff = currentTime - IDLE_TIMEOUT;
+    pthread_mutex_lock (&m_Lock);
+    for (size_t i = m_Workers.size (); 0 < i; --i)
+    {
+        worker* const pWorker = m_Workers[i - 1];
+        if (0 == pWorker->nActive)
+        {
+            if (pWorker->ready &&
+                !is_alive (pWorker))
+            {
+                pWorker->ready = false;
+            }
+            if (m_MinWorkers < i &&
+                (!pWorker->ready ||
+                 cutoff >= pWorker->idleSince))
+            {
+                m_Workers.erase (m_Workers.begin () + (i - 1));
+                if (pWorker->ready)
+                {
+                    idle.push_back (pWorker);
+                }
+                else
+                {
+                    // the client is gone, there is nothing to unload
+                    delete pWorker;
+                }
+            }
+            else if (!pWorker->ready)
+            {
+                lost.push_back (pWorker);
+            }
+        }
+    }
+    pthread_mutex_unlock (&m_Lock);
+    for (worker_list::iterator pos = idle.begin (), endPos = idle.end ();
+         pos != endPos;
+         ++pos)
+    {
+        stop_worker (*pos);
+    }
+    for (worker_list::iterator pos = lost.begin (), endPos = lost.end ();
+         pos != endPos;
+         ++pos)
+    {
+        // acquire doesn't hand out a worker that isn't ready, a worker
+        // that fails to restart is tried again on the next pass
+        bool const restarted = restart_worker (*pos);
+        pthread_mutex_lock (&m_Lock);
+        (*pos)->ready = restarted;
+        (*pos)->idleSince = currentTime;
+        pthread_mutex_unlock (&m_Lock);
+    }
+    pthread_mutex_unlock (&m_LoadLock);
+}
+
+
+server_pool::worker*
+server_pool::pick_worker ()
+{
+    worker* pWorker = NULL;
+    for (worker_list::iterator pos = m_Workers.begin (),
+             endPos = m_Workers.end ();
+         pos != endPos;
+         ++pos)
+    {
+        if ((*pos)->ready &&
+            (NULL == pWorker ||
+             (*pos)->nActive < pWorker->nActive))
+        {
+            if (is_alive (*pos))
+            {
+                pWorker = *pos;
+            }
+            else
+            {
+                // wake the reaper to restart it once its requests are done
+                pthread_cond_signal (&m_Wake);
+            }
+        }
+    }
+    return pWorker;
+}
+
+
+void
+server_pool::get_workers (
+    worker_list* const pWorkersOut)
+{
+    pthread_mutex_lock (&m_Lock);
+    pWorkersOut->clear ();
+    for (worker_list::iterator pos = m_Workers.begin (),
+             endPos = m_Workers.end ();
+         pos != endPos;
+         ++pos)
+    {
+        if ((*pos)->ready)
+        {
+            pWorkersOut->push_back (*pos);
+        }
+    }
+    pthread_mutex_unlock (&m_Lock);
+}
+
+
+/*static*/ void*
+server_pool::reaper_main (
+    void* pPool)
+{
+    reinterpret_cast<server_pool*>(pPool)->run_reaper ();
+    return NULL;
+}
+
+
+void
+server_pool::run_reaper ()
+{
+    pthread_mutex_lock (&m_Lock);
+    while (!m_Stopping)
+    {
+        timespec wakeTime;
+        clock_gettime (CLOCK_MONOTONIC, &wakeTime);
+        wakeTime.tv_sec += REAP_INTERVAL;
+        pthread_cond_timedwait (&m_Wake, &m_Lock, &wakeTime);
+        if (!m_Stopping)
+        {
+            pthread_mutex_unlock (&m_Lock);
+            reap (now ());
+            pthread_mutex_lock (&m_Lock);
+        }
+    }
+    pthread_mutex_unlock (&m_Lock);
+}
@@ -0,0 +1,202 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#ifndef INCLUDED_SERVER_POOL_HPP
+#define INCLUDED_SERVER_POOL_HPP
+
+
+#include "server.hpp"
+
+
+#include <MI.h>
+
+
+#include <cstdlib>
+#include <pthread.h>
+#include <set>
+#include <string>
+#include <time.h>
+#include <vector>
+
+
+// server_pool runs a module in a number of identical client processes, each
+// one behind its own Server.
+//
+// Module and class loads and unloads go to every worker.  Every other
+// request goes to the worker with the fewest requests in progress.  The
+// pool starts with minWorkers.  When every worker is busy it starts another
+// one, up to maxWorkers.
+//
+// A reaper thread stops the workers above minWorkers once they have been
+// idle for a while and restarts a worker whose client has gone away, so
+// neither is done on a request's thread or with a request's context.
+class server_pool
+{
+public:
+    static size_t const DEFAULT_WORKER_COUNT = 1;
+    // seconds a worker above the minimum may sit idle before it is stopped
+    static time_t const IDLE_TIMEOUT = 60;
+    // seconds between the reaper's passes over the workers
+    static time_t const REAP_INTERVAL = 5;
+
+
+    /*ctor*/ server_pool (
+        std::string const& interpreter,
+        std::string const& startup,
+        std::string const& moduleName,
+        size_t const& minWorkers = DEFAULT_WORKER_COUNT,
+        size_t const& maxWorkers = DEFAULT_WORKER_COUNT);
+    virtual /*dtor*/ ~server_pool ();
+
+    // starts the first minWorkers workers and the reaper
+    int open ();
+    // stops the reaper; a class that overrides the worker functions below
+    // has to call it from its own dtor
+    void close ();
+
+    // the schema sent by the first worker, valid for the life of the pool
+    MI_SchemaDecl const* getSchemaDecl () const;
+
+    size_t getWorkerCount ();
+
+    void Module_Load (
+        MI_Module_Self** ppSelf,
+        struct _MI_Context* pContext);
+
+    void Load (
+        size_t const& index,
+        void** ppSelf,
+        MI_Module_Self* pSelfModule,
+        MI_Context* pContext);
+
+    void Module_Unload (
+        MI_Module_Self* pSelf,
+        struct _MI_Context* pContext);
+
+    void Unload (
+        size_t const& index,
+        void* pSelf,
+        MI_Context* pContext);
+
+    void EnumerateInstances (
+        void* const pSelf,
+        MI_Context* const pContext,
+        MI_Char const* const nameSpace,
+        MI_Char const* const className,
+        MI_PropertySet const* const pPropertySet,
+        MI_Boolean const keysOnly,
+        MI_Filter const* const pFilter);
+
+    void GetInstance (
+        void* const pSelf,
+        MI_Context* const pContext,
+        MI_Char const* const nameSpace,
+        MI_Char const* const className,
+        MI_Instance const* pInstanceName,
+        MI_PropertySet const* const pPropertySet);
+
+    void CreateInstance (
+        void* pSelf,
+        MI_Context* pContext,
+        MI_Char const* nameSpace,
+        MI_Char const* className,
+        MI_Instance const* pNewInstance);
+
+    void ModifyInstance (
+        void* pSelf,
+        MI_Context* pContext,
+        MI_Char const* nameSpace,
+        MI_Char const* className,
+        MI_Instance const* pModifiedInstance,
+        MI_PropertySet const* pPropertySet);
+
+    void DeleteInstance (
+        void* const pSelf,
+        MI_Context* const pContext,
+        MI_Char const* const nameSpace,
+        MI_Char const* const className,
+        MI_Instance const* pInstanceName);
+
+    void Invoke (
+        void* pSelf,
+        MI_Context* pContext,
+        MI_Char const* nameSpace,
+        MI_Char const* className,
+        MI_Char const* methodName,
+        MI_Instance const* pInstance,
+        MI_Instance const* pInputParameters);
+
+protected:
+    struct worker
+    {
+        /*ctor*/ worker (Server* const pServer);
+
+        util::unique_ptr<Server> const pServer;
+        size_t nActive;
+        time_t idleSince;
+        // false while the worker's client is gone or being restarted, no
+        // request is sent to it
+        bool ready;
+    };
+
+    // the worker functions; the caller holds m_LoadLock and none of them
+    // use a context
+    //
+    // start a worker and bring it up to the module and classes that are
+    // loaded, NULL if it fails
+    virtual worker* start_worker ();
+    // unload and stop the worker, which has no requests in progress
+    virtual void stop_worker (worker* const pWorker);
+    // start a new client for a worker whose client has gone away and bring
+    // it up to the module and classes that are loaded
+    virtual bool restart_worker (worker* const pWorker);
+    // false once the worker's client has gone away; the caller holds m_Lock
+    virtual bool is_alive (worker* const pWorker);
+
+    // pick the worker for a request, NULL if there is none
+    worker* acquire ();
+    void release (worker* const pWorker);
+    // stop the workers above minWorkers that have been idle since before
+    // currentTime - IDLE_TIMEOUT and restart the ones whose client is gone
+    void reap (time_t const& currentTime);
+
+private:
+    typedef std::vector<worker*> worker_list;
+
+    // open the server's client and bring it up to the module and classes
+    // that are loaded; the caller holds m_LoadLock
+    int connect_worker (Server* const pServer);
+    // the ready worker with the fewest requests in progress, NULL if there
+    // is none; the caller holds m_Lock
+    worker* pick_worker ();
+
+    // the workers that are ready, a worker that isn't is brought up to the
+    // loads and unloads when it is restarted; the caller holds m_LoadLock
+    void get_workers (worker_list* const pWorkersOut);
+
+    static void* reaper_main (void* pPool);
+    void run_reaper ();
+
+    /*ctor*/ server_pool (server_pool const&); // = delete
+    server_pool& operator = (server_pool const&); // = delete
+
+    std::string const m_Interpreter;
+    std::string const m_Startup;
+    std::string const m_ModuleName;
+    size_t const m_MinWorkers;
+    size_t const m_MaxWorkers;
+    // m_LoadLock keeps the set of loaded classes the same across a worker
+    // starting or stopping, m_Lock guards the state below it
+    pthread_mutex_t m_LoadLock;
+    bool m_ModuleLoaded;
+    std::set<size_t> m_LoadedClasses;
+    pthread_mutex_t m_Lock;
+    worker_list m_Workers;
+    bool m_Starting;
+    pthread_cond_t m_Wake;
+    bool m_Stopping;
+    bool m_HaveReaper;
+    pthread_t m_Reaper;
+};
+
+
+#endif // INCLUDED_SERVER_POOL_HPP
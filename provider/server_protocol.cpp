@@ -149,15 +149,61 @@ struct ClassFinder
 
 struct Value
 {
-    std::basic_string<MI_Char> key;
+    MI_Char const* key;
+    // the index of the element when the instance was sent with ordinals
+    MI_Uint32 index;
     protocol::data_type_t type;
+    // the value was removed from the template (see MI_DELTA_FLAG)
+    bool cleared;
     MI_Value value;
 
     /*ctor*/ Value ()
+        : key (NULL)
+        , index (protocol::NO_ORDINAL)
+        , cleared (false)
     {
         memset (&value, 0, sizeof (MI_Value));
     }
 };
+
+
+// string_copies owns the strings that protocol::recv_in_place could not
+// leave in the message, for as long as the decoded values point at them.
+class string_copies
+{
+public:
+    /*ctor*/ string_copies () {}
+
+    /*dtor*/ ~string_copies ()
+    {
+        for (std::vector<MI_Char*>::iterator pos = m_Copies.begin (),
+                 endPos = m_Copies.end ();
+             pos != endPos;
+             ++pos)
+        {
+            delete[] *pos;
+        }
+    }
+
+    int recv (
+        MI_Char const** const ppStringOut,
+        socket_wrapper& sock)
+    {
+        util::unique_ptr<MI_Char[]> pCopy;
+        int rval = protocol::recv_in_place (ppStringOut, &pCopy, sock);
+        if (pCopy)
+        {
+            m_Copies.push_back (pCopy.release ());
+        }
+        return rval;
+    }
+
+private:
+    /*ctor*/ string_copies (string_copies const&); // = delete
+    string_copies& operator = (string_copies const&); // = delete
+
+    std::vector<MI_Char*> m_Copies;
+};
     
 
 //void
@@ -500,6 +546,8 @@ public:
 };
 
 
+// Arr sends and receives an array of fixed size items as one block
+// (see protocol::send_items); the arrays of other types are specialized.
 template<scx::TypeID_t TYPE>
 class Arr
 {
@@ -519,11 +567,110 @@ public:
         {
             array.reset (
                 new typename scx::MI_ArrayType<TYPE>::nested_type_t[count]);
+            rval = protocol::recv_items (array.get (), count, sock);
+        }
+        if (socket_wrapper::SUCCESS == rval)
+        {
+            *ppData = array.release ();
+            *pSize = count;
+        }
+        return rval;    
+    }
+
+    template<typename T>
+    static int
+    send (
+        T const* const pData,
+        MI_Uint32 const& size,
+        socket_wrapper& sock)
+    {
+        int rval = protocol::send_item_count (
+            static_cast<protocol::item_count_t>(size), sock);
+        if (socket_wrapper::SUCCESS == rval)
+        {
+            rval = protocol::send_items (
+                pData, static_cast<protocol::item_count_t>(size), sock);
+        }
+        return rval;
+    }
+};
+
+
+template<>
+class Arr<MI_BOOLEANA>
+{
+public:
+    static int
+    recv (
+        MI_Boolean** const ppData,
+        MI_Uint32* const pSize,
+        socket_wrapper& sock)
+    {
+        protocol::item_count_t count = 0;
+        util::unique_ptr<MI_Boolean[]> array;
+        int rval = protocol::recv_item_count (&count, sock);
+        if (socket_wrapper::SUCCESS == rval)
+        {
+            array.reset (new MI_Boolean[count]);
+            rval = protocol::recv_items (array.get (), count, sock);
+        }
+        if (socket_wrapper::SUCCESS == rval)
+        {
+            for (protocol::item_count_t i = 0; i < count; ++i)
+            {
+                array[i] = array[i] ? MI_TRUE : MI_FALSE;
+            }
+            *ppData = array.release ();
+            *pSize = count;
+        }
+        return rval;    
+    }
+
+    static int
+    send (
+        MI_Boolean const* const pData,
+        MI_Uint32 const& size,
+        socket_wrapper& sock)
+    {
+        int rval = protocol::send_item_count (
+            static_cast<protocol::item_count_t>(size), sock);
+        if (socket_wrapper::SUCCESS == rval &&
+            0 < size)
+        {
+            std::vector<protocol::boolean_t> items (size);
+            for (MI_Uint32 i = 0; i < size; ++i)
+            {
+                items[i] = pData[i] ? 1 : 0;
+            }
+            rval = protocol::send_items (
+                &items[0], static_cast<protocol::item_count_t>(size), sock);
+        }
+        return rval;
+    }
+};
+
+
+template<>
+class Arr<MI_DATETIMEA>
+{
+public:
+    static int
+    recv (
+        MI_Datetime** const ppData,
+        MI_Uint32* const pSize,
+        socket_wrapper& sock)
+    {
+        protocol::item_count_t count = 0;
+        util::unique_ptr<MI_Datetime[]> array;
+        int rval = protocol::recv_item_count (&count, sock);
+        if (socket_wrapper::SUCCESS == rval)
+        {
+            array.reset (new MI_Datetime[count]);
             for (protocol::item_count_t i = 0;
                  i < count && socket_wrapper::SUCCESS == rval;
                  ++i)
             {
-                rval = Val<TYPE & ~MI_ARRAY>::recv (array.get () + i, sock);
+                rval = Val<MI_DATETIME>::recv (array.get () + i, sock);
             }
         }
         if (socket_wrapper::SUCCESS == rval)
@@ -534,10 +681,9 @@ public:
         return rval;    
     }
 
-    template<typename T>
     static int
     send (
-        T const* const pData,
+        MI_Datetime const* const pData,
         MI_Uint32 const& size,
         socket_wrapper& sock)
     {
@@ -547,7 +693,7 @@ public:
              socket_wrapper::SUCCESS == rval && i < size;
              ++i)
         {
-            rval = Val<TYPE & ~MI_ARRAY>::send (pData[i], sock);
+            rval = Val<MI_DATETIME>::send (pData[i], sock);
         }
         return rval;
     }
@@ -742,7 +888,7 @@ recv (
     MI_Value* const pValueOut,
     protocol::data_type_t const& type,
     MI_Context* const pContext,
-    MI_SchemaDecl const* const pSchemaDecl,
+    schema_index const* const pIndex,
     socket_wrapper& sock)
 {
     VALUE_BOOKEND ("recv (MI_Value)");
@@ -811,7 +957,7 @@ recv (
         rval = EXIT_FAILURE;
     case MI_INSTANCE:
         VALUE_PRINT ("MI_INSTANCE");
-        rval = protocol::recv (&(pValueOut->instance), pContext, pSchemaDecl,
+        rval = protocol::recv (&(pValueOut->instance), pContext, pIndex,
                                sock);
         break;
     case MI_BOOLEANA:
@@ -1083,6 +1229,89 @@ namespace protocol
 {
 
 
+/*ctor*/
+instance_templates::instance_templates ()
+{
+    // empty
+}
+
+
+/*dtor*/
+instance_templates::~instance_templates ()
+{
+    for (template_map_t::iterator pos = m_Templates.begin (),
+             endPos = m_Templates.end ();
+         pos != endPos;
+         ++pos)
+    {
+        MI_Instance_Delete (pos->second);
+    }
+}
+
+
+MI_Instance*
+instance_templates::get (
+    MI_Uint32 const& classOrdinal) const
+{
+    template_map_t::const_iterator pos = m_Templates.find (classOrdinal);
+    return m_Templates.end () != pos ? pos->second : NULL;
+}
+
+
+void
+instance_templates::set (
+    MI_Uint32 const& classOrdinal,
+    MI_Instance* const pInstance)
+{
+    MI_Instance*& pTemplate = m_Templates[classOrdinal];
+    if (pInstance != pTemplate &&
+        NULL != pTemplate)
+    {
+        MI_Instance_Delete (pTemplate);
+    }
+    pTemplate = pInstance;
+}
+
+
+void
+instance_templates::erase (
+    MI_Uint32 const& classOrdinal)
+{
+    template_map_t::iterator pos = m_Templates.find (classOrdinal);
+    if (m_Templates.end () != pos)
+    {
+        MI_Instance_Delete (pos->second);
+        m_Templates.erase (pos);
+    }
+}
+
+
+bool
+instance_templates::owns (
+    MI_Instance const* const pInstance) const
+{
+    for (template_map_t::const_iterator pos = m_Templates.begin (),
+             endPos = m_Templates.end ();
+         pos != endPos;
+         ++pos)
+    {
+        if (pInstance == pos->second)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/*ctor*/
+request_state::request_state ()
+    : dropped (false)
+{
+    // empty
+}
+
+
 #if (0)
 #define PRINT_RECV_INSTANCE (PRINT_BOOKENDS)
 #else
@@ -1101,13 +1330,16 @@ int
 recv (
     MI_Instance** const ppInstanceOut,
     MI_Context* const pContext,
-    MI_SchemaDecl const* const pSchemaDecl,
-    socket_wrapper& sock)
+    schema_index const* const pIndex,
+    socket_wrapper& sock,
+    instance_templates* const pTemplates)
 {
     INSTANCE_BOOKEND ("protocol::recv (MI_Instance)");
 #if (PRINT_RECV_INSTANCE)
     std::ostringstream strm;
 #endif
+    MI_SchemaDecl const* const pSchemaDecl =
+        pIndex ? pIndex->getSchemaDecl () : NULL;
     // recv a flag the distinguishes whether this instance is a MI_Instance or
     // a MI_MethodDecl
     // if this is an MI_MethodDecl, the className will be the parent class
@@ -1133,15 +1365,75 @@ recv (
         }
 #endif
     }
-    std::basic_string<MI_Char> className;
-    if (socket_wrapper::SUCCESS == rval)
+    // names and string values are used where they lie in the message
+    string_copies copies;
+    bool const useOrdinals =
+        protocol::MI_ORDINAL_FLAG == (protocol::MI_ORDINAL_FLAG & flags);
+    // a template or a delta is always a class instance sent with ordinals
+    bool const isDelta =
+        protocol::MI_DELTA_FLAG == (protocol::MI_DELTA_FLAG & flags);
+    bool const isTemplate = isDelta ||
+        protocol::MI_TEMPLATE_FLAG == (protocol::MI_TEMPLATE_FLAG & flags);
+    if (socket_wrapper::SUCCESS == rval &&
+        isTemplate &&
+        (NULL == pTemplates ||
+         !useOrdinals ||
+         protocol::MI_METHOD_FLAG == (protocol::MI_METHOD_FLAG & flags)))
+    {
+        INSTANCE_PRINT ("unexpected template");
+        rval = EXIT_FAILURE;
+    }
+    MI_Uint32 classOrdinal = protocol::NO_ORDINAL;
+    // with ordinals the declaration is known before the values are read and
+    // the values are named by their index in it
+    MI_ClassDecl const* pClassDecl = NULL;
+    MI_MethodDecl const* pMethodDecl = NULL;
+    if (socket_wrapper::SUCCESS == rval &&
+        useOrdinals)
+    {
+        INSTANCE_BOOKEND ("recv ordinals");
+        MI_Uint32 methodOrdinal = protocol::NO_ORDINAL;
+        rval = recv (&classOrdinal, sock);
+        if (socket_wrapper::SUCCESS == rval &&
+            protocol::MI_METHOD_FLAG == (protocol::MI_METHOD_FLAG & flags))
+        {
+            rval = recv (&methodOrdinal, sock);
+        }
+        if (socket_wrapper::SUCCESS == rval)
+        {
+            if (NULL != pSchemaDecl &&
+                classOrdinal < pSchemaDecl->numClassDecls)
+            {
+                pClassDecl = pSchemaDecl->classDecls[classOrdinal];
+                if (protocol::MI_METHOD_FLAG ==
+                        (protocol::MI_METHOD_FLAG & flags))
+                {
+                    pMethodDecl = methodOrdinal < pClassDecl->numMethods ?
+                        pClassDecl->methods[methodOrdinal] : NULL;
+                    if (NULL == pMethodDecl)
+                    {
+                        INSTANCE_PRINT ("method ordinal out of range");
+                        rval = EXIT_FAILURE;
+                    }
+                }
+            }
+            else
+            {
+                INSTANCE_PRINT ("class ordinal out of range");
+                rval = EXIT_FAILURE;
+            }
+        }
+    }
+    MI_Char const* className = NULL;
+    if (socket_wrapper::SUCCESS == rval &&
+        !useOrdinals)
     {
         INSTANCE_BOOKEND ("recv class name");
-        rval = recv (&className, sock);
+        rval = copies.recv (&className, sock);
 #if (PRINT_RECV_INSTANCE)
         if (socket_wrapper::SUCCESS == rval)
         {
-            strm << "class name: \"" << className << "\"";
+            strm << "class name: \"" << (className ? className : "") << "\"";
             INSTANCE_PRINT (strm.str ());
             strm.str ("");
             strm.clear ();
@@ -1152,16 +1444,17 @@ recv (
         }
 #endif
     }
-    std::basic_string<MI_Char> methodName;
+    MI_Char const* methodName = NULL;
     if (socket_wrapper::SUCCESS == rval &&
+        !useOrdinals &&
         protocol::MI_METHOD_FLAG == (protocol::MI_METHOD_FLAG & flags))
     {
         INSTANCE_BOOKEND ("recv method name");
-        rval = recv (&methodName, sock);
+        rval = copies.recv (&methodName, sock);
 #if (PRINT_RECV_INSTANCE)
         if (socket_wrapper::SUCCESS == rval)
         {
-            strm << "method name: \"" << methodName << "\"";
+            strm << "method name: \"" << (methodName ? methodName : "") << "\"";
             INSTANCE_PRINT (strm.str ());
             strm.str ("");
             strm.clear ();
@@ -1201,8 +1494,40 @@ recv (
         {
             Value value;
             INSTANCE_BOOKEND ("recv value");
-            INSTANCE_PRINT ("recv key");
-            rval = recv (&(value.key), sock);
+            if (useOrdinals)
+            {
+                INSTANCE_PRINT ("recv index");
+                rval = recv (&(value.index), sock);
+                if (socket_wrapper::SUCCESS == rval)
+                {
+                    if (NULL != pMethodDecl &&
+                        value.index < pMethodDecl->numParameters)
+                    {
+                        value.key = pMethodDecl->parameters[value.index]->name;
+                    }
+                    else if (NULL == pMethodDecl &&
+                             value.index < pClassDecl->numProperties)
+                    {
+                        value.key = pClassDecl->properties[value.index]->name;
+                    }
+                    else
+                    {
+                        INSTANCE_PRINT ("index out of range");
+                        rval = EXIT_FAILURE;
+                    }
+                }
+            }
+            else
+            {
+                INSTANCE_PRINT ("recv key");
+                rval = copies.recv (&(value.key), sock);
+                if (socket_wrapper::SUCCESS == rval &&
+                    NULL == value.key)
+                {
+                    INSTANCE_PRINT ("key is empty");
+                    rval = EXIT_FAILURE;
+                }
+            }
 #if (PRINT_RECV_INSTANCE)
             if (socket_wrapper::SUCCESS == rval)
             {
@@ -1234,11 +1559,36 @@ recv (
                 }
 #endif
             }
-            if (socket_wrapper::SUCCESS == rval)
+            if (socket_wrapper::SUCCESS == rval &&
+                MI_NULL_FLAG == (MI_NULL_FLAG & value.type))
+            {
+                // only a delta removes values, and no value follows
+                value.type &= ~MI_NULL_FLAG;
+                value.cleared = true;
+                if (isDelta)
+                {
+                    values.push_back (value);
+                }
+                else
+                {
+                    INSTANCE_PRINT ("unexpected removed value");
+                    rval = EXIT_FAILURE;
+                }
+            }
+            else if (socket_wrapper::SUCCESS == rval)
             {
                 INSTANCE_PRINT ("recv value");
-                rval = ::recv (&(value.value), value.type, pContext,
-                               pSchemaDecl, sock);
+                if (MI_STRING == value.type)
+                {
+                    MI_Char const* pString = NULL;
+                    rval = copies.recv (&pString, sock);
+                    value.value.string = const_cast<MI_Char*>(pString);
+                }
+                else
+                {
+                    rval = ::recv (&(value.value), value.type, pContext,
+                                   pIndex, sock);
+                }
                 if (socket_wrapper::SUCCESS == rval)
                 {
                     INSTANCE_PRINT ("recv value SUCCEEDED");
@@ -1257,14 +1607,18 @@ recv (
     {
         if (pSchemaDecl)
         {
-            MI_ClassDecl const* pClassDecl = findClassDecl (
-                className.c_str (), pSchemaDecl);
-            MI_MethodDecl const* pMethodDecl = NULL;
-            if (protocol::MI_METHOD_FLAG == (protocol::MI_METHOD_FLAG & flags) &&
+            if (!useOrdinals)
+            {
+                pClassDecl = className ?
+                    pIndex->findClassDecl (className) : NULL;
+            }
+            if (!useOrdinals &&
+                protocol::MI_METHOD_FLAG == (protocol::MI_METHOD_FLAG & flags) &&
                 pClassDecl)
             {
                 // find the method decl in pClassDecl
-                pMethodDecl = findMethodDecl (methodName.c_str (), pClassDecl);
+                pMethodDecl = methodName ?
+                    pIndex->findMethodDecl (pClassDecl, methodName) : NULL;
 #if (PRINT_RECV_INSTANCE)
                 if (pMethodDecl)
                 {
@@ -1286,7 +1640,21 @@ recv (
             }
             MI_Instance* pNewInstance = NULL;
             MI_Result result = MI_RESULT_FAILED;
-            if (pMethodDecl)
+            if (isDelta)
+            {
+                // the values are applied to the template in place
+                pNewInstance = pTemplates->get (classOrdinal);
+                if (pNewInstance)
+                {
+                    result = MI_RESULT_OK;
+                }
+                else
+                {
+                    INSTANCE_PRINT ("delta without a template");
+                    rval = EXIT_FAILURE;
+                }
+            }
+            else if (pMethodDecl)
             {
                 INSTANCE_BOOKEND ("MI_Context_NewParameters");
                 result = MI_Context_NewParameters (
@@ -1337,6 +1705,25 @@ recv (
                 INSTANCE_PRINT ("MI_Instance declaration was not found");
                 rval = EXIT_FAILURE;
             }
+            if (MI_RESULT_OK == result &&
+                isDelta)
+            {
+                // check the whole delta before any of it is applied to the
+                // template
+                for (std::vector<Value>::const_iterator pos = values.begin (),
+                         endPos = values.end ();
+                     pos != endPos &&
+                         MI_RESULT_OK == result;
+                     ++pos)
+                {
+                    if (pos->type != pClassDecl->properties[pos->index]->type)
+                    {
+                        INSTANCE_PRINT ("delta type mismatch");
+                        result = MI_RESULT_TYPE_MISMATCH;
+                        rval = EXIT_FAILURE;
+                    }
+                }
+            }
             if (MI_RESULT_OK == result)
             {
                 INSTANCE_PRINT ("MI_Instance was created");
@@ -1362,19 +1749,47 @@ recv (
                         INSTANCE_PRINT ("pNewInstance is NULL");
                     }
 #endif // PRINT_RECV_INSTANCE
+                    MI_Char const* name = NULL;
                     MI_Value value;
                     MI_Type tempType;
-                    result = MI_Instance_GetElement (
-                        pNewInstance, pos->key.c_str (), &value, &tempType,
-                        NULL, NULL);
+                    // an instance has an element for each property of its
+                    // declaration in the same order, so an ordinal is the
+                    // element's index
+                    result = protocol::NO_ORDINAL != pos->index ?
+                        MI_Instance_GetElementAt (
+                            pNewInstance, pos->index, &name, &value,
+                            &tempType, NULL) :
+                        MI_Instance_GetElement (
+                            pNewInstance, pos->key, &value, &tempType,
+                            NULL, NULL);
                     INSTANCE_PRINT ("mark 1");
                     if (MI_RESULT_OK == result &&
                         pos->type == tempType)
                     {
                         INSTANCE_PRINT ("GetElement succeeded");
-                        result = MI_Instance_SetElement (
-                            pNewInstance, pos->key.c_str (), &(pos->value),
-                            static_cast<MI_Type>(pos->type), 0);
+                        // a string is lent to the instance rather than
+                        // copied again, the message it lies in outlives the
+                        // instance; a template outlives the message
+                        MI_Uint32 const elementFlags =
+                            MI_STRING == pos->type && !isTemplate ?
+                                MI_FLAG_BORROW : 0;
+                        if (pos->cleared)
+                        {
+                            result = MI_Instance_ClearElementAt (
+                                pNewInstance, pos->index);
+                        }
+                        else
+                        {
+                            result = protocol::NO_ORDINAL != pos->index ?
+                                MI_Instance_SetElementAt (
+                                    pNewInstance, pos->index, &(pos->value),
+                                    static_cast<MI_Type>(pos->type),
+                                    elementFlags) :
+                                MI_Instance_SetElement (
+                                    pNewInstance, pos->key, &(pos->value),
+                                    static_cast<MI_Type>(pos->type),
+                                    elementFlags);
+                        }
 #if (PRINT_RECV_INSTANCE)
                         if (MI_RESULT_OK == result)
                         {
@@ -1401,13 +1816,20 @@ recv (
                 if (MI_RESULT_OK == result)
                 {
                     INSTANCE_PRINT ("recv MI_Instance succeeded");
+                    if (isTemplate)
+                    {
+                        pTemplates->set (classOrdinal, pNewInstance);
+                    }
                     *ppInstanceOut = pNewInstance;
                 }
                 else
                 {
-                    // error
+                    // error: a delta's template is dropped below
                     INSTANCE_PRINT ("recv MI_Instance failed");
-                    MI_Instance_Delete (pNewInstance);
+                    if (!isDelta)
+                    {
+                        MI_Instance_Delete (pNewInstance);
+                    }
                     rval = EXIT_FAILURE;
                 }
             }
@@ -1419,6 +1841,15 @@ recv (
             rval = EXIT_FAILURE;
         }
     }
+    if (socket_wrapper::SUCCESS != rval &&
+        isTemplate &&
+        NULL != pTemplates)
+    {
+        // the client's template for the class moved on with this message
+        // whether or not it could be decoded, so the one here is stale and
+        // the deltas that follow must not be applied to it
+        pTemplates->erase (classOrdinal);
+    }
     for (std::vector<Value>::iterator pos = values.begin (),
              endPos = values.end ();
          pos != endPos;
@@ -1437,7 +1868,8 @@ recv (
             delete[] pos->value.instancea.data;
             pos->value.instancea.data = NULL;
         }
-        else
+        else if (MI_STRING != pos->type &&
+                 !pos->cleared)
         {
             MI_Destroy (pos->value, static_cast<MI_Type>(pos->type));
         }
@@ -2783,4 +3215,105 @@ send (
 }
 
 
+int
+recv_post_instance (
+    MI_Context* const pContext,
+    schema_index const* const pIndex,
+    MI_Filter const* const pFilter,
+    request_state* const pState,
+    socket_wrapper& sock)
+{
+    SCX_BOOKEND ("protocol::recv_post_instance");
+    int rval = socket_wrapper::SUCCESS;
+    MI_Instance* pInstance = NULL;
+    if (NULL == pContext)
+    {
+        // the pool starts and stops workers without a context, there is
+        // nowhere to post an instance to
+        SCX_BOOKEND_PRINT ("POST_INSTANCE without a context");
+        rval = socket_wrapper::RECV_FAILED;
+    }
+    else if (socket_wrapper::SUCCESS == (
+                 rval = (recv (&pInstance, pContext, pIndex, sock,
+                               &(pState->templates)))))
+    {
+        //SCX_BOOKEND_PRINT ("recv instance succeeded");
+        MI_Boolean post = MI_TRUE;
+        if (NULL != pFilter)
+        {
+            if (MI_RESULT_OK == MI_Filter_Evaluate (pFilter, pInstance, &post))
+            {
+                if (MI_FALSE == post)
+                {
+                    //SCX_BOOKEND_PRINT ("Filtered out");
+                }
+            }
+            else
+            {
+                //SCX_BOOKEND_PRINT ("MI_Filter_Evaluate failed");
+                post = MI_FALSE;
+            }
+        }
+        if (MI_FALSE != post)
+        {
+            if (MI_RESULT_OK == MI_Context_PostInstance (pContext, pInstance))
+            {
+                //SCX_BOOKEND_PRINT ("PostInstance succeeded");
+            }
+            else
+            {
+                //SCX_BOOKEND_PRINT ("PostInstance failed");
+            }
+        }
+        if (!pState->templates.owns (pInstance))
+        {
+            MI_Instance_Delete (pInstance);
+        }
+    }
+    if (socket_wrapper::SUCCESS != rval)
+    {
+        // the client believes the instance was posted, the request's result
+        // has to say that it wasn't
+        SCX_BOOKEND_PRINT ("dropped an instance");
+        pState->dropped = true;
+    }
+    return rval;
+}
+
+
+int
+recv_post_result (
+    MI_Context* const pContext,
+    MI_Result* const pResultOut,
+    request_state const& state,
+    socket_wrapper& sock)
+{
+    SCX_BOOKEND ("protocol::recv_post_result");
+    MI_Result result;
+    int rval = recv (&result, sock);
+    if (socket_wrapper::SUCCESS == rval)
+    {
+        SCX_BOOKEND_PRINT ("rec'd result");
+        if (state.dropped &&
+            MI_RESULT_OK == result)
+        {
+            result = MI_RESULT_FAILED;
+        }
+        if (NULL != pResultOut)
+        {
+            *pResultOut = result;
+        }
+        else
+        {
+            MI_Context_PostResult (pContext, result);
+        }
+    }
+    else
+    {
+        SCX_BOOKEND_PRINT ("recv result failed");
+    }
+    return rval;
+}
+
+
 } // namespace protocol
@@ -8,16 +8,64 @@
 #include "shared_protocol.hpp"
 
 
+#include <map>
+
+
 namespace protocol
 {
 
 
+// instance_templates holds the last instance of each class that a request
+// posted, by class ordinal, so that the next one can be sent as the values
+// that changed (see MI_DELTA_FLAG).  It owns the instances it holds.
+class instance_templates
+{
+public:
+    /*ctor*/ instance_templates ();
+    /*dtor*/ ~instance_templates ();
+
+    // NULL if there is none for the class
+    MI_Instance* get (MI_Uint32 const& classOrdinal) const;
+    // takes ownership of pInstance, replacing any template the class had
+    void set (MI_Uint32 const& classOrdinal, MI_Instance* const pInstance);
+    void erase (MI_Uint32 const& classOrdinal);
+
+    bool owns (MI_Instance const* const pInstance) const;
+
+private:
+    typedef std::map<MI_Uint32, MI_Instance*> template_map_t;
+
+    /*ctor*/ instance_templates (instance_templates const&); // = delete
+    instance_templates& operator = (instance_templates const&); // = delete
+
+    template_map_t m_Templates;
+};
+
+
+// request_state is what the messages a client posts for one request leave
+// for the ones after them: the templates its deltas apply to, and whether
+// any of its instances was dropped because it failed to decode.
+struct request_state
+{
+    /*ctor*/ request_state ();
+
+    instance_templates templates;
+    bool dropped;
+};
+
+
+// String properties of the new instance may be borrowed from the message
+// being decoded (see protocol::recv_in_place), so the instance must be
+// finished with before the next message is received.  An instance sent as a
+// template or a delta is kept in pTemplates instead, and is returned without
+// borrowed strings; the caller must not delete it.
 int
 recv (
     MI_Instance** const ppInstanceOut,
     MI_Context* const pContext,
-    MI_SchemaDecl const* const pSchema,
-    socket_wrapper& sock);
+    schema_index const* const pIndex,
+    socket_wrapper& sock,
+    instance_templates* const pTemplates = NULL);
 
 
 int
@@ -74,6 +122,29 @@ send (
     socket_wrapper& sock);
 
 
+// recv_post_instance receives the instance of a POST_INSTANCE and posts it to
+// pContext unless pFilter filters it out.  An instance that fails to decode
+// is marked dropped in pState.
+int
+recv_post_instance (
+    MI_Context* const pContext,
+    schema_index const* const pIndex,
+    MI_Filter const* const pFilter,
+    request_state* const pState,
+    socket_wrapper& sock);
+
+
+// recv_post_result receives the result of a POST_RESULT and stores it in
+// pResultOut, or posts it to pContext when pResultOut is NULL.  A request that
+// dropped an instance fails, whatever result the client sent.
+int
+recv_post_result (
+    MI_Context* const pContext,
+    MI_Result* const pResultOut,
+    request_state const& state,
+    socket_wrapper& sock);
+
+
 } // namespace protocol
 
 
@@ -64,9 +64,11 @@ send (
         if (socket_wrapper::SUCCESS == rval &&
             0 < nStrLen)
         {
+            // the terminator is sent so recv_in_place can use the string
+            // where it lies in the receive buffer
             rval = sock.send (
                 reinterpret_cast<socket_wrapper::byte_t const*>(str),
-                nStrLen);
+                (nStrLen + 1) * sizeof (MI_Char));
         }
     }
     else
@@ -152,11 +154,16 @@ recv (
         if (NULL_STRING != count &&
             0 != count)
         {
-            pText.reset (new MI_Char[count +1]);
-            pText[count] = '\0';
+            pText.reset (new MI_Char[count + 1]);
             rval = sock.recv (
                 reinterpret_cast<socket_wrapper::byte_t*>(pText.get ()),
-                count * sizeof (MI_Char));
+                (count + 1) * sizeof (MI_Char));
+            if (socket_wrapper::SUCCESS == rval &&
+                '\0' != pText[count])
+            {
+                RECV_STR_PRINT ("string is not terminated");
+                rval = socket_wrapper::RECV_FAILED;
+            }
 #if (PRINT_RECV_STR)
             if (socket_wrapper::SUCCESS == rval)
             {
@@ -195,6 +202,60 @@ recv (
 }
 
 
+int
+recv_in_place (
+    MI_Char const** const ppStringOut,
+    util::unique_ptr<MI_Char[]>* const pCopyOut,
+    socket_wrapper& sock)
+{
+    RECV_STR_BOOKEND ("protocol::recv_in_place (MI_Char const**)");
+    assert (ppStringOut);
+    assert (pCopyOut);
+    int rval = socket_wrapper::SUCCESS;
+    if (sock.canRecvInPlace ())
+    {
+        item_count_t count;
+        rval = recv_item_count (&count, sock);
+        if (socket_wrapper::SUCCESS == rval)
+        {
+            MI_Char const* pText = NULL;
+            if (NULL_STRING != count &&
+                0 != count)
+            {
+                socket_wrapper::byte_t const* pData = NULL;
+                size_t const nBytes =
+                    (static_cast<size_t>(count) + 1) * sizeof (MI_Char);
+                rval = sock.recvInPlace (&pData, nBytes);
+                if (socket_wrapper::SUCCESS == rval)
+                {
+                    pText = reinterpret_cast<MI_Char const*>(pData);
+                    if ('\0' != pText[count])
+                    {
+                        RECV_STR_PRINT ("string is not terminated");
+                        rval = socket_wrapper::RECV_FAILED;
+                    }
+                }
+            }
+            if (socket_wrapper::SUCCESS == rval)
+            {
+                *ppStringOut = pText;
+            }
+        }
+    }
+    else
+    {
+        MI_Char* pText = NULL;
+        rval = recv (&pText, sock);
+        if (socket_wrapper::SUCCESS == rval)
+        {
+            pCopyOut->reset (pText);
+            *ppStringOut = pText;
+        }
+    }
+    return rval;
+}
+
+
 #if (0)
 #define PRINT_RECV_DATETIME (PRINT_BOOKENDS)
 #else
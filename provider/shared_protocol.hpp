@@ -24,6 +24,9 @@ namespace protocol
 //------------------------------------------------------------------------------
 typedef unsigned char boolean_t;
 typedef MI_Uint32 opcode_t;
+// every message carries the id of the request it belongs to, so replies to
+// requests that are running at the same time can be told apart
+typedef MI_Uint32 request_id_t;
 typedef unsigned int item_count_t;
 typedef unsigned char data_type_t;
 
@@ -31,9 +34,21 @@ typedef unsigned char data_type_t;
 // constants to define NULL
 //------------------------------------------------------------------------------
 data_type_t const MI_NULL_FLAG = 64;
+// a string is sent as its length followed by its characters and the
+// terminator, or as NULL_STRING
 unsigned int const NULL_STRING = 0xFFFFFFFF;
 unsigned int const NULL_COUNT = 0xFFFFFFFF;
 unsigned int const MI_METHOD_FLAG = 0x01;
+// the instance names its class (and method) and its values by their index in
+// the schema both sides share instead of by name
+unsigned int const MI_ORDINAL_FLAG = 0x02;
+MI_Uint32 const NO_ORDINAL = 0xFFFFFFFF;
+// the instance replaces the request's template for its class
+unsigned int const MI_TEMPLATE_FLAG = 0x04;
+// the instance is sent as the values that differ from the request's
+// template for its class, a value that was removed is sent as its ordinal
+// and its type with MI_NULL_FLAG set; implies MI_TEMPLATE_FLAG
+unsigned int const MI_DELTA_FLAG = 0x08;
 
 
 // constants for function table
@@ -65,6 +80,13 @@ static MI_Uint32 const INVOKE = 15;
 static MI_Uint32 const POST_RESULT = 50;
 static MI_Uint32 const POST_INSTANCE = 51;
 static MI_Uint32 const POST_INDICATION = 52;
+// POST_INSTANCE records are waiting in the shared ring, each record is the
+// id of the request it belongs to followed by the instance; the message's
+// own request id is not used
+static MI_Uint32 const POST_RING = 53;
+// a count followed by that many instances, each one is handled as though
+// it had been sent by POST_INSTANCE
+static MI_Uint32 const POST_INSTANCES = 54;
 
 static MI_Uint32 const HAS_INSTANCE_FLAG = 1 << 0;
 static MI_Uint32 const HAS_INPUT_PARAMETERS_FLAG = 1 << 2;
@@ -109,10 +131,24 @@ send_type (
 inline int
 send_opcode (
     opcode_t const& opcode,
+    request_id_t const& requestID,
     socket_wrapper& sock)
 {
-    return sock.send (reinterpret_cast<socket_wrapper::byte_t const*>(&opcode),
-                      sizeof (opcode_t));
+    // an opcode and the id of the request start a message
+    int rval = sock.beginSendMessage ();
+    if (socket_wrapper::SUCCESS == rval)
+    {
+        rval = sock.send (
+            reinterpret_cast<socket_wrapper::byte_t const*>(&opcode),
+            sizeof (opcode_t));
+    }
+    if (socket_wrapper::SUCCESS == rval)
+    {
+        rval = sock.send (
+            reinterpret_cast<socket_wrapper::byte_t const*>(&requestID),
+            sizeof (request_id_t));
+    }
+    return rval;
 }
 
 
@@ -140,11 +176,13 @@ send (
     //SCX_BOOKEND ("protocol::send (std::basic_string)");
     item_count_t const len = text.size ();
     int rval = send_item_count (len, sock);
-    if (socket_wrapper::SUCCESS == rval)
+    if (socket_wrapper::SUCCESS == rval &&
+        0 < len)
     {
+        // send the terminator as well (see send (MI_Char const*))
         rval = sock.send (
             reinterpret_cast<socket_wrapper::byte_t const*>(text.c_str ()),
-            len * sizeof (char_t));
+            (len + 1) * sizeof (char_t));
     }
     return rval;
 }
@@ -169,6 +207,26 @@ send (
 }
 
 
+// send a block of fixed size items (the numeric types and MI_Char16) with
+// one call; the items go over the wire exactly as they would one at a time
+template<typename T>
+int
+send_items (
+    T const* const pItems,
+    item_count_t const& count,
+    socket_wrapper& sock)
+{
+    int rval = socket_wrapper::SUCCESS;
+    if (0 < count)
+    {
+        rval = sock.send (
+            reinterpret_cast<socket_wrapper::byte_t const*>(pItems),
+            count * sizeof (T));
+    }
+    return rval;
+}
+
+
 inline int
 recv_item_count (
     item_count_t* pCountOut,
@@ -200,10 +258,23 @@ recv_type (
 inline int
 recv_opcode (
     opcode_t* const pOpcodeOut,
+    request_id_t* const pRequestIDOut,
     socket_wrapper& sock)
 {
-    return sock.recv (reinterpret_cast<socket_wrapper::byte_t*>(pOpcodeOut),
-                      sizeof (opcode_t));
+    // an opcode and the id of the request start a message
+    int rval = sock.beginRecvMessage ();
+    if (socket_wrapper::SUCCESS == rval)
+    {
+        rval = sock.recv (reinterpret_cast<socket_wrapper::byte_t*>(pOpcodeOut),
+                          sizeof (opcode_t));
+    }
+    if (socket_wrapper::SUCCESS == rval)
+    {
+        rval = sock.recv (
+            reinterpret_cast<socket_wrapper::byte_t*>(pRequestIDOut),
+            sizeof (request_id_t));
+    }
+    return rval;
 }
 
 
@@ -213,6 +284,18 @@ recv (
     socket_wrapper& sock);
 
 
+// recv a string without copying it out of the message when the socket holds
+// the message in memory (see socket_wrapper::recvInPlace); *ppStringOut
+// then points into the message.  Otherwise the string is copied into
+// *pCopyOut and *ppStringOut points at the copy.  An empty string is
+// returned as NULL, the same as recv (MI_Char**).
+EXPORT_PUBLIC int
+recv_in_place (
+    MI_Char const** const ppStringOut,
+    util::unique_ptr<MI_Char[]>* const pCopyOut,
+    socket_wrapper& sock);
+
+
 template<typename char_t, typename traits>
 int
 recv (
@@ -221,9 +304,9 @@ recv (
 {
     //SCX_BOOKEND ("protocol::recv (std::basic_string)");
     assert (pStringOut);
-    MI_Char* pText = NULL;
-    int rval = recv (&pText, sock);
-    util::unique_ptr<MI_Char[]> holder (pText);
+    MI_Char const* pText = NULL;
+    util::unique_ptr<MI_Char[]> holder;
+    int rval = recv_in_place (&pText, &holder, sock);
     if (socket_wrapper::SUCCESS == rval)
     {
         if (pText)
@@ -259,6 +342,26 @@ recv (
 }
 
 
+// recv a block of fixed size items sent by send_items (or one at a time)
+// straight into pItemsOut
+template<typename T>
+int
+recv_items (
+    T* const pItemsOut,
+    item_count_t const& count,
+    socket_wrapper& sock)
+{
+    int rval = socket_wrapper::SUCCESS;
+    if (0 < count)
+    {
+        rval = sock.recv (
+            reinterpret_cast<socket_wrapper::byte_t*>(pItemsOut),
+            count * sizeof (T));
+    }
+    return rval;
+}
+
+
 } // namespace protocol
 
 
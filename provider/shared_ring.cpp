@@ -0,0 +1,442 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#include "shared_ring.hpp"
+
+
+#include "debug_tags.hpp"
+#include "socket_wrapper.hpp"
+
+
+#include <cassert>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+
+// The mapping is a header page followed by the record area.  head and tail
+// are free running byte counts; the producer only writes head and the
+// consumer only writes tail.  A record is a 32 bit length followed by the
+// data padded to 4 bytes.  Records never wrap, when one doesn't fit at the
+// end of the area a WRAP_MARKER is left for the consumer to skip.
+struct shared_ring::header
+{
+    unsigned int capacity;
+    unsigned int pad0[15];
+    unsigned int head;
+    unsigned int pad1[15];
+    unsigned int tail;
+    unsigned int waiting;
+    unsigned int pad2[14];
+};
+
+
+namespace
+{
+
+
+size_t const HEADER_SIZE = 4096;
+size_t const MIN_CAPACITY = 64 * 1024;
+size_t const MAX_CAPACITY = 1024 * 1024 * 1024;
+unsigned int const WRAP_MARKER = 0xFFFFFFFF;
+long const WAIT_TIMEOUT_NS = 100 * 1000 * 1000;
+
+
+#if defined (SYS_memfd_create) && !defined (MFD_CLOEXEC)
+#define MFD_CLOEXEC 0x0001U
+#endif
+
+
+// the file is close-on-exec, only the client it is meant for is given it
+int
+create_backing_file (
+    size_t const& size)
+{
+    int fd = shared_ring::INVALID_FD;
+#if defined (SYS_memfd_create)
+    fd = static_cast<int>(
+        syscall (SYS_memfd_create, "omi_script_ring", MFD_CLOEXEC));
+#else
+    char path[] = "/dev/shm/omi_script_ring_XXXXXX";
+    fd = mkstemp (path);
+    if (-1 != fd)
+    {
+        unlink (path);
+        fcntl (fd, F_SETFD, FD_CLOEXEC);
+    }
+#endif
+    if (-1 != fd &&
+        0 != ftruncate (fd, static_cast<off_t>(size)))
+    {
+        close (fd);
+        fd = shared_ring::INVALID_FD;
+    }
+    return fd;
+}
+
+
+inline unsigned int
+load_acquire (
+    unsigned int const* pValue)
+{
+    return __atomic_load_n (pValue, __ATOMIC_ACQUIRE);
+}
+
+
+inline void
+futex_wait (
+    unsigned int* pAddr,
+    unsigned int const& value)
+{
+    timespec timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_nsec = WAIT_TIMEOUT_NS;
+    syscall (SYS_futex, pAddr, FUTEX_WAIT, value, &timeout, NULL, 0);
+}
+
+
+inline void
+futex_wake (
+    unsigned int* pAddr)
+{
+    syscall (SYS_futex, pAddr, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+
+bool
+peer_hung_up (
+    int fd)
+{
+    pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLRDHUP;
+    pfd.revents = 0;
+    return 0 < poll (&pfd, 1, 0) &&
+        0 != (pfd.revents & (POLLRDHUP | POLLHUP | POLLERR | POLLNVAL));
+}
+
+
+} // namespace (unnamed)
+
+
+/*static*/ size_t const shared_ring::DEFAULT_CAPACITY;
+/*static*/ int const shared_ring::INVALID_FD;
+
+
+/*static*/ int
+shared_ring::create (
+    size_t const& capacity,
+    Ptr* ppRingOut)
+{
+    SCX_BOOKEND ("shared_ring::create");
+    assert (ppRingOut);
+    int rval = CREATE_FAILED;
+    // the capacity must be a power of 2
+    size_t actualCapacity = MIN_CAPACITY;
+    while (actualCapacity < capacity &&
+           actualCapacity < MAX_CAPACITY)
+    {
+        actualCapacity <<= 1;
+    }
+    size_t mappingSize = HEADER_SIZE + actualCapacity;
+    int fd = create_backing_file (mappingSize);
+    if (INVALID_FD != fd)
+    {
+        void* pMapping = mmap (NULL, mappingSize, PROT_READ | PROT_WRITE,
+                               MAP_SHARED, fd, 0);
+        if (MAP_FAILED != pMapping)
+        {
+            header* pHeader = reinterpret_cast<header*>(pMapping);
+            memset (pHeader, 0, sizeof (header));
+            pHeader->capacity = static_cast<unsigned int>(actualCapacity);
+            ppRingOut->reset (new shared_ring (fd, pMapping, mappingSize));
+            rval = SUCCESS;
+        }
+        else
+        {
+            SCX_BOOKEND_PRINT ("mmap failed");
+            close (fd);
+            rval = MMAP_FAILED;
+        }
+    }
+    else
+    {
+        SCX_BOOKEND_PRINT ("create backing file failed");
+    }
+    return rval;
+}
+
+
+/*static*/ int
+shared_ring::attach (
+    int fd,
+    Ptr* ppRingOut)
+{
+    SCX_BOOKEND ("shared_ring::attach");
+    assert (ppRingOut);
+    int rval = MMAP_FAILED;
+    struct stat info;
+    if (INVALID_FD != fd &&
+        0 == fstat (fd, &info) &&
+        HEADER_SIZE + MIN_CAPACITY <= static_cast<size_t>(info.st_size))
+    {
+        size_t mappingSize = static_cast<size_t>(info.st_size);
+        void* pMapping = mmap (NULL, mappingSize, PROT_READ | PROT_WRITE,
+                               MAP_SHARED, fd, 0);
+        if (MAP_FAILED != pMapping)
+        {
+            header const* pHeader = reinterpret_cast<header const*>(pMapping);
+            size_t capacity = pHeader->capacity;
+            if (HEADER_SIZE + capacity == mappingSize &&
+                0 == (capacity & (capacity - 1)))
+            {
+                ppRingOut->reset (new shared_ring (fd, pMapping, mappingSize));
+                rval = SUCCESS;
+            }
+            else
+            {
+                SCX_BOOKEND_PRINT ("invalid ring header");
+                munmap (pMapping, mappingSize);
+            }
+        }
+        else
+        {
+            SCX_BOOKEND_PRINT ("mmap failed");
+        }
+    }
+    return rval;
+}
+
+
+/*ctor*/
+shared_ring::shared_ring (
+    int fd,
+    void* pMapping,
+    size_t const& mappingSize)
+    : m_FD (fd)
+    , m_pMapping (pMapping)
+    , m_MappingSize (mappingSize)
+    , m_Capacity (mappingSize - HEADER_SIZE)
+    , m_pHeader (reinterpret_cast<header*>(pMapping))
+    , m_pData (reinterpret_cast<byte_t*>(pMapping) + HEADER_SIZE)
+    , m_PeekSize (0)
+    , m_Invalid (false)
+{
+    SCX_BOOKEND ("shared_ring::ctor");
+}
+
+
+/*dtor*/
+shared_ring::~shared_ring ()
+{
+    SCX_BOOKEND ("shared_ring::dtor");
+    munmap (m_pMapping, m_MappingSize);
+    closeFD ();
+}
+
+
+int
+shared_ring::getFD () const
+{
+    return m_FD;
+}
+
+
+void
+shared_ring::closeFD ()
+{
+    if (INVALID_FD != m_FD)
+    {
+        close (m_FD);
+        m_FD = INVALID_FD;
+    }
+}
+
+
+size_t
+shared_ring::getMaxRecordSize () const
+{
+    return m_Capacity / 2 - sizeof (unsigned int);
+}
+
+
+int
+shared_ring::write (
+    byte_t const* const pData,
+    size_t const& nBytes)
+{
+    int rval = SUCCESS;
+    if (getMaxRecordSize () < nBytes)
+    {
+        rval = TOO_LARGE;
+    }
+    else if (!make_space (get_space_needed (nBytes)))
+    {
+        rval = FULL;
+    }
+    else
+    {
+        unsigned int head = m_pHeader->head;
+        byte_t* pRecord = m_pData + (head & (m_Capacity - 1));
+        *reinterpret_cast<unsigned int*>(pRecord) =
+            static_cast<unsigned int>(nBytes);
+        memcpy (pRecord + sizeof (unsigned int), pData, nBytes);
+        __atomic_store_n (
+            &(m_pHeader->head),
+            head + static_cast<unsigned int>(get_space_needed (nBytes)),
+            __ATOMIC_RELEASE);
+    }
+    return rval;
+}
+
+
+int
+shared_ring::waitForSpace (
+    size_t const& nBytes,
+    int peerFD)
+{
+    SCX_BOOKEND ("shared_ring::waitForSpace");
+    int rval = SUCCESS;
+    if (getMaxRecordSize () < nBytes)
+    {
+        rval = TOO_LARGE;
+    }
+    size_t nSpaceNeeded = get_space_needed (nBytes);
+    while (SUCCESS == rval &&
+           !make_space (nSpaceNeeded))
+    {
+        // publish that we are waiting, then check again in case the
+        // consumer freed space before it could see the flag
+        unsigned int tail = load_acquire (&(m_pHeader->tail));
+        __atomic_store_n (&(m_pHeader->waiting), 1, __ATOMIC_SEQ_CST);
+        if (!make_space (nSpaceNeeded))
+        {
+            socket_wrapper::blocking_section blocking;
+            futex_wait (&(m_pHeader->tail), tail);
+        }
+        __atomic_store_n (&(m_pHeader->waiting), 0, __ATOMIC_SEQ_CST);
+        if (peer_hung_up (peerFD))
+        {
+            SCX_BOOKEND_PRINT ("peer hung up");
+            rval = WAIT_FAILED;
+        }
+    }
+    return rval;
+}
+
+
+int
+shared_ring::peek (
+    byte_t const** ppDataOut,
+    size_t* pnBytesOut)
+{
+    assert (ppDataOut);
+    assert (pnBytesOut);
+    int rval = EMPTY;
+    unsigned int const capacity = static_cast<unsigned int>(m_Capacity);
+    unsigned int tail = m_pHeader->tail;
+    unsigned int head = load_acquire (&(m_pHeader->head));
+    // head and tail only ever move by multiples of 4, so the length of a
+    // record can't run past the end of the area
+    if (m_Invalid ||
+        capacity < head - tail ||
+        0 != ((head | tail) & 3))
+    {
+        rval = INVALID_RECORD;
+    }
+    while (EMPTY == rval &&
+           tail != head)
+    {
+        unsigned int const nUsed = head - tail;
+        unsigned int const pos = tail & (capacity - 1);
+        unsigned int const nToEnd = capacity - pos;
+        unsigned int const length =
+            *reinterpret_cast<unsigned int const*>(m_pData + pos);
+        if (WRAP_MARKER == length &&
+            nToEnd <= nUsed)
+        {
+            // skip to the start of the area
+            tail += nToEnd;
+            __atomic_store_n (&(m_pHeader->tail), tail, __ATOMIC_SEQ_CST);
+            if (0 != __atomic_load_n (&(m_pHeader->waiting),
+                                      __ATOMIC_SEQ_CST))
+            {
+                futex_wake (&(m_pHeader->tail));
+            }
+        }
+        else if (WRAP_MARKER != length &&
+                 length <= nToEnd - sizeof (unsigned int) &&
+                 get_space_needed (length) <= nUsed)
+        {
+            *ppDataOut = m_pData + pos + sizeof (unsigned int);
+            *pnBytesOut = length;
+            m_PeekSize = get_space_needed (length);
+            rval = SUCCESS;
+        }
+        else
+        {
+            rval = INVALID_RECORD;
+        }
+    }
+    m_Invalid = INVALID_RECORD == rval;
+    return rval;
+}
+
+
+void
+shared_ring::consume ()
+{
+    if (0 < m_PeekSize)
+    {
+        __atomic_store_n (
+            &(m_pHeader->tail),
+            m_pHeader->tail + static_cast<unsigned int>(m_PeekSize),
+            __ATOMIC_SEQ_CST);
+        m_PeekSize = 0;
+        if (0 != __atomic_load_n (&(m_pHeader->waiting), __ATOMIC_SEQ_CST))
+        {
+            futex_wake (&(m_pHeader->tail));
+        }
+    }
+}
+
+
+size_t
+shared_ring::get_space_needed (
+    size_t const& nBytes) const
+{
+    return sizeof (unsigned int) + ((nBytes + 3) & ~static_cast<size_t>(3));
+}
+
+
+bool
+shared_ring::make_space (
+    size_t const& nSpaceNeeded)
+{
+    // called by the producer only: if the record won't fit before the end of
+    // the area, the area up to the end is given up with a WRAP_MARKER as
+    // soon as it is free
+    unsigned int const capacity = m_pHeader->capacity;
+    unsigned int head = m_pHeader->head;
+    size_t nFree = capacity - (head - load_acquire (&(m_pHeader->tail)));
+    size_t pos = head & (capacity - 1);
+    size_t nToEnd = capacity - pos;
+    if (nSpaceNeeded > nToEnd &&
+        nFree >= nToEnd)
+    {
+        *reinterpret_cast<unsigned int*>(m_pData + pos) = WRAP_MARKER;
+        __atomic_store_n (&(m_pHeader->head),
+                          head + static_cast<unsigned int>(nToEnd),
+                          __ATOMIC_RELEASE);
+        nFree -= nToEnd;
+        nToEnd = capacity;
+    }
+    return nSpaceNeeded <= nToEnd &&
+        nSpaceNeeded <= nFree;
+}
@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#ifndef INCLUDED_SHARED_RING_HPP
+#define INCLUDED_SHARED_RING_HPP
+
+
+#include "internal_counted_ptr.hpp"
+
+
+#include <cstdlib>
+
+
+#define EXPORT_PUBLIC __attribute__ ((visibility ("default")))
+
+
+// shared_ring is a single producer / single consumer queue of variable
+// length records in a memory mapping shared by the server and the client.
+//
+// The client (producer) writes records and the server (consumer) reads
+// them in place.  Neither side makes a system call unless the producer
+// finds the ring full, in which case it sleeps on a futex until the
+// consumer frees space.
+class EXPORT_PUBLIC shared_ring : public util::ref_counted_obj
+{
+public:
+    typedef util::internal_counted_ptr<shared_ring> Ptr;
+
+    enum Result
+    {
+        SUCCESS = EXIT_SUCCESS,
+        CREATE_FAILED,
+        MMAP_FAILED,
+        FULL,
+        EMPTY,
+        TOO_LARGE,
+        WAIT_FAILED,
+        INVALID_RECORD,
+    };
+
+    typedef unsigned char byte_t;
+
+    static size_t const DEFAULT_CAPACITY = 4 * 1024 * 1024;
+
+
+    // create a new ring backed by an anonymous file (for the server)
+    EXPORT_PUBLIC static int create (
+        size_t const& capacity,
+        Ptr* ppRingOut);
+    // map the ring backed by the file fd (for the client)
+    EXPORT_PUBLIC static int attach (
+        int fd,
+        Ptr* ppRingOut);
+
+    EXPORT_PUBLIC /*dtor*/ ~shared_ring ();
+
+    // the file backing the ring, INVALID_FD once closed
+    EXPORT_PUBLIC int getFD () const;
+    EXPORT_PUBLIC void closeFD ();
+
+    // the largest record write will accept
+    EXPORT_PUBLIC size_t getMaxRecordSize () const;
+
+    // producer: returns FULL if there is not enough free space
+    EXPORT_PUBLIC int write (byte_t const* const pData, size_t const& nBytes);
+    // producer: block until a record of nBytes fits or the peer on peerFD
+    // hangs up
+    EXPORT_PUBLIC int waitForSpace (size_t const& nBytes, int peerFD);
+
+    // consumer: returns EMPTY if there are no records; the record stays
+    // valid until consume is called.  The producer can write anything to
+    // the mapping, so a record that doesn't fit in the used part of the ring
+    // returns INVALID_RECORD, as does every peek after it.
+    EXPORT_PUBLIC int peek (byte_t const** ppDataOut, size_t* pnBytesOut);
+    EXPORT_PUBLIC void consume ();
+
+    static int const INVALID_FD = -1;
+
+private:
+    struct header;
+
+    /*ctor*/ shared_ring (int fd, void* pMapping, size_t const& mappingSize);
+
+    /*ctor*/ shared_ring (shared_ring const&); // = delete
+    shared_ring& operator = (shared_ring const&); // = delete
+
+    size_t get_space_needed (size_t const& nBytes) const;
+    bool make_space (size_t const& nSpaceNeeded);
+
+    int m_FD;
+    void* const m_pMapping;
+    size_t const m_MappingSize;
+    // kept out of the mapping where the peer can't change it
+    size_t const m_Capacity;
+    header* const m_pHeader;
+    byte_t* const m_pData;
+    size_t m_PeekSize;
+    bool m_Invalid;
+};
+
+
+#undef EXPORT_PUBLIC
+
+
+#endif // INCLUDED_SHARED_RING_HPP
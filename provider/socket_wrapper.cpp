@@ -7,6 +7,8 @@
 #include "server.hpp"
 
 
+#include <cassert>
+#include <cstring>
 #include <errno.h>
 #include <fcntl.h>
 #include <sstream>
@@ -18,15 +20,109 @@ namespace
 {
 
 
+size_t const NO_FRAME = static_cast<size_t>(-1);
+
+
+socket_wrapper::begin_blocking_fn g_pBeginBlocking = NULL;
+socket_wrapper::end_blocking_fn g_pEndBlocking = NULL;
+
+
+}
+
+
+/*static*/ size_t const socket_wrapper::BUFFER_SIZE;
+/*static*/ size_t const socket_wrapper::MAX_FRAME_SIZE;
+
+
+/*static*/ void
+socket_wrapper::setBlockingHooks (
+    begin_blocking_fn const pBegin,
+    end_blocking_fn const pEnd)
+{
+    g_pBeginBlocking = pBegin;
+    g_pEndBlocking = pEnd;
+}
+
+
+/*ctor*/
+socket_wrapper::blocking_section::blocking_section ()
+    : m_pState (g_pBeginBlocking ? g_pBeginBlocking () : NULL)
+{
+    // empty
+}
+
+
+/*dtor*/
+socket_wrapper::blocking_section::~blocking_section ()
+{
+    if (g_pEndBlocking)
+    {
+        // the caller checks errno after the section ends
+        int const error = errno;
+        g_pEndBlocking (m_pState);
+        errno = error;
+    }
 }
 
 
 /*ctor*/
 socket_wrapper::socket_wrapper (
-    int fd)
+    int fd,
+    unsigned int const& mode)
     : m_FD (fd)
+    , m_Mode (mode)
+    , m_SendFrameStart (NO_FRAME)
+    , m_RecvPos (0)
+    , m_RecvLen (0)
+    , m_InRecvFrame (false)
+    , m_pRecvSource (NULL)
+    , m_RecvSourcePos (0)
+    , m_RecvSourceLen (0)
+    , m_pSendTarget (NULL)
 {
     SCX_BOOKEND ("socket_wrapper::ctor");
+    if (BUFFERED == (m_Mode & BUFFERED))
+    {
+        m_SendBuffer.reserve (BUFFER_SIZE);
+        m_RecvBuffer.resize (BUFFER_SIZE);
+    }
+}
+
+
+/*ctor*/
+socket_wrapper::socket_wrapper (
+    byte_t const* const pData,
+    size_t const& nBytes)
+    : m_FD (INVALID_SOCKET)
+    , m_Mode (UNBUFFERED)
+    , m_SendFrameStart (NO_FRAME)
+    , m_RecvPos (0)
+    , m_RecvLen (0)
+    , m_InRecvFrame (false)
+    , m_pRecvSource (pData)
+    , m_RecvSourcePos (0)
+    , m_RecvSourceLen (nBytes)
+    , m_pSendTarget (NULL)
+{
+    //SCX_BOOKEND ("socket_wrapper::ctor (memory source)");
+}
+
+
+/*ctor*/
+socket_wrapper::socket_wrapper (
+    std::vector<byte_t>* const pBuffer)
+    : m_FD (INVALID_SOCKET)
+    , m_Mode (UNBUFFERED)
+    , m_SendFrameStart (NO_FRAME)
+    , m_RecvPos (0)
+    , m_RecvLen (0)
+    , m_InRecvFrame (false)
+    , m_pRecvSource (NULL)
+    , m_RecvSourcePos (0)
+    , m_RecvSourceLen (0)
+    , m_pSendTarget (pBuffer)
+{
+    //SCX_BOOKEND ("socket_wrapper::ctor (memory target)");
 }
 
 
@@ -36,6 +132,7 @@ socket_wrapper::~socket_wrapper ()
     SCX_BOOKEND ("socket_wrapper::dtor");
     if (INVALID_SOCKET != m_FD)
     {
+        flush ();
         close ();
     }
 }
@@ -48,34 +145,49 @@ socket_wrapper::send (
 {
     //SCX_BOOKEND ("socket_wrapper::send");
     int rval = SUCCESS;
-    if (INVALID_SOCKET != m_FD)
+    if (NULL != m_pSendTarget)
+    {
+        m_pSendTarget->insert (m_pSendTarget->end (), pData, pData + nBytes);
+    }
+    else if (INVALID_SOCKET != m_FD)
     {
-        ssize_t nBytesSent = 0;
-        while (SUCCESS == rval &&
-               nBytes > static_cast<size_t> (nBytesSent))
+        if (FRAMED == (m_Mode & FRAMED))
         {
-            ssize_t nSent = write (m_FD, pData + nBytesSent,
-                                   nBytes - nBytesSent);
-            if (-1 != nSent)
+            if (NO_FRAME == m_SendFrameStart)
             {
-                nBytesSent += nSent;
+                rval = beginSendMessage ();
             }
-            else if (EINTR != errno)
+            if (SUCCESS == rval)
             {
-                // error (check errno { EACCESS, EAGAIN, EWOULDBLOCK, EBADF,
-                //                      ECONNRESET, EDESTADDRREQ, EFAULT,
-                //                      EINVAL, EISCONN, EMSGSIZE, ENOBUFS,
-                //                      ENOMEM, ENOTCONN, ENOTSOCK, EOPNOTSUPP,
-                //                      EPIPE })
-                close ();
-                rval = SEND_FAILED;
-                std::ostringstream strm;
-                strm << "error on socket: (" << errno << ") \"" << errnoText
-                     << '\"';
-                SCX_BOOKEND_PRINT (strm.str ());
-                std::cerr << strm.str () << std::endl;
+                // a frame is kept whole in the buffer until it is closed
+                m_SendBuffer.insert (m_SendBuffer.end (),
+                                     pData, pData + nBytes);
             }
         }
+        else if (BUFFERED == (m_Mode & BUFFERED))
+        {
+            if (BUFFER_SIZE < m_SendBuffer.size () + nBytes)
+            {
+                rval = write_buffer ();
+            }
+            if (SUCCESS == rval)
+            {
+                if (BUFFER_SIZE > nBytes)
+                {
+                    m_SendBuffer.insert (m_SendBuffer.end (),
+                                         pData, pData + nBytes);
+                }
+                else
+                {
+                    // too big to buffer, bypass the buffer
+                    rval = write_fd (pData, nBytes);
+                }
+            }
+        }
+        else
+        {
+            rval = write_fd (pData, nBytes);
+        }
     }
     else
     {
@@ -93,48 +205,175 @@ socket_wrapper::recv (
 {
     //SCX_BOOKEND ("socket_wrapper::recv");
     int rval = SUCCESS;
-    if (INVALID_SOCKET != m_FD)
+    if (FRAMED == (m_Mode & FRAMED) &&
+        !m_InRecvFrame)
+    {
+        rval = beginRecvMessage ();
+    }
+    if (SUCCESS == rval)
     {
-        ssize_t nBytesRead = 0;
-        while (SUCCESS == rval &&
-               nBytes > static_cast<size_t> (nBytesRead))
+        if (NULL != m_pRecvSource ||
+            m_InRecvFrame)
         {
-            ssize_t nRead = read (m_FD, pDataOut + nBytesRead,
-                                  nBytes - nBytesRead);
-            if (0 < nRead)
-            {
-                nBytesRead += nRead;
-            }
-            else if (0 == nRead)
+            if (m_RecvSourcePos + nBytes <= m_RecvSourceLen)
             {
-                // socket closed
-                close ();
-                rval = SOCKET_CLOSED;
-                SCX_BOOKEND_PRINT ("recv - zero byte read");
+                if (0 < nBytes)
+                {
+                    memcpy (pDataOut, m_pRecvSource + m_RecvSourcePos,
+                            nBytes);
+                    m_RecvSourcePos += nBytes;
+                }
             }
-            else if (EINTR != errno)
+            else
             {
-                // Error - check errno { EAGAIN, EBADF, EFAULT, EINVAL, EIO,
-                //                       EISDIR }
-                close ();
+                SCX_BOOKEND_PRINT ("socket_wrapper::recv past the end");
                 rval = RECV_FAILED;
-                std::ostringstream strm;
-                strm << "error on socket: (" << errno << ") \"" << errnoText
-                     << '\"';
-                SCX_BOOKEND_PRINT (strm.str ());
-                std::cerr << strm.str () << std::endl;
             }
+        }
+        else
+        {
+            rval = recv_stream (pDataOut, nBytes);
+        }
     }
+    return rval;
+}
+
+
+bool
+socket_wrapper::canRecvInPlace () const
+{
+    return NULL != m_pRecvSource ||
+        FRAMED == (m_Mode & FRAMED);
+}
+
+
+int
+socket_wrapper::recvInPlace (
+    byte_t const** const ppDataOut,
+    size_t const& nBytes)
+{
+    assert (ppDataOut);
+    int rval = SUCCESS;
+    if (FRAMED == (m_Mode & FRAMED) &&
+        !m_InRecvFrame)
+    {
+        rval = beginRecvMessage ();
     }
-    else
+    if (SUCCESS == rval)
     {
-        SCX_BOOKEND_PRINT ("socket_wrapper::recv called on closed socket");
-        rval = SOCKET_CLOSED;
+        if ((NULL != m_pRecvSource ||
+             m_InRecvFrame) &&
+            m_RecvSourcePos + nBytes <= m_RecvSourceLen)
+        {
+            *ppDataOut = m_pRecvSource + m_RecvSourcePos;
+            m_RecvSourcePos += nBytes;
+        }
+        else
+        {
+            SCX_BOOKEND_PRINT ("socket_wrapper::recvInPlace failed");
+            rval = RECV_FAILED;
+        }
     }
     return rval;
 }
 
 
+int
+socket_wrapper::beginSendMessage ()
+{
+    int rval = SUCCESS;
+    if (FRAMED == (m_Mode & FRAMED))
+    {
+        close_send_frame ();
+        if (BUFFER_SIZE <= m_SendBuffer.size ())
+        {
+            rval = write_buffer ();
+        }
+        if (SUCCESS == rval)
+        {
+            // reserve the length prefix, it is filled in by close_send_frame
+            m_SendFrameStart = m_SendBuffer.size ();
+            m_SendBuffer.resize (m_SendFrameStart + sizeof (frame_len_t));
+        }
+    }
+    return rval;
+}
+
+
+int
+socket_wrapper::beginRecvMessage ()
+{
+    int rval = SUCCESS;
+    if (FRAMED == (m_Mode & FRAMED))
+    {
+        // whatever is left of the current frame is dropped, so a message
+        // that failed to decode doesn't desynchronize the stream
+        m_InRecvFrame = false;
+        m_pRecvSource = NULL;
+        m_RecvSourcePos = 0;
+        m_RecvSourceLen = 0;
+        frame_len_t frameLen = 0;
+        rval = recv_stream (reinterpret_cast<byte_t*>(&frameLen),
+                            sizeof (frameLen));
+        if (SUCCESS == rval &&
+            MAX_FRAME_SIZE < frameLen)
+        {
+            // the length can't be trusted, so neither can the stream
+            SCX_BOOKEND_PRINT ("socket_wrapper::beginRecvMessage - bad length");
+            std::cerr << "socket_wrapper: invalid frame length: " << frameLen
+                      << std::endl;
+            fail ();
+            rval = RECV_FAILED;
+        }
+        if (SUCCESS == rval)
+        {
+            m_RecvFrame.resize (frameLen);
+            if (0 < frameLen)
+            {
+                rval = recv_stream (&m_RecvFrame[0], frameLen);
+            }
+        }
+        if (SUCCESS == rval)
+        {
+            m_pRecvSource = 0 < frameLen ? &m_RecvFrame[0] : NULL;
+            m_RecvSourceLen = frameLen;
+            m_InRecvFrame = true;
+        }
+    }
+    return rval;
+}
+
+
+int
+socket_wrapper::flush ()
+{
+    //SCX_BOOKEND ("socket_wrapper::flush");
+    close_send_frame ();
+    return write_buffer ();
+}
+
+
+bool
+socket_wrapper::isBuffered () const
+{
+    return BUFFERED == (m_Mode & BUFFERED);
+}
+
+
+bool
+socket_wrapper::isFramed () const
+{
+    return FRAMED == (m_Mode & FRAMED);
+}
+
+
+int
+socket_wrapper::getFD () const
+{
+    return m_FD;
+}
+
+
 void
 socket_wrapper::close ()
 {
@@ -144,4 +383,227 @@ socket_wrapper::close ()
         ::close (m_FD);
         m_FD = INVALID_SOCKET;
     }
+    m_SendBuffer.clear ();
+    m_SendFrameStart = NO_FRAME;
+    m_RecvPos = 0;
+    m_RecvLen = 0;
+    if (m_InRecvFrame)
+    {
+        m_InRecvFrame = false;
+        m_pRecvSource = NULL;
+        m_RecvSourcePos = 0;
+        m_RecvSourceLen = 0;
+    }
+}
+
+
+size_t
+socket_wrapper::getRecvRemaining () const
+{
+    return NULL != m_pRecvSource || m_InRecvFrame
+        ? m_RecvSourceLen - m_RecvSourcePos
+        : 0;
+}
+
+
+int
+socket_wrapper::recv_stream (
+    byte_t* const pDataOut,
+    size_t const& nBytes)
+{
+    int rval = SUCCESS;
+    if (INVALID_SOCKET == m_FD)
+    {
+        SCX_BOOKEND_PRINT ("socket_wrapper::recv called on closed socket");
+        rval = SOCKET_CLOSED;
+    }
+    else if (BUFFERED != (m_Mode & BUFFERED))
+    {
+        size_t nRead = 0;
+        rval = read_fd (pDataOut, nBytes, nBytes, &nRead);
+    }
+    else
+    {
+        size_t nAvailable = m_RecvLen - m_RecvPos;
+        if (nAvailable >= nBytes)
+        {
+            memcpy (pDataOut, &m_RecvBuffer[m_RecvPos], nBytes);
+            m_RecvPos += nBytes;
+        }
+        else
+        {
+            if (0 < nAvailable)
+            {
+                memcpy (pDataOut, &m_RecvBuffer[m_RecvPos], nAvailable);
+            }
+            m_RecvPos = 0;
+            m_RecvLen = 0;
+            if (DUPLEX != (m_Mode & DUPLEX))
+            {
+                // the peer may be waiting on data that is still buffered
+                rval = flush ();
+            }
+            size_t nRemaining = nBytes - nAvailable;
+            if (SUCCESS == rval &&
+                BUFFER_SIZE <= nRemaining)
+            {
+                // too big to buffer, read directly into the output
+                size_t nRead = 0;
+                rval = read_fd (pDataOut + nAvailable, nRemaining,
+                                nRemaining, &nRead);
+            }
+            else if (SUCCESS == rval)
+            {
+                rval = read_fd (&m_RecvBuffer[0], nRemaining,
+                                BUFFER_SIZE, &m_RecvLen);
+                if (SUCCESS == rval)
+                {
+                    memcpy (pDataOut + nAvailable, &m_RecvBuffer[0],
+                            nRemaining);
+                    m_RecvPos = nRemaining;
+                }
+            }
+        }
+    }
+    return rval;
+}
+
+
+void
+socket_wrapper::fail ()
+{
+    if (DUPLEX == (m_Mode & DUPLEX))
+    {
+        // the other direction may be in use on another thread, so the
+        // buffers and the descriptor are left to close ()
+        if (INVALID_SOCKET != m_FD)
+        {
+            shutdown (m_FD, SHUT_RDWR);
+        }
+    }
+    else
+    {
+        close ();
+    }
+}
+
+
+int
+socket_wrapper::write_buffer ()
+{
+    int rval = SUCCESS;
+    if (!m_SendBuffer.empty ())
+    {
+        if (INVALID_SOCKET != m_FD)
+        {
+            rval = write_fd (&m_SendBuffer[0], m_SendBuffer.size ());
+        }
+        else
+        {
+            SCX_BOOKEND_PRINT (
+                "socket_wrapper::flush called on closed socket");
+            rval = SOCKET_CLOSED;
+        }
+        m_SendBuffer.clear ();
+    }
+    return rval;
+}
+
+
+void
+socket_wrapper::close_send_frame ()
+{
+    if (NO_FRAME != m_SendFrameStart)
+    {
+        frame_len_t frameLen = static_cast<frame_len_t>(
+            m_SendBuffer.size () - m_SendFrameStart - sizeof (frame_len_t));
+        memcpy (&m_SendBuffer[m_SendFrameStart], &frameLen,
+                sizeof (frameLen));
+        m_SendFrameStart = NO_FRAME;
+    }
+}
+
+
+int
+socket_wrapper::write_fd (
+    byte_t const* const pData,
+    size_t const& nBytes)
+{
+    int rval = SUCCESS;
+    ssize_t nBytesSent = 0;
+    while (SUCCESS == rval &&
+           nBytes > static_cast<size_t> (nBytesSent))
+    {
+        ssize_t nSent;
+        {
+            blocking_section blocking;
+            nSent = write (m_FD, pData + nBytesSent, nBytes - nBytesSent);
+        }
+        if (-1 != nSent)
+        {
+            nBytesSent += nSent;
+        }
+        else if (EINTR != errno)
+        {
+            // error (check errno { EACCESS, EAGAIN, EWOULDBLOCK, EBADF,
+            //                      ECONNRESET, EDESTADDRREQ, EFAULT,
+            //                      EINVAL, EISCONN, EMSGSIZE, ENOBUFS,
+            //                      ENOMEM, ENOTCONN, ENOTSOCK, EOPNOTSUPP,
+            //                      EPIPE })
+            std::ostringstream strm;
+            strm << "error on socket: (" << errno << ") \"" << errnoText
+                 << '\"';
+            fail ();
+            rval = SEND_FAILED;
+            SCX_BOOKEND_PRINT (strm.str ());
+            std::cerr << strm.str () << std::endl;
+        }
+    }
+    return rval;
+}
+
+
+int
+socket_wrapper::read_fd (
+    byte_t* const pDataOut,
+    size_t const& nMin,
+    size_t const& nMax,
+    size_t* const pnReadOut)
+{
+    int rval = SUCCESS;
+    size_t nBytesRead = 0;
+    while (SUCCESS == rval &&
+           nMin > nBytesRead)
+    {
+        ssize_t nRead;
+        {
+            blocking_section blocking;
+            nRead = read (m_FD, pDataOut + nBytesRead, nMax - nBytesRead);
+        }
+        if (0 < nRead)
+        {
+            nBytesRead += static_cast<size_t> (nRead);
+        }
+        else if (0 == nRead)
+        {
+            // socket closed
+            fail ();
+            rval = SOCKET_CLOSED;
+            SCX_BOOKEND_PRINT ("recv - zero byte read");
+        }
+        else if (EINTR != errno)
+        {
+            // Error - check errno { EAGAIN, EBADF, EFAULT, EINVAL, EIO,
+            //                       EISDIR }
+            std::ostringstream strm;
+            strm << "error on socket: (" << errno << ") \"" << errnoText
+                 << '\"';
+            fail ();
+            rval = RECV_FAILED;
+            SCX_BOOKEND_PRINT (strm.str ());
+            std::cerr << strm.str () << std::endl;
+        }
+    }
+    *pnReadOut = nBytesRead;
+    return rval;
 }
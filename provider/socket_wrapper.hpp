@@ -8,6 +8,7 @@
 
 
 #include <cstdlib>
+#include <vector>
 
 
 #define EXPORT_PUBLIC __attribute__ ((visibility ("default")))
@@ -28,15 +29,103 @@ public:
 
     typedef unsigned char byte_t;
 
+    // the length prefix of a frame
+    typedef unsigned int frame_len_t;
+
+    enum Mode
+    {
+        UNBUFFERED = 0,
+        // send gathers data into an output buffer that is written when it
+        // fills, when flush is called, or before recv has to block on the
+        // socket; recv is served from a read-ahead buffer
+        BUFFERED = 1 << 0,
+        // BUFFERED, plus every message is sent as a length-prefixed frame
+        // and received whole before it is decoded from memory
+        FRAMED = BUFFERED | 1 << 1,
+        // FRAMED, plus one thread may send while another receives: recv
+        // doesn't flush the send buffer, so each message has to be flushed
+        // by its sender, and an I/O error shuts the socket down instead of
+        // closing it
+        DUPLEX = FRAMED | 1 << 2,
+    };
+
     static int const INVALID_SOCKET = -1;
 
+    // size of the send and read-ahead buffers used in buffered mode
+    static size_t const BUFFER_SIZE = 64 * 1024;
+
+    // frames with a longer length prefix are rejected
+    static size_t const MAX_FRAME_SIZE = 256 * 1024 * 1024;
+
+    // An interpreter that embeds the client can set hooks that are called
+    // around every system call that may block (reads, writes and waits),
+    // for example to let its other threads run in the meantime.  The value
+    // returned by the begin hook is passed to the end hook.  The hooks are
+    // set once, before any thread uses a socket_wrapper.
+    typedef void* (*begin_blocking_fn)();
+    typedef void (*end_blocking_fn)(void* pState);
+
+    EXPORT_PUBLIC static void setBlockingHooks (
+        begin_blocking_fn const pBegin,
+        end_blocking_fn const pEnd);
+
+    // blocking_section calls the blocking hooks for its lifetime.
+    class EXPORT_PUBLIC blocking_section
+    {
+    public:
+        EXPORT_PUBLIC /*ctor*/ blocking_section ();
+        EXPORT_PUBLIC /*dtor*/ ~blocking_section ();
+
+    private:
+        /*ctor*/ blocking_section (blocking_section const&); // = delete
+        blocking_section& operator = (blocking_section const&); // = delete
 
-    EXPORT_PUBLIC explicit /*ctor*/ socket_wrapper (int fd);
+        void* const m_pState;
+    };
+
+
+    EXPORT_PUBLIC explicit /*ctor*/ socket_wrapper (
+        int fd,
+        unsigned int const& mode = UNBUFFERED);
+    // A socket_wrapper that decodes from memory: recv is served from
+    // [pData, pData + nBytes) and fails rather than read past the end.
+    EXPORT_PUBLIC /*ctor*/ socket_wrapper (
+        byte_t const* const pData,
+        size_t const& nBytes);
+    // A socket_wrapper that encodes to memory: send appends to *pBuffer.
+    EXPORT_PUBLIC explicit /*ctor*/ socket_wrapper (
+        std::vector<byte_t>* const pBuffer);
     EXPORT_PUBLIC /*dtor*/ ~socket_wrapper ();
 
     EXPORT_PUBLIC int send (byte_t const* const pData, size_t const& nBytes);
     EXPORT_PUBLIC int recv (byte_t* const pDataOut, size_t const& nBytes);
 
+    // In framed and memory modes the current message is held whole in
+    // memory and recvInPlace consumes nBytes of it by returning where they
+    // lie instead of copying them.  The data stays valid until the next
+    // message is begun (or, for memory mode, as long as the source).
+    EXPORT_PUBLIC bool canRecvInPlace () const;
+    EXPORT_PUBLIC int recvInPlace (
+        byte_t const** const ppDataOut,
+        size_t const& nBytes);
+    // In framed and memory modes, the part of the current message that has
+    // not been received yet.
+    EXPORT_PUBLIC size_t getRecvRemaining () const;
+
+    // In framed mode, close the current outgoing frame and start the next.
+    // A send outside of a frame starts one, flush closes it.
+    EXPORT_PUBLIC int beginSendMessage ();
+    // In framed mode, discard what is left of the current incoming frame
+    // and read the next one.  A recv outside of a frame reads one.
+    EXPORT_PUBLIC int beginRecvMessage ();
+
+    EXPORT_PUBLIC int flush ();
+
+    EXPORT_PUBLIC bool isBuffered () const;
+    EXPORT_PUBLIC bool isFramed () const;
+
+    EXPORT_PUBLIC int getFD () const;
+
     EXPORT_PUBLIC void close ();
 
 private:
@@ -44,7 +133,28 @@ private:
     /*ctor*/ socket_wrapper (socket_wrapper const&); // = delete
     socket_wrapper& operator = (socket_wrapper const&); // = delete
 
+    int recv_stream (byte_t* const pDataOut, size_t const& nBytes);
+    int write_buffer ();
+    void close_send_frame ();
+    void fail ();
+
+    int write_fd (byte_t const* const pData, size_t const& nBytes);
+    int read_fd (byte_t* const pDataOut, size_t const& nMin,
+                 size_t const& nMax, size_t* const pnReadOut);
+
     int m_FD;
+    unsigned int const m_Mode;
+    std::vector<byte_t> m_SendBuffer;
+    size_t m_SendFrameStart;
+    std::vector<byte_t> m_RecvBuffer;
+    size_t m_RecvPos;
+    size_t m_RecvLen;
+    std::vector<byte_t> m_RecvFrame;
+    bool m_InRecvFrame;
+    byte_t const* m_pRecvSource;
+    size_t m_RecvSourcePos;
+    size_t m_RecvSourceLen;
+    std::vector<byte_t>* const m_pSendTarget;
 };
 
 
@@ -0,0 +1,139 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#include "thread_pool.hpp"
+
+
+#include "debug_tags.hpp"
+
+
+#include <cassert>
+
+
+/*ctor*/
+thread_pool::thread_pool (
+    size_t const& nThreads)
+    : m_nRunning (0)
+    , m_Stopping (false)
+{
+    SCX_BOOKEND ("thread_pool::ctor");
+    pthread_mutex_init (&m_Lock, NULL);
+    pthread_cond_init (&m_TaskReady, NULL);
+    pthread_cond_init (&m_Idle, NULL);
+    m_Threads.reserve (nThreads);
+    for (size_t i = 0; i < nThreads; ++i)
+    {
+        pthread_t thread;
+        if (0 == pthread_create (&thread, NULL, thread_main, this))
+        {
+            m_Threads.push_back (thread);
+        }
+        else
+        {
+            SCX_BOOKEND_PRINT ("pthread_create failed");
+        }
+    }
+}
+
+
+/*dtor*/
+thread_pool::~thread_pool ()
+{
+    SCX_BOOKEND ("thread_pool::dtor");
+    pthread_mutex_lock (&m_Lock);
+    m_Stopping = true;
+    pthread_cond_broadcast (&m_TaskReady);
+    pthread_mutex_unlock (&m_Lock);
+    for (std::vector<pthread_t>::iterator pos = m_Threads.begin (),
+             endPos = m_Threads.end ();
+         pos != endPos;
+         ++pos)
+    {
+        pthread_join (*pos, NULL);
+    }
+    pthread_cond_destroy (&m_Idle);
+    pthread_cond_destroy (&m_TaskReady);
+    pthread_mutex_destroy (&m_Lock);
+}
+
+
+void
+thread_pool::submit (
+    task* const pTask)
+{
+    assert (pTask);
+    if (!m_Threads.empty ())
+    {
+        pthread_mutex_lock (&m_Lock);
+        m_Tasks.push_back (pTask);
+        pthread_cond_signal (&m_TaskReady);
+        pthread_mutex_unlock (&m_Lock);
+    }
+    else
+    {
+        pTask->run ();
+        delete pTask;
+    }
+}
+
+
+void
+thread_pool::waitIdle ()
+{
+    pthread_mutex_lock (&m_Lock);
+    while (!m_Tasks.empty () ||
+           0 < m_nRunning)
+    {
+        pthread_cond_wait (&m_Idle, &m_Lock);
+    }
+    pthread_mutex_unlock (&m_Lock);
+}
+
+
+size_t
+thread_pool::getThreadCount () const
+{
+    return m_Threads.size ();
+}
+
+
+/*static*/ void*
+thread_pool::thread_main (
+    void* pPool)
+{
+    reinterpret_cast<thread_pool*>(pPool)->run_tasks ();
+    return NULL;
+}
+
+
+void
+thread_pool::run_tasks ()
+{
+    pthread_mutex_lock (&m_Lock);
+    for (;;)
+    {
+        while (m_Tasks.empty () &&
+               !m_Stopping)
+        {
+            pthread_cond_wait (&m_TaskReady, &m_Lock);
+        }
+        if (m_Tasks.empty ())
+        {
+            // stopping and nothing left to run
+            break;
+        }
+        task* pTask = m_Tasks.front ();
+        m_Tasks.pop_front ();
+        ++m_nRunning;
+        pthread_mutex_unlock (&m_Lock);
+        pTask->run ();
+        delete pTask;
+        pthread_mutex_lock (&m_Lock);
+        --m_nRunning;
+        if (m_Tasks.empty () &&
+            0 == m_nRunning)
+        {
+            pthread_cond_broadcast (&m_Idle);
+        }
+    }
+    pthread_mutex_unlock (&m_Lock);
+}
@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#ifndef INCLUDED_THREAD_POOL_HPP
+#define INCLUDED_THREAD_POOL_HPP
+
+
+#include <cstdlib>
+#include <deque>
+#include <pthread.h>
+#include <vector>
+
+
+#define EXPORT_PUBLIC __attribute__ ((visibility ("default")))
+
+
+// thread_pool runs tasks on a fixed number of worker threads in the order
+// they were submitted.
+class EXPORT_PUBLIC thread_pool
+{
+public:
+    class task
+    {
+    public:
+        virtual /*dtor*/ ~task () {}
+        virtual void run () = 0;
+    };
+
+
+    // fewer threads are started if the system won't create them all
+    EXPORT_PUBLIC explicit /*ctor*/ thread_pool (size_t const& nThreads);
+    // runs the tasks that are still queued, then joins the threads
+    EXPORT_PUBLIC /*dtor*/ ~thread_pool ();
+
+    // the pool takes ownership of pTask and deletes it once it has run; if
+    // there are no threads the task is run before submit returns
+    EXPORT_PUBLIC void submit (task* const pTask);
+
+    // block until every submitted task has run
+    EXPORT_PUBLIC void waitIdle ();
+
+    EXPORT_PUBLIC size_t getThreadCount () const;
+
+private:
+    /*ctor*/ thread_pool (thread_pool const&); // = delete
+    thread_pool& operator = (thread_pool const&); // = delete
+
+    static void* thread_main (void* pPool);
+    void run_tasks ();
+
+    pthread_mutex_t m_Lock;
+    pthread_cond_t m_TaskReady;
+    pthread_cond_t m_Idle;
+    std::deque<task*> m_Tasks;
+    size_t m_nRunning;
+    bool m_Stopping;
+    std::vector<pthread_t> m_Threads;
+};
+
+
+#undef EXPORT_PUBLIC
+
+
+#endif // INCLUDED_THREAD_POOL_HPP
@@ -4,6 +4,28 @@
 #define INCLUDED_UTIL_TRAITS_HPP
 
 
+// UTIL_HAS_RVALUE_REFERENCES is 1 when the compiler has C++11 rvalue
+// references.  The smart pointers then have move operations and UTIL_MOVE
+// hands a value on without a copy.  Under C++03 UTIL_MOVE is a plain copy.
+// The move operations are UTIL_NOEXCEPT so std::vector moves its elements
+// when it grows rather than copying them.
+#if (201103L <= __cplusplus)
+#define UTIL_HAS_RVALUE_REFERENCES (1)
+#else
+#define UTIL_HAS_RVALUE_REFERENCES (0)
+#endif
+
+
+#if (UTIL_HAS_RVALUE_REFERENCES)
+#include <utility>
+#define UTIL_MOVE(x) std::move (x)
+#define UTIL_NOEXCEPT noexcept
+#else
+#define UTIL_MOVE(x) (x)
+#define UTIL_NOEXCEPT
+#endif
+
+
 namespace util
 {
 
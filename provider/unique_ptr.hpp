@@ -40,9 +40,16 @@ public:
 
     explicit /*ctor*/ unique_ptr (move_type const& move_ref);
 
+#if (UTIL_HAS_RVALUE_REFERENCES)
+    /*ctor*/ unique_ptr (unique_ptr&& ref) UTIL_NOEXCEPT;
+#endif
+
     /*dtor*/ ~unique_ptr ();
 
     unique_ptr& operator = (move_type const& move_ref);
+#if (UTIL_HAS_RVALUE_REFERENCES)
+    unique_ptr& operator = (unique_ptr&& rhs) UTIL_NOEXCEPT;
+#endif
 
     pointer get () const;
     deleter_type& get_deleter ();
@@ -71,6 +78,13 @@ private:
 };
 
 
+#if (UTIL_HAS_RVALUE_REFERENCES)
+// make_unique constructs a T from args and returns the pointer that owns it
+template<typename T, typename... Args>
+unique_ptr<T> make_unique (Args&&... args);
+#endif
+
+
 // unique_ptr (array specialization)
 //------------------------------------------------------------------------------
 template<typename T, typename D>
@@ -91,9 +105,16 @@ public:
 
     explicit /*ctor*/ unique_ptr (move_type const& move_ref);
 
+#if (UTIL_HAS_RVALUE_REFERENCES)
+    /*ctor*/ unique_ptr (unique_ptr&& ref) UTIL_NOEXCEPT;
+#endif
+
     /*dtor*/ ~unique_ptr ();
 
     unique_ptr& operator = (move_type const& move_ref);
+#if (UTIL_HAS_RVALUE_REFERENCES)
+    unique_ptr& operator = (unique_ptr&& rhs) UTIL_NOEXCEPT;
+#endif
 
     pointer get () const;
     deleter_type& get_deleter ();
@@ -223,6 +244,18 @@ unique_ptr<T, D>::unique_ptr (
     m_ref.m_pT = 0;
 }
 
+#if (UTIL_HAS_RVALUE_REFERENCES)
+template<typename T, typename D>
+inline /*ctor*/
+unique_ptr<T, D>::unique_ptr (
+    unique_ptr<T, D>&& ref) UTIL_NOEXCEPT
+  : m_pT (ref.m_pT)
+  , m_deleter (ref.m_deleter)
+{
+    ref.m_pT = 0;
+}
+#endif
+
 template<typename T, typename D>
 inline /*dtor*/
 unique_ptr<T, D>::~unique_ptr ()
@@ -249,6 +282,21 @@ unique_ptr<T, D>::operator = (
     return *this;
 }
 
+#if (UTIL_HAS_RVALUE_REFERENCES)
+template<typename T, typename D>
+inline unique_ptr<T, D>&
+unique_ptr<T, D>::operator = (
+    unique_ptr<T, D>&& rhs) UTIL_NOEXCEPT
+{
+    if (this != &rhs)
+    {
+        reset (rhs.release ());
+        m_deleter = rhs.m_deleter;
+    }
+    return *this;
+}
+#endif
+
 template<typename T, typename D>
 inline typename unique_ptr<T, D>::pointer
 unique_ptr<T, D>::get () const
@@ -300,6 +348,7 @@ unique_ptr<T, D>::reset ()
     if (0 != m_pT)
     {
         m_deleter (m_pT);
+        m_pT = 0;
     }
 }
 
@@ -349,6 +398,19 @@ unique_ptr<T, D>::move ()
 }
 
 
+#if (UTIL_HAS_RVALUE_REFERENCES)
+// make_unique definition
+//------------------------------------------------------------------------------
+template<typename T, typename... Args>
+inline unique_ptr<T>
+make_unique (
+    Args&&... args)
+{
+    return unique_ptr<T> (new T (std::forward<Args>(args)...));
+}
+#endif
+
+
 // unique_ptr (array specialization) defs
 //------------------------------------------------------------------------------
 template<typename T, typename D>
@@ -392,6 +454,18 @@ unique_ptr<T[], D>::unique_ptr (
     m_ref.m_pT = 0;
 }
 
+#if (UTIL_HAS_RVALUE_REFERENCES)
+template<typename T, typename D>
+inline /*ctor*/
+unique_ptr<T[], D>::unique_ptr (
+    unique_ptr<T[], D>&& ref) UTIL_NOEXCEPT
+  : m_pT (ref.m_pT)
+  , m_deleter (ref.m_deleter)
+{
+    ref.m_pT = 0;
+}
+#endif
+
 template<typename T, typename D>
 inline /*dtor*/
 unique_ptr<T[], D>::~unique_ptr ()
@@ -418,6 +492,21 @@ unique_ptr<T[], D>::operator = (
     return *this;
 }
 
+#if (UTIL_HAS_RVALUE_REFERENCES)
+template<typename T, typename D>
+inline unique_ptr<T[], D>&
+unique_ptr<T[], D>::operator = (
+    unique_ptr<T[], D>&& rhs) UTIL_NOEXCEPT
+{
+    if (this != &rhs)
+    {
+        reset (rhs.release ());
+        m_deleter = rhs.m_deleter;
+    }
+    return *this;
+}
+#endif
+
 template<typename T, typename D>
 inline typename unique_ptr<T[], D>::pointer
 unique_ptr<T[], D>::get () const
@@ -0,0 +1,142 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#include "value_pool.hpp"
+
+
+#include <new>
+#include <pthread.h>
+
+
+namespace
+{
+
+
+size_t const SIZE_CLASS_COUNT = value_pool::MAX_SIZE / value_pool::ALIGNMENT;
+
+
+struct free_block
+{
+    free_block* pNext;
+};
+
+
+struct thread_cache
+{
+    free_block* pFree[SIZE_CLASS_COUNT];
+    size_t nFree[SIZE_CLASS_COUNT];
+};
+
+
+pthread_once_t g_CacheOnce = PTHREAD_ONCE_INIT;
+pthread_key_t g_CacheKey;
+bool g_HaveCacheKey = false;
+
+
+void
+free_cache (
+    void* pCache)
+{
+    thread_cache* const pThreadCache = static_cast<thread_cache*>(pCache);
+    for (size_t i = 0; i < SIZE_CLASS_COUNT; ++i)
+    {
+        while (NULL != pThreadCache->pFree[i])
+        {
+            free_block* const pBlock = pThreadCache->pFree[i];
+            pThreadCache->pFree[i] = pBlock->pNext;
+            ::operator delete (pBlock);
+        }
+    }
+    delete pThreadCache;
+}
+
+
+void
+create_cache_key ()
+{
+    g_HaveCacheKey = 0 == pthread_key_create (&g_CacheKey, free_cache);
+}
+
+
+// the calling thread's cache, NULL if it can't be had
+thread_cache*
+get_cache ()
+{
+    pthread_once (&g_CacheOnce, create_cache_key);
+    thread_cache* pCache = NULL;
+    if (g_HaveCacheKey)
+    {
+        pCache = static_cast<thread_cache*>(pthread_getspecific (g_CacheKey));
+        if (NULL == pCache)
+        {
+            pCache = new (std::nothrow) thread_cache ();
+            if (NULL != pCache &&
+                0 != pthread_setspecific (g_CacheKey, pCache))
+            {
+                delete pCache;
+                pCache = NULL;
+            }
+        }
+    }
+    return pCache;
+}
+
+
+} // namespace <unnamed>
+
+
+/*static*/ void*
+value_pool::allocate (
+    size_t const size)
+{
+    void* pBlock = NULL;
+    if (0 < size &&
+        MAX_SIZE >= size)
+    {
+        size_t const sizeClass = (size - 1) / ALIGNMENT;
+        thread_cache* const pCache = get_cache ();
+        if (NULL != pCache &&
+            NULL != pCache->pFree[sizeClass])
+        {
+            free_block* const pFree = pCache->pFree[sizeClass];
+            pCache->pFree[sizeClass] = pFree->pNext;
+            --(pCache->nFree[sizeClass]);
+            pBlock = pFree;
+        }
+        else
+        {
+            pBlock = ::operator new ((sizeClass + 1) * ALIGNMENT);
+        }
+    }
+    else
+    {
+        pBlock = ::operator new (size);
+    }
+    return pBlock;
+}
+
+
+/*static*/ void
+value_pool::deallocate (
+    void* const pBlock,
+    size_t const size)
+{
+    if (NULL != pBlock)
+    {
+        thread_cache* pCache = NULL;
+        size_t const sizeClass = 0 < size ? (size - 1) / ALIGNMENT : 0;
+        if (0 < size &&
+            MAX_SIZE >= size &&
+            NULL != (pCache = get_cache ()) &&
+            MAX_FREE_BLOCKS > pCache->nFree[sizeClass])
+        {
+            free_block* const pFree = static_cast<free_block*>(pBlock);
+            pFree->pNext = pCache->pFree[sizeClass];
+            pCache->pFree[sizeClass] = pFree;
+            ++(pCache->nFree[sizeClass]);
+        }
+        else
+        {
+            ::operator delete (pBlock);
+        }
+    }
+}
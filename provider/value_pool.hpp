@@ -0,0 +1,42 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#ifndef INCLUDED_VALUE_POOL_HPP
+#define INCLUDED_VALUE_POOL_HPP
+
+
+#include <cstdlib>
+
+
+#define EXPORT_PUBLIC __attribute__ ((visibility ("default")))
+
+
+// value_pool allocates the small, fixed size objects that values are made
+// of (see MI_Value and MI_Datetime) from free lists, one for each size
+// class of ALIGNMENT bytes up to MAX_SIZE.  Each thread keeps its own free
+// lists so no lock is taken.  A block freed by another thread than the one
+// that allocated it goes to the freeing thread's list.  A thread's lists
+// are released when it exits.  Sizes above MAX_SIZE go to operator new.
+class EXPORT_PUBLIC value_pool
+{
+public:
+    static size_t const ALIGNMENT = 16;
+    static size_t const MAX_SIZE = 128;
+    // the most blocks a thread keeps for each size class, the rest are
+    // returned to operator delete
+    static size_t const MAX_FREE_BLOCKS = 1024;
+
+    EXPORT_PUBLIC static void* allocate (size_t const size);
+    // size is the size that was passed to allocate
+    EXPORT_PUBLIC static void deallocate (
+        void* const pBlock,
+        size_t const size);
+
+private:
+    /*ctor*/ value_pool (); // = delete
+};
+
+
+#undef EXPORT_PUBLIC
+
+
+#endif // INCLUDED_VALUE_POOL_HPP
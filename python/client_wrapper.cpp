@@ -4,6 +4,7 @@
 
 
 #include "debug_tags.hpp"
+#include "event_loop.hpp"
 #include "py_ptr.hpp"
 #include "python_compatibility.hpp"
 #include "shared.hpp"
@@ -118,19 +119,27 @@ Client_Wrapper::init (
 #if (CLIENT_INIT_VERBOSE)
     std::ostringstream strm;
 #endif
-    // parse the args (path, port, key)
+    // parse the args (path, port, key) or (path, fd, ring), and the number
+    // of worker threads
     char const* KEYWORDS[] = {
         "path",
         "port",
         "key",
+        "fd",
+        "ring",
+        "threads",
         NULL
     };
     char const* path = NULL;
     unsigned int port = 0;
     char const* key = NULL;
+    int fd = -1;
+    int ring = -1;
+    unsigned int threads = Client::DEFAULT_THREAD_COUNT;
     if (!PyArg_ParseTupleAndKeywords (
-            args, keywords, "sIs", const_cast<char **>(KEYWORDS), &path, &port,
-            &key))
+            args, keywords, "s|IsiiI", const_cast<char **>(KEYWORDS), &path,
+            &port, &key, &fd, &ring, &threads) ||
+        (0 > fd && NULL == key))
     {
         CLIENT_INIT_BOOKEND_PRINT ("PyArg_ParseTuple failed");
         PyErr_SetString (PyExc_ValueError,
@@ -149,7 +158,19 @@ Client_Wrapper::init (
         CLIENT_INIT_BOOKEND_PRINT (strm.str ().c_str ());
         strm.str ("");
         strm.clear ();
-        strm << "key: " << key;
+        strm << "key: " << (key ? key : "(null)");
+        CLIENT_INIT_BOOKEND_PRINT (strm.str ().c_str ());
+        strm.str ("");
+        strm.clear ();
+        strm << "fd: " << fd;
+        CLIENT_INIT_BOOKEND_PRINT (strm.str ().c_str ());
+        strm.str ("");
+        strm.clear ();
+        strm << "ring: " << ring;
+        CLIENT_INIT_BOOKEND_PRINT (strm.str ().c_str ());
+        strm.str ("");
+        strm.clear ();
+        strm << "threads: " << threads;
         CLIENT_INIT_BOOKEND_PRINT (strm.str ().c_str ());
     }
 #endif 
@@ -263,7 +284,11 @@ Client_Wrapper::init (
         if (!pModule)
         {
             CLIENT_INIT_BOOKEND_PRINT ("MI_Module creation failed");
-            PyErr_SetString (PyExc_ValueError, "MI_Module creation failed");
+            if (!PyErr_Occurred ())
+            {
+                PyErr_SetString (PyExc_ValueError,
+                                 "MI_Module creation failed");
+            }
             rval = -1;
         }
         else
@@ -273,7 +298,8 @@ Client_Wrapper::init (
     }
     // parse the key
     unsigned int keyCode[4];
-    if (0 == rval)
+    if (0 == rval &&
+        0 > fd)
     {
         char keyText[9];
         keyText[8] = '\0';
@@ -293,9 +319,11 @@ Client_Wrapper::init (
     if (0 == rval)
     {
         Client::Ptr pClient;
-        if (EXIT_SUCCESS ==
-            Client::create (static_cast<unsigned short>(port), keyCode, pModule,
-                            &pClient))
+        int result = 0 <= fd
+            ? Client::create (fd, ring, pModule, &pClient, threads)
+            : Client::create (static_cast<unsigned short>(port), keyCode,
+                              pModule, &pClient, threads);
+        if (EXIT_SUCCESS == result)
         {
             CLIENT_INIT_BOOKEND_PRINT ("Client::create succeeded");
             new (pSelf) Client_Wrapper (pPythonModule.release (), pClient);
@@ -317,7 +345,17 @@ Client_Wrapper::run (
 {
     SCX_BOOKEND ("Client_Wrapper::run");
     Client_Wrapper* pClient = reinterpret_cast<Client_Wrapper*>(pSelf);
+#if (PY_VERSION_HEX < 0x03070000)
+    // the workers take the GIL with PyGILState_Ensure
+    PyEval_InitThreads ();
+#endif
+    // the GIL is released while the requests are read so that the workers
+    // can run the provider
+    Py_BEGIN_ALLOW_THREADS
     pClient->m_pClient->run ();
+    Py_END_ALLOW_THREADS
+    // the loop's coroutines have finished unless the server went away
+    event_loop::stop ();
     Py_RETURN_NONE;
 }
 
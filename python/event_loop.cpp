@@ -0,0 +1,232 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#include "event_loop.hpp"
+
+
+#include "debug_tags.hpp"
+#include "py_ptr.hpp"
+#include "python_compatibility.hpp"
+
+
+using namespace scx;
+
+
+/*static*/ char const event_loop::CONTEXT_CAPSULE_NAME[] = "omi.MI_Context";
+/*static*/ PyMethodDef event_loop::ON_DONE_DEF = {
+    "on_done", event_loop::on_done, METH_O,
+    "post the result of a coroutine's request"
+};
+/*static*/ PyObject* event_loop::s_pLoop = NULL;
+/*static*/ PyObject* event_loop::s_pThread = NULL;
+/*static*/ pthread_mutex_t event_loop::s_StartLock =
+    PTHREAD_MUTEX_INITIALIZER;
+
+
+/*static*/ bool
+event_loop::isCoroutine (
+    PyObject* const pObj)
+{
+#if (SCX_USE_ASYNCIO)
+    return PyCoro_CheckExact (pObj);
+#else
+    return false;
+#endif
+}
+
+
+/*static*/ int
+event_loop::submit (
+    PyObject* const pCoroutine,
+    MI_Context::Ptr const& pContext)
+{
+    SCX_BOOKEND ("event_loop::submit");
+    int rval = EXIT_SUCCESS;
+    if (NULL == s_pLoop)
+    {
+        // start releases the GIL, the lock keeps another worker from starting
+        // a second loop meanwhile; the GIL is released while waiting for it
+        Py_BEGIN_ALLOW_THREADS
+        pthread_mutex_lock (&s_StartLock);
+        Py_END_ALLOW_THREADS
+        if (NULL == s_pLoop)
+        {
+            rval = start ();
+        }
+        pthread_mutex_unlock (&s_StartLock);
+    }
+    PyObjPtr pFuture;
+    if (EXIT_SUCCESS == rval)
+    {
+        PyObjPtr pAsyncio (PyImport_ImportModule ("asyncio"));
+        if (pAsyncio)
+        {
+            pFuture.reset (PyObject_CallMethod (
+                               pAsyncio.get (),
+                               const_cast<char*>("run_coroutine_threadsafe"),
+                               const_cast<char*>("OO"), pCoroutine, s_pLoop));
+        }
+        rval = pFuture ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (EXIT_SUCCESS == rval)
+    {
+        // the result is deferred first, the callback may run as soon as the
+        // GIL is released
+        pContext->deferResult ();
+        PyObjPtr pCapsule (PyCapsule_New (new MI_Context::Ptr (pContext),
+                                          CONTEXT_CAPSULE_NAME,
+                                          free_context));
+        PyObjPtr pOnDone;
+        if (pCapsule)
+        {
+            pOnDone.reset (PyCFunction_New (&ON_DONE_DEF, pCapsule.get ()));
+        }
+        PyObjPtr pAdded;
+        if (pOnDone)
+        {
+            pAdded.reset (PyObject_CallMethod (
+                              pFuture.get (),
+                              const_cast<char*>("add_done_callback"),
+                              const_cast<char*>("O"), pOnDone.get ()));
+        }
+        if (!pAdded)
+        {
+            SCX_BOOKEND_PRINT ("add_done_callback failed");
+            rval = EXIT_FAILURE;
+        }
+    }
+    return rval;
+}
+
+
+/*static*/ void
+event_loop::stop ()
+{
+    SCX_BOOKEND ("event_loop::stop");
+    if (NULL != s_pLoop)
+    {
+        PyObjPtr pStop (PyObject_GetAttrString (s_pLoop, "stop"));
+        PyObjPtr pCalled;
+        if (pStop)
+        {
+            pCalled.reset (PyObject_CallMethod (
+                               s_pLoop,
+                               const_cast<char*>("call_soon_threadsafe"),
+                               const_cast<char*>("O"), pStop.get ()));
+        }
+        if (pCalled)
+        {
+            // join releases the GIL so the loop can finish
+            PyObjPtr pJoined (PyObject_CallMethod (
+                                  s_pThread, const_cast<char*>("join"),
+                                  NULL));
+            PyObjPtr pClosed (PyObject_CallMethod (
+                                  s_pLoop, const_cast<char*>("close"), NULL));
+        }
+        PyErr_Clear ();
+        Py_DECREF (s_pThread);
+        s_pThread = NULL;
+        Py_DECREF (s_pLoop);
+        s_pLoop = NULL;
+    }
+}
+
+
+/*static*/ int
+event_loop::start ()
+{
+    SCX_BOOKEND ("event_loop::start");
+    PyObjPtr pAsyncio (PyImport_ImportModule ("asyncio"));
+    PyObjPtr pThreading (PyImport_ImportModule ("threading"));
+    PyObjPtr pLoop;
+    if (pAsyncio && pThreading)
+    {
+        pLoop.reset (PyObject_CallMethod (
+                         pAsyncio.get (), const_cast<char*>("new_event_loop"),
+                         NULL));
+    }
+    PyObjPtr pRunForever;
+    if (pLoop)
+    {
+        pRunForever.reset (PyObject_GetAttrString (pLoop.get (),
+                                                   "run_forever"));
+    }
+    PyObjPtr pThread;
+    if (pRunForever)
+    {
+        PyObjPtr pArgs (PyTuple_New (0));
+        PyObjPtr pKeywords (Py_BuildValue ("{s:O,s:s,s:O}",
+                                           "target", pRunForever.get (),
+                                           "name", "omi event loop",
+                                           "daemon", Py_True));
+        PyObjPtr pThreadType (PyObject_GetAttrString (pThreading.get (),
+                                                      "Thread"));
+        if (pArgs && pKeywords && pThreadType)
+        {
+            pThread.reset (PyObject_Call (pThreadType.get (), pArgs.get (),
+                                          pKeywords.get ()));
+        }
+    }
+    int rval = EXIT_FAILURE;
+    if (pThread)
+    {
+        // the loop is published before the thread starts, start releases the
+        // GIL and another worker may submit meanwhile
+        s_pLoop = pLoop.release ();
+        s_pThread = pThread.release ();
+        PyObjPtr pStarted (PyObject_CallMethod (
+                               s_pThread, const_cast<char*>("start"), NULL));
+        if (pStarted)
+        {
+            rval = EXIT_SUCCESS;
+        }
+    }
+    if (EXIT_SUCCESS != rval)
+    {
+        SCX_BOOKEND_PRINT ("the event loop failed to start");
+    }
+    return rval;
+}
+
+
+/*static*/ PyObject*
+event_loop::on_done (
+    PyObject* pCapsule,
+    PyObject* pFuture)
+{
+    SCX_BOOKEND ("event_loop::on_done");
+    MI_Context::Ptr const& pContext =
+        *reinterpret_cast<MI_Context::Ptr*>(
+            PyCapsule_GetPointer (pCapsule, CONTEXT_CAPSULE_NAME));
+    // exception raises CancelledError for a cancelled coroutine
+    PyObjPtr pException (PyObject_CallMethod (
+                             pFuture, const_cast<char*>("exception"), NULL));
+    if (pException &&
+        Py_None != pException.get ())
+    {
+        PyErr_SetObject (reinterpret_cast<PyObject*>(
+                             Py_TYPE (pException.get ())),
+                         pException.get ());
+    }
+    if (PyErr_Occurred ())
+    {
+#if (PRINT_BOOKENDS == 1)
+        PyErr_Print ();
+#endif
+        PyErr_Clear ();
+    }
+    // as for a function, a request without a result has failed
+    if (!pContext->getResultSent ())
+    {
+        pContext->postResult (MI_RESULT_FAILED);
+    }
+    Py_RETURN_NONE;
+}
+
+
+/*static*/ void
+event_loop::free_context (
+    PyObject* pCapsule)
+{
+    delete reinterpret_cast<MI_Context::Ptr*>(
+        PyCapsule_GetPointer (pCapsule, CONTEXT_CAPSULE_NAME));
+}
@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#ifndef INCLUDED_EVENT_LOOP_HPP
+#define INCLUDED_EVENT_LOOP_HPP
+
+
+#include "Python.h"
+
+
+#include "mi_context.hpp"
+
+
+#include <pthread.h>
+
+
+namespace scx
+{
+
+
+// event_loop runs the coroutines returned by provider functions written as
+// "async def".  The client owns one asyncio event loop, run on a thread of
+// its own that is started with the first coroutine, so the requests that
+// are waiting in coroutines share that thread instead of each holding a
+// worker.  The request's result is deferred until its coroutine finishes.
+class event_loop
+{
+public:
+    // whether pObj is a coroutine to run on the loop
+    static bool isCoroutine (PyObject* const pObj);
+
+    // schedule the coroutine on the loop; the caller holds the GIL
+    static int submit (
+        PyObject* const pCoroutine,
+        MI_Context::Ptr const& pContext);
+
+    // stop the loop and wait for its thread to finish; the caller holds the
+    // GIL
+    static void stop ();
+
+private:
+    static int start ();
+
+    static PyObject* on_done (PyObject* pCapsule, PyObject* pFuture);
+    static void free_context (PyObject* pCapsule);
+
+    static char const CONTEXT_CAPSULE_NAME[];
+    static PyMethodDef ON_DONE_DEF;
+
+    static PyObject* s_pLoop;
+    static PyObject* s_pThread;
+    static pthread_mutex_t s_StartLock;
+};
+
+
+} // namespace scx
+
+
+#endif // INCLUDED_EVENT_LOOP_HPP
@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#ifndef INCLUDED_FAST_ARGS_HPP
+#define INCLUDED_FAST_ARGS_HPP
+
+
+#include "Python.h"
+
+
+#include "py_converter.hpp"
+#include "python_compatibility.hpp"
+
+
+#if (SCX_USE_FASTCALL)
+
+
+namespace scx
+{
+
+
+// parseFastArgs sorts the arguments of a METH_FASTCALL | METH_KEYWORDS call
+// (or of a vectorcall) into ppArgsOut in the order of KEYWORDS, the way
+// PyArg_ParseTupleAndKeywords does for a format of nRequired "O"s followed
+// by "|" and an "O" for each keyword left.  An argument that wasn't passed
+// is left NULL.  The positional arguments alone are the common case and are
+// copied without looking at KEYWORDS.
+inline int
+parseFastArgs (
+    PyObject* const* const args,
+    Py_ssize_t const nArgs,
+    PyObject* const kwNames,
+    char const* const* const KEYWORDS,
+    Py_ssize_t const nRequired,
+    PyObject** const ppArgsOut)
+{
+    Py_ssize_t nKeywords = 0;
+    while (NULL != KEYWORDS[nKeywords])
+    {
+        ppArgsOut[nKeywords++] = NULL;
+    }
+    int rval = nArgs <= nKeywords ? PY_SUCCESS : PY_FAILURE;
+    for (Py_ssize_t i = 0; PY_SUCCESS == rval && i < nArgs; ++i)
+    {
+        ppArgsOut[i] = args[i];
+    }
+    for (Py_ssize_t i = 0, count = kwNames ? PyTuple_GET_SIZE (kwNames) : 0;
+         PY_SUCCESS == rval && i < count;
+         ++i)
+    {
+        // a keyword that is unknown or names an argument that was already
+        // passed fails
+        PyObject* const pName = PyTuple_GET_ITEM (kwNames, i);
+        rval = PY_FAILURE;
+        for (Py_ssize_t j = 0; j < nKeywords; ++j)
+        {
+            if (0 == PyUnicode_CompareWithASCIIString (pName, KEYWORDS[j]))
+            {
+                if (NULL == ppArgsOut[j])
+                {
+                    ppArgsOut[j] = args[nArgs + i];
+                    rval = PY_SUCCESS;
+                }
+                break;
+            }
+        }
+    }
+    for (Py_ssize_t i = 0; PY_SUCCESS == rval && i < nRequired; ++i)
+    {
+        if (NULL == ppArgsOut[i])
+        {
+            rval = PY_FAILURE;
+        }
+    }
+    if (PY_SUCCESS != rval)
+    {
+        PyErr_SetString (PyExc_TypeError, "invalid arguments");
+    }
+    return rval;
+}
+
+
+} // namespace scx
+
+
+#endif // SCX_USE_FASTCALL
+
+
+#endif // INCLUDED_FAST_ARGS_HPP
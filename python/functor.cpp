@@ -3,6 +3,7 @@
 #include "functor.hpp"
 
 
+#include "gil_lock.hpp"
 #include "mi_context_wrapper.hpp"
 #include "mi_module_wrapper.hpp"
 #include "mi_instance_wrapper.hpp"
@@ -37,6 +38,7 @@ Load_Unload_Functor::operator () (
     scx::MI_Context::Ptr const& pContext) const
 {
     SCX_BOOKEND ("Load_Unload_Functor::operator ()");
+    gil_lock gil;
     int rval = EXIT_SUCCESS;
     MI_Module_Wrapper::PyPtr pyModule (
         MI_Module_Wrapper::createPyPtr (pModule));
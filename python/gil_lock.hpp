@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#ifndef INCLUDED_GIL_LOCK_HPP
+#define INCLUDED_GIL_LOCK_HPP
+
+
+#include "Python.h"
+
+
+#include "python_compatibility.hpp"
+
+
+namespace scx
+{
+
+
+// gil_lock holds the GIL for its lifetime.  The provider's functions are
+// called from the client's worker threads, which don't hold it otherwise.
+// It has to be declared before any Python object it protects so that it is
+// released last.
+class gil_lock
+{
+public:
+    /*ctor*/ gil_lock ()
+        : m_State (PyGILState_Ensure ())
+    {
+        // empty
+    }
+
+    /*dtor*/ ~gil_lock ()
+    {
+        PyGILState_Release (m_State);
+    }
+
+private:
+    /*ctor*/ gil_lock (gil_lock const&); // = delete
+    gil_lock& operator = (gil_lock const&); // = delete
+
+    PyGILState_STATE const m_State;
+};
+
+
+// release_gil_if_held and restore_gil are installed as the socket_wrapper
+// blocking hooks.  A thread that holds the GIL drops it while it waits on
+// the socket or the ring, so the provider's own threads keep running.
+inline void*
+release_gil_if_held ()
+{
+    void* pState = NULL;
+    if (SCX_GIL_HELD ())
+    {
+        pState = PyEval_SaveThread ();
+    }
+    return pState;
+}
+
+
+inline void
+restore_gil (
+    void* pState)
+{
+    if (NULL != pState)
+    {
+        PyEval_RestoreThread (reinterpret_cast<PyThreadState*>(pState));
+    }
+}
+
+
+} // namespace scx
+
+
+#endif // INCLUDED_GIL_LOCK_HPP
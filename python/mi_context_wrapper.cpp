@@ -3,7 +3,9 @@
 #include "mi_context_wrapper.hpp"
 
 
+#include "fast_args.hpp"
 #include "mi_instance_wrapper.hpp"
+#include "mi_schema.hpp"
 #include "mi_wrapper.hpp"
 
 
@@ -115,6 +117,102 @@ to_MI_Result (
 }
 
 
+// column is one column of PostColumns.  A column of native numbers that
+// supports the buffer protocol is read from its buffer without creating a
+// PyObject per item, any other column is read as a sequence.
+struct column
+{
+    MI_Uint32 ordinal;
+    TypeID_t type;
+    bool hasBuffer;
+    Py_buffer buffer;
+    PyObject* pSequence;
+};
+
+
+int
+open_column (
+    PyObject* pColumnObj,
+    column* pColumn)
+{
+    int rval = PY_FAILURE;
+    pColumn->hasBuffer = false;
+    pColumn->pSequence = NULL;
+    // only numeric and boolean types are read from a buffer, a buffer such
+    // as bytes for a string column is read as a sequence
+    if (MI_CHAR16 >= pColumn->type &&
+        PyObject_CheckBuffer (pColumnObj))
+    {
+        if (0 == PyObject_GetBuffer (pColumnObj, &pColumn->buffer,
+                                     PyBUF_FORMAT | PyBUF_STRIDES))
+        {
+            if (is_numeric_buffer (pColumn->buffer))
+            {
+                pColumn->hasBuffer = true;
+                rval = PY_SUCCESS;
+            }
+            else
+            {
+                PyBuffer_Release (&pColumn->buffer);
+            }
+        }
+        else
+        {
+            PyErr_Clear ();
+        }
+    }
+    if (!pColumn->hasBuffer)
+    {
+        pColumn->pSequence = PySequence_Fast (
+            pColumnObj,
+            "ERROR: MI_Context_Wrapper::postColumns a column is not a "
+            "sequence");
+        if (NULL != pColumn->pSequence)
+        {
+            rval = PY_SUCCESS;
+        }
+    }
+    return rval;
+}
+
+
+void
+close_column (
+    column* pColumn)
+{
+    if (pColumn->hasBuffer)
+    {
+        PyBuffer_Release (&pColumn->buffer);
+        pColumn->hasBuffer = false;
+    }
+    Py_XDECREF (pColumn->pSequence);
+    pColumn->pSequence = NULL;
+}
+
+
+Py_ssize_t
+get_column_size (
+    column const& col)
+{
+    return col.hasBuffer ?
+        col.buffer.shape[0] : PySequence_Fast_GET_SIZE (col.pSequence);
+}
+
+
+int
+get_cell (
+    column const& col,
+    Py_ssize_t row,
+    MI_ValueBase::Ptr* ppValueOut)
+{
+    return col.hasBuffer ?
+        bufferItem_to_MI_ValueBase (col.type, col.buffer, row, ppValueOut) :
+        to_MI_ValueBase (col.type,
+                         PySequence_Fast_GET_ITEM (col.pSequence, row),
+                         ppValueOut);
+}
+
+
 }
 
 
@@ -123,13 +221,31 @@ to_MI_Result (
 /*static*/ char const MI_Context_Wrapper::DOC[] =
     "omi.MI_Context utility";
 /*static*/ PyTypeObject MI_Context_Wrapper::s_PyTypeObject = {};
+/*static*/ char const* const MI_Context_Wrapper::POST_INSTANCE_KEYWORDS[] = {
+    "instance",
+    NULL
+};
 /*static*/ PyMethodDef MI_Context_Wrapper::METHODS[] = {
     { "PostResult",
       reinterpret_cast<PyCFunction>(MI_Context_Wrapper::postResult),
       METH_VARARGS | METH_KEYWORDS, "post a result to omi" },
+#if (SCX_USE_FASTCALL)
+    { "PostInstance",
+      reinterpret_cast<PyCFunction>(MI_Context_Wrapper::postInstanceFast),
+      METH_FASTCALL | METH_KEYWORDS, "return a MI_Instance to omi" },
+#else
     { "PostInstance",
       reinterpret_cast<PyCFunction>(MI_Context_Wrapper::postInstance),
       METH_VARARGS | METH_KEYWORDS, "return a MI_Instance to omi" },
+#endif
+    { "PostInstances",
+      reinterpret_cast<PyCFunction>(MI_Context_Wrapper::postInstances),
+      METH_VARARGS | METH_KEYWORDS,
+      "return each MI_Instance in an iterable to omi" },
+    { "PostColumns",
+      reinterpret_cast<PyCFunction>(MI_Context_Wrapper::postColumns),
+      METH_VARARGS | METH_KEYWORDS,
+      "return an MI_Instance to omi for each row of a dict of columns" },
     { "NewInstance",
       reinterpret_cast<PyCFunction>(MI_Context_Wrapper::newInstance),
       METH_VARARGS | METH_KEYWORDS, "create a new MI_Instance" },
@@ -237,39 +353,303 @@ MI_Context_Wrapper::postInstance (
     SCX_BOOKEND ("MI_Context_Wrapper::postInstance");
     PyObject* pRet = NULL;
     // parse the args
+    PyObject* pInstanceObj = NULL;
+    if (PyArg_ParseTupleAndKeywords (
+            args, keywords, "O", const_cast<char **>(POST_INSTANCE_KEYWORDS),
+            &pInstanceObj))
+    {
+        SCX_BOOKEND_PRINT ("PyArg_ParseTupleAndKeywords succeeded");
+        pRet = post_instance (pSelf, pInstanceObj);
+    }
+    else
+    {
+        SCX_BOOKEND_PRINT ("PyArg_ParseTupleAndKeywords failed");
+        PyErr_SetString (
+            PyExc_ValueError,
+            "ERROR: MI_Context_Wrapper::postInstance invalid arguments");
+    }
+    return pRet;
+}
+
+
+#if (SCX_USE_FASTCALL)
+/*static*/ PyObject*
+MI_Context_Wrapper::postInstanceFast (
+    PyObject* pSelf,
+    PyObject* const* args,
+    Py_ssize_t nArgs,
+    PyObject* kwNames)
+{
+    SCX_BOOKEND ("MI_Context_Wrapper::postInstanceFast");
+    PyObject* pRet = NULL;
+    PyObject* argv[1];
+    if (PY_SUCCESS == parseFastArgs (args, nArgs, kwNames,
+                                     POST_INSTANCE_KEYWORDS, 1, argv))
+    {
+        pRet = post_instance (pSelf, argv[0]);
+    }
+    else
+    {
+        PyErr_SetString (
+            PyExc_ValueError,
+            "ERROR: MI_Context_Wrapper::postInstance invalid arguments");
+    }
+    return pRet;
+}
+#endif // SCX_USE_FASTCALL
+
+
+/*static*/ PyObject*
+MI_Context_Wrapper::post_instance (
+    PyObject* pSelf,
+    PyObject* pInstanceObj)
+{
+    PyObject* pRet = NULL;
+    if (PyObject_TypeCheck (
+            pInstanceObj,
+            const_cast<PyTypeObject*>(
+                MI_Instance_Wrapper::getPyTypeObject ())))
+    {
+        MI_Context_Wrapper* pContext =
+            reinterpret_cast<MI_Context_Wrapper*>(pSelf);
+        MI_Instance_Wrapper* pInstance =
+            reinterpret_cast<MI_Instance_Wrapper*>(pInstanceObj);
+        int rval = pContext->m_pContext->postInstance (
+            pInstance->getInstance ());
+        if (socket_wrapper::SUCCESS == rval)
+        {
+            SCX_BOOKEND_PRINT ("MI_Instance was sent");
+            pRet = Py_None;
+        }
+        else
+        {
+            SCX_BOOKEND_PRINT ("sending MI_Instance failed");
+        }
+    }
+    else
+    {
+        SCX_BOOKEND_PRINT ("instance is not a MI_Instance");
+    }
+    Py_XINCREF (pRet);
+    return pRet;
+}
+
+
+/*static*/ PyObject*
+MI_Context_Wrapper::postInstances (
+    PyObject* pSelf,
+    PyObject* args,
+    PyObject* keywords)
+{
+    SCX_BOOKEND ("MI_Context_Wrapper::postInstances");
+    PyObject* pRet = NULL;
+    // parse the args
     char const* KEYWORDS[] = {
-        "instance",
+        "instances",
         NULL
     };
-    PyObject* pInstanceObj = NULL;
+    PyObject* pInstancesObj = NULL;
     if (PyArg_ParseTupleAndKeywords (
-            args, keywords, "O", const_cast<char **>(KEYWORDS), &pInstanceObj))
+            args, keywords, "O", const_cast<char **>(KEYWORDS),
+            &pInstancesObj))
     {
         SCX_BOOKEND_PRINT ("PyArg_ParseTupleAndKeywords succeeded");
-        if (PyObject_TypeCheck (
-                pInstanceObj,
-                const_cast<PyTypeObject*>(
-                    MI_Instance_Wrapper::getPyTypeObject ())))
+        // every item is checked before any of them is sent
+        PyObjPtr pIter (PyObject_GetIter (pInstancesObj));
+        MI_Context::instance_list instances;
+        bool valid = pIter;
+        for (PyObjPtr pItem (valid ? PyIter_Next (pIter.get ()) : NULL);
+             valid && pItem;
+             pItem.reset (PyIter_Next (pIter.get ())))
+        {
+            if (PyObject_TypeCheck (
+                    pItem.get (),
+                    const_cast<PyTypeObject*>(
+                        MI_Instance_Wrapper::getPyTypeObject ())))
+            {
+                instances.push_back (
+                    reinterpret_cast<MI_Instance_Wrapper*>(
+                        pItem.get ())->getInstance ());
+            }
+            else
+            {
+                SCX_BOOKEND_PRINT ("an item is not a MI_Instance");
+                PyErr_SetString (
+                    PyExc_ValueError,
+                    "ERROR: MI_Context_Wrapper::postInstances an item is "
+                    "not a MI_Instance");
+                valid = false;
+            }
+        }
+        if (valid &&
+            !PyErr_Occurred ())
         {
             MI_Context_Wrapper* pContext =
                 reinterpret_cast<MI_Context_Wrapper*>(pSelf);
-            MI_Instance_Wrapper* pInstance =
-                reinterpret_cast<MI_Instance_Wrapper*>(pInstanceObj);
-            int rval = pContext->m_pContext->postInstance (
-                pInstance->getInstance ());
+            int rval = pContext->m_pContext->postInstances (instances);
             if (socket_wrapper::SUCCESS == rval)
             {
-                SCX_BOOKEND_PRINT ("MI_Instance was sent");
+                SCX_BOOKEND_PRINT ("MI_Instances were sent");
                 pRet = Py_None;
             }
             else
             {
-                SCX_BOOKEND_PRINT ("sending MI_Instance failed");
+                SCX_BOOKEND_PRINT ("sending MI_Instances failed");
+            }
+        }
+    }
+    else
+    {
+        SCX_BOOKEND_PRINT ("PyArg_ParseTupleAndKeywords failed");
+        PyErr_SetString (
+            PyExc_ValueError,
+            "ERROR: MI_Context_Wrapper::postInstances invalid arguments");
+    }
+    Py_XINCREF (pRet);
+    return pRet;
+}
+
+
+/*static*/ PyObject*
+MI_Context_Wrapper::postColumns (
+    PyObject* pSelf,
+    PyObject* args,
+    PyObject* keywords)
+{
+    SCX_BOOKEND ("MI_Context_Wrapper::postColumns");
+    PyObject* pRet = NULL;
+    // parse the args
+    char const* KEYWORDS[] = {
+        "className",
+        "columns",
+        NULL
+    };
+    PyObject* pNameObj = NULL;
+    PyObject* pColumnsObj = NULL;
+    MI_Type<MI_STRING>::type_t name;
+    if (PyArg_ParseTupleAndKeywords (
+            args, keywords, "OO!", const_cast<char **>(KEYWORDS),
+            &pNameObj, &PyDict_Type, &pColumnsObj) &&
+        PY_SUCCESS == fromPyObject (pNameObj, &name))
+    {
+        SCX_BOOKEND_PRINT ("PyArg_ParseTupleAndKeywords succeeded");
+        MI_Context_Wrapper* pContext =
+            reinterpret_cast<MI_Context_Wrapper*>(pSelf);
+        MI_Instance::Ptr pTemplate;
+        int rval = pContext->m_pContext->newInstance (
+            MI_Value<MI_STRING>::ConstPtr (string_table::intern (name)),
+            &pTemplate);
+        if (0 == rval &&
+            pTemplate)
+        {
+            util::internal_counted_ptr<MI_ObjectDecl const> const& pDecl =
+                pTemplate->getObjectDecl ();
+            // find the property for each column
+            std::vector<column> columns;
+            columns.reserve (PyDict_Size (pColumnsObj));
+            Py_ssize_t nRows = 0;
+            Py_ssize_t pos = 0;
+            PyObject* pKeyObj = NULL;
+            PyObject* pColumnObj = NULL;
+            while (0 == rval &&
+                   PyDict_Next (pColumnsObj, &pos, &pKeyObj, &pColumnObj))
+            {
+                MI_Type<MI_STRING>::type_t propertyName;
+                column col;
+                rval = fromPyObject (pKeyObj, &propertyName);
+                if (PY_SUCCESS == rval)
+                {
+                    col.ordinal = pDecl->getParameterOrdinal (propertyName);
+                    if (pDecl->getParameterDecls ().size () > col.ordinal)
+                    {
+                        col.type = pDecl->getParameterDecls ()[
+                            col.ordinal]->getType ()->getValue ();
+                        rval = open_column (pColumnObj, &col);
+                    }
+                    else
+                    {
+                        rval = PY_FAILURE;
+                    }
+                }
+                if (PY_SUCCESS == rval)
+                {
+                    columns.push_back (col);
+                    if (1 == columns.size ())
+                    {
+                        nRows = get_column_size (col);
+                    }
+                    else if (nRows != get_column_size (col))
+                    {
+                        SCX_BOOKEND_PRINT ("the columns are not the same size");
+                        PyErr_SetString (
+                            PyExc_ValueError,
+                            "ERROR: MI_Context_Wrapper::postColumns the "
+                            "columns are not the same size");
+                        rval = PY_FAILURE;
+                    }
+                }
+                else if (!PyErr_Occurred ())
+                {
+                    SCX_BOOKEND_PRINT ("a column is not a property");
+                    PyErr_SetObject (PyExc_KeyError, pKeyObj);
+                }
+            }
+            // every row is converted before any of them is sent
+            MI_Context::instance_list instances;
+            instances.reserve (0 == rval ? nRows : 0);
+            for (Py_ssize_t row = 0; 0 == rval && row < nRows; ++row)
+            {
+                MI_Instance::Ptr pInstance (new MI_Instance (pDecl));
+                for (std::vector<column>::const_iterator
+                         colPos = columns.begin (),
+                         colEndPos = columns.end ();
+                     0 == rval && colPos != colEndPos;
+                     ++colPos)
+                {
+                    MI_ValueBase::Ptr pValue;
+                    rval = get_cell (*colPos, row, &pValue);
+                    if (PY_SUCCESS == rval)
+                    {
+                        rval = pInstance->setValueAt (colPos->ordinal, pValue);
+                    }
+                    if (0 != rval &&
+                        !PyErr_Occurred ())
+                    {
+                        SCX_BOOKEND_PRINT ("a value could not be converted");
+                        PyErr_Format (
+                            PyExc_TypeError,
+                            "ERROR: MI_Context_Wrapper::postColumns row %zd "
+                            "of a column can't be converted to the type of "
+                            "its property", row);
+                    }
+                }
+                instances.push_back (pInstance);
+            }
+            for (std::vector<column>::iterator colPos = columns.begin (),
+                     colEndPos = columns.end ();
+                 colPos != colEndPos;
+                 ++colPos)
+            {
+                close_column (&*colPos);
+            }
+            if (0 == rval)
+            {
+                rval = pContext->m_pContext->postInstances (instances);
+                if (socket_wrapper::SUCCESS == rval)
+                {
+                    SCX_BOOKEND_PRINT ("MI_Instances were sent");
+                    pRet = Py_None;
+                }
+                else
+                {
+                    SCX_BOOKEND_PRINT ("sending MI_Instances failed");
+                }
             }
         }
         else
         {
-            SCX_BOOKEND_PRINT ("instance is not a MI_Instance");
+            SCX_BOOKEND_PRINT ("Class name not a member of MI_SchemaDecl");
+            PyErr_SetObject (PyExc_KeyError, pNameObj);
         }
     }
     else
@@ -277,7 +657,7 @@ MI_Context_Wrapper::postInstance (
         SCX_BOOKEND_PRINT ("PyArg_ParseTupleAndKeywords failed");
         PyErr_SetString (
             PyExc_ValueError,
-            "ERROR: MI_Context_Wrapper::postInstance invalid arguments");
+            "ERROR: MI_Context_Wrapper::postColumns invalid arguments");
     }
     Py_XINCREF (pRet);
     return pRet;
@@ -308,7 +688,7 @@ MI_Context_Wrapper::newInstance (
                 reinterpret_cast<MI_Context_Wrapper*>(pSelf);
             MI_Instance::Ptr pInstance;
             MI_Value<MI_STRING>::ConstPtr pName (
-                new MI_Value<MI_STRING> (name));
+                string_table::intern (name));
             ret = pContext->m_pContext->newInstance (pName, &pInstance);
             if (0 == ret)
             {
@@ -387,10 +767,10 @@ MI_Context_Wrapper::newParameters (
 
             MI_Instance::Ptr pInstance;
             MI_Value<MI_STRING>::ConstPtr pClassName (
-                new MI_Value<MI_STRING> (className));
+                string_table::intern (className));
 
             MI_Value<MI_STRING>::ConstPtr pMethodName (
-                new MI_Value<MI_STRING> (methodName));
+                string_table::intern (methodName));
 
 
             ret = pContext->m_pContext->newParameters (
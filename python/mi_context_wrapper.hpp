@@ -9,6 +9,7 @@
 
 #include "mi_context.hpp"
 #include "py_ptr.hpp"
+#include "python_compatibility.hpp"
 
 
 namespace scx
@@ -33,6 +34,22 @@ public:
     static PyObject* postInstance (PyObject* pSelf,
                                    PyObject* args,
                                    PyObject* keywords);
+#if (SCX_USE_FASTCALL)
+    static PyObject* postInstanceFast (PyObject* pSelf,
+                                       PyObject* const* args,
+                                       Py_ssize_t nArgs,
+                                       PyObject* kwNames);
+#endif
+
+    static PyObject* postInstances (PyObject* pSelf,
+                                    PyObject* args,
+                                    PyObject* keywords);
+
+    // PostColumns posts an instance of a class for each row of a dict that
+    // maps property names to columns of the same length
+    static PyObject* postColumns (PyObject* pSelf,
+                                  PyObject* args,
+                                  PyObject* keywords);
 
     static PyObject* newInstance (PyObject* pSelf,
                                   PyObject* args,
@@ -51,9 +68,12 @@ public:
     /*dtor*/ ~MI_Context_Wrapper ();
 
 private:
+    static PyObject* post_instance (PyObject* pSelf, PyObject* pInstanceObj);
+
     static char const NAME[];
     static char const OMI_NAME[];
     static char const DOC[];
+    static char const* const POST_INSTANCE_KEYWORDS[];
     static PyMethodDef METHODS[];
     static PyTypeObject s_PyTypeObject;
 
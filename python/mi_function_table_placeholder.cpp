@@ -3,7 +3,9 @@
 #include "mi_function_table_placeholder.hpp"
 
 
+#include "event_loop.hpp"
 #include "functor.hpp"
+#include "gil_lock.hpp"
 #include "mi_schema_wrapper.hpp"
 #include "mi_context_wrapper.hpp"
 #include "mi_function_table.hpp"
@@ -49,6 +51,78 @@ void evaluatePythonErrorState(int& rval, PyObjPtr& pRval){
 }
 
 
+// An EnumerateInstances function may return an iterator of instances (a
+// generator, typically) instead of posting them itself.  The instances are
+// pulled and posted a batch at a time, so the batch is all that is held in
+// memory, and pulling waits while postInstances waits for the socket or the
+// ring to have room.  MI_RESULT_OK is posted after the last one unless the
+// provider has posted a result of its own.
+int postInstancesFrom (
+    PyObject* const pIter,
+    MI_Context::Ptr const& pContext)
+{
+    SCX_BOOKEND ("postInstancesFrom");
+    int rval = EXIT_SUCCESS;
+    bool done = false;
+    MI_Context::instance_list instances;
+    instances.reserve (MI_Context::MAX_INSTANCE_BATCH);
+    while (EXIT_SUCCESS == rval &&
+           !done)
+    {
+        instances.clear ();
+        while (EXIT_SUCCESS == rval &&
+               !done &&
+               MI_Context::MAX_INSTANCE_BATCH > instances.size ())
+        {
+            PyObjPtr pItem (PyIter_Next (pIter));
+            if (!pItem)
+            {
+                // the end, or an exception raised by the iterator
+                done = true;
+                rval = PyErr_Occurred () ? EXIT_FAILURE : EXIT_SUCCESS;
+            }
+            else if (PyObject_TypeCheck (
+                         pItem.get (),
+                         const_cast<PyTypeObject*>(
+                             MI_Instance_Wrapper::getPyTypeObject ())))
+            {
+                instances.push_back (
+                    reinterpret_cast<MI_Instance_Wrapper*>(
+                        pItem.get ())->getInstance ());
+            }
+            else
+            {
+                PyErr_SetString (
+                    PyExc_TypeError,
+                    "EnumerateInstances yielded an item that is not a "
+                    "MI_Instance");
+                rval = EXIT_FAILURE;
+            }
+        }
+        if (EXIT_SUCCESS == rval &&
+            !instances.empty () &&
+            socket_wrapper::SUCCESS != pContext->postInstances (instances))
+        {
+            SCX_BOOKEND_PRINT ("postInstances failed");
+            rval = EXIT_FAILURE;
+        }
+    }
+#if (PRINT_BOOKENDS == 1)
+    if (PyErr_Occurred ())
+    {
+        PyErr_Print ();
+    }
+#endif
+    PyErr_Clear ();
+    if (EXIT_SUCCESS == rval &&
+        !pContext->getResultSent ())
+    {
+        pContext->postResult (MI_RESULT_OK);
+    }
+    return rval;
+}
+
+
 class U_Functor
 {
 public:
@@ -68,6 +142,7 @@ public:
         MI_Context::Ptr const& pContext) const
     {
         SCX_BOOKEND ("U_Functor::operator ()");
+        gil_lock gil;
         int rval = EXIT_SUCCESS;
         MI_Context_Wrapper::PyPtr pyContext (
             MI_Context_Wrapper::createPyPtr (pContext));
@@ -81,6 +156,11 @@ public:
                 PyObjPtr pRval (PyObject_CallObject (
                                     m_pFn.get (), pArgs.get ()));
                 evaluatePythonErrorState(rval, pRval);
+                if (EXIT_SUCCESS == rval &&
+                    event_loop::isCoroutine (pRval.get ()))
+                {
+                    rval = event_loop::submit (pRval.get (), pContext);
+                }
             }
         }
         else
@@ -119,6 +199,7 @@ public:
         MI_PropertySet::ConstPtr const& pPropertySet) const
     {
         SCX_BOOKEND ("GM_Functor::operator ()");
+        gil_lock gil;
         int rval = EXIT_SUCCESS;
         MI_Context_Wrapper::PyPtr pyContext (
             MI_Context_Wrapper::createPyPtr (pContext));
@@ -169,6 +250,11 @@ public:
                                     m_pFn.get (), pArgs.get ()));
 
                 evaluatePythonErrorState(rval, pRval);
+                if (EXIT_SUCCESS == rval &&
+                    event_loop::isCoroutine (pRval.get ()))
+                {
+                    rval = event_loop::submit (pRval.get (), pContext);
+                }
             }
         }
         else
@@ -206,6 +292,7 @@ public:
         MI_Instance::Ptr const& pInstance) const
     {
         SCX_BOOKEND ("CD_Functor::operator ()");
+        gil_lock gil;
         int rval = EXIT_SUCCESS;
         MI_Context_Wrapper::PyPtr pyContext (
             MI_Context_Wrapper::createPyPtr (pContext));
@@ -238,6 +325,11 @@ public:
                                     m_pFn.get (), pArgs.get ()));
 
                 evaluatePythonErrorState(rval, pRval);
+                if (EXIT_SUCCESS == rval &&
+                    event_loop::isCoroutine (pRval.get ()))
+                {
+                    rval = event_loop::submit (pRval.get (), pContext);
+                }
             }
         }
         else
@@ -276,6 +368,7 @@ public:
         MI_Value<MI_BOOLEAN>::Ptr const& pKeysOnly) const
     {
         SCX_BOOKEND ("E_Functor::operator ()");
+        gil_lock gil;
         int rval = EXIT_SUCCESS;
         MI_Context_Wrapper::PyPtr pyContext (
             MI_Context_Wrapper::createPyPtr (pContext));
@@ -324,6 +417,16 @@ public:
                 PyObjPtr pRval (PyObject_CallObject (
                                     m_pFn.get (), pArgs.get ()));
                 evaluatePythonErrorState(rval, pRval);
+                if (EXIT_SUCCESS == rval &&
+                    event_loop::isCoroutine (pRval.get ()))
+                {
+                    rval = event_loop::submit (pRval.get (), pContext);
+                }
+                else if (EXIT_SUCCESS == rval &&
+                         PyIter_Check (pRval.get ()))
+                {
+                    rval = postInstancesFrom (pRval.get (), pContext);
+                }
             }
         }
         else
@@ -363,6 +466,7 @@ public:
         MI_Instance::Ptr const& pInputParameters) const
     {
         SCX_BOOKEND ("I_Functor::operator ()");
+        gil_lock gil;
         int rval = EXIT_SUCCESS;
         MI_Context_Wrapper::PyPtr pyContext (
             MI_Context_Wrapper::createPyPtr (pContext));
@@ -408,6 +512,11 @@ public:
                                     m_pFn.get (), pArgs.get ()));
 
                 evaluatePythonErrorState(rval, pRval);
+                if (EXIT_SUCCESS == rval &&
+                    event_loop::isCoroutine (pRval.get ()))
+                {
+                    rval = event_loop::submit (pRval.get (), pContext);
+                }
             }
         }
         else
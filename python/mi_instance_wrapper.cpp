@@ -1,9 +1,13 @@
 // Copyright (c) Microsoft Corporation.  All rights reserved.
 // Licensed under the MIT license.
 #include "mi_instance_wrapper.hpp"
+#include "fast_args.hpp"
 #include "mi_wrapper.hpp"
 #include "mi_schema.hpp"
 
+
+#include <strings.h>
+
 using namespace scx;
 
 
@@ -432,6 +436,12 @@ convertToBase (
             SCX_BOOKEND_PRINT ("Encountered an unhandled type");
             break;
         }
+        if (PY_SUCCESS != ret)
+        {
+            // a plain Python value (int, str, float, bool, bytes, list) is
+            // converted straight to the declared type
+            ret = to_MI_ValueBase (type, pValueObj, ppValueOut);
+        }
     }
     else
     {
@@ -448,6 +458,7 @@ convertToBase (
     MI_ValueBase::Ptr* ppValueOut)
 {
     int ret = PY_FAILURE;
+    scx::MI_Datetime::Ptr pDatetime;
     if (pValueObj != Py_None)
     {
         if (PyObject_TypeCheck (
@@ -585,6 +596,13 @@ convertToBase (
                     pValueObj)->getValue ());
             ret = PY_SUCCESS;
         }
+        else if (PY_SUCCESS ==
+                 datetime_to_MI_Datetime (pValueObj, &pDatetime))
+        {
+            //SCX_BOOKEND_PRINT ("datetime");
+            *ppValueOut = pDatetime.get ();
+            ret = PY_SUCCESS;
+        }
         else if (PyObject_TypeCheck (
                      pValueObj,
                      scx::MI_Array_Wrapper<MI_BOOLEANA>::getPyTypeObject ()))
@@ -735,6 +753,178 @@ convertToBase (
 }
 
 
+// wrap_base wraps pValue in the Python type for its MI type, None if pValue
+// is NULL
+PyObject*
+wrap_base (
+    MI_ValueBase::Ptr const& pValue)
+{
+    PyObject* rval = NULL;
+    if (pValue)
+    {
+        //SCX_BOOKEND_PRINT ("value is not NULL");
+        switch (pValue->getType ())
+        {
+        case MI_BOOLEAN:
+            rval = wrap_value<MI_BOOLEAN> (pValue);
+            break;
+        case MI_UINT8:
+            rval = wrap_value<MI_UINT8> (pValue);
+            break;
+        case MI_SINT8:
+            rval = wrap_value<MI_SINT8> (pValue);
+            break;
+        case MI_UINT16:
+            rval = wrap_value<MI_UINT16> (pValue);
+            break;
+        case MI_SINT16:
+            rval = wrap_value<MI_SINT16> (pValue);
+            break;
+        case MI_UINT32:
+            rval = wrap_value<MI_UINT32> (pValue);
+            break;
+        case MI_SINT32:
+            rval = wrap_value<MI_SINT32> (pValue);
+            break;
+        case MI_UINT64:
+            rval = wrap_value<MI_UINT64> (pValue);
+            break;
+        case MI_SINT64:
+            rval = wrap_value<MI_SINT64> (pValue);
+            break;
+        case MI_REAL32:
+            rval = wrap_value<MI_REAL32> (pValue);
+            break;
+        case MI_REAL64:
+            rval = wrap_value<MI_REAL64> (pValue);
+            break;
+        case MI_CHAR16:
+            rval = wrap_value<MI_CHAR16> (pValue);
+            break;
+        case MI_DATETIME:
+            rval = wrap_datetime (pValue);
+            break;
+        case MI_STRING:
+            rval = wrap_value<MI_STRING> (pValue);
+            break;
+        case MI_REFERENCE:
+            SCX_BOOKEND_PRINT ("encountered an unhandled type");
+            Py_INCREF (Py_None);
+            rval = Py_None;
+            break;
+        case MI_INSTANCE:
+//                        SCX_BOOKEND_PRINT ("encountered an unhandled type");
+//                        Py_INCREF (Py_None);
+//                        rval = Py_None;
+            rval = wrap_instance (pValue);
+            break;
+        case MI_BOOLEANA:
+            rval = wrap_array<MI_BOOLEANA> (pValue);
+            break;
+        case MI_UINT8A:
+            rval = wrap_array<MI_UINT8A> (pValue);
+            break;
+        case MI_SINT8A:
+            rval = wrap_array<MI_SINT8A> (pValue);
+            break;
+        case MI_UINT16A:
+            rval = wrap_array<MI_UINT16A> (pValue);
+            break;
+        case MI_SINT16A:
+            rval = wrap_array<MI_SINT16A> (pValue);
+            break;
+        case MI_UINT32A:
+            rval = wrap_array<MI_UINT32A> (pValue);
+            break;
+        case MI_SINT32A:
+            rval = wrap_array<MI_SINT32A> (pValue);
+            break;
+        case MI_UINT64A:
+            rval = wrap_array<MI_UINT64A> (pValue);
+            break;
+        case MI_SINT64A:
+            rval = wrap_array<MI_SINT64A> (pValue);
+            break;
+        case MI_REAL32A:
+            rval = wrap_array<MI_REAL32A> (pValue);
+            break;
+        case MI_REAL64A:
+            rval = wrap_array<MI_REAL64A> (pValue);
+            break;
+        case MI_CHAR16A:
+            rval = wrap_array<MI_CHAR16A> (pValue);
+            break;
+        case MI_DATETIMEA:
+            rval = wrap_array<MI_DATETIMEA> (pValue);
+            break;
+        case MI_STRINGA:
+            rval = wrap_array<MI_STRINGA> (pValue);
+            break;
+        case MI_REFERENCEA:
+        case MI_INSTANCEA:
+        default:
+            SCX_BOOKEND_PRINT ("encountered an unhandled type");
+            Py_INCREF (Py_None);
+            rval = Py_None;
+            break;
+        }
+    }
+    else
+    {
+        //SCX_BOOKEND_PRINT ("value is NULL");
+        Py_INCREF (Py_None);
+        rval = Py_None;
+    }
+    return rval;
+}
+
+
+// wrap_native is wrap_base for the instances of a declared class: datetime
+// values are returned as datetime.datetime and datetime.timedelta (and
+// arrays of them as lists) rather than wrapped.  A value the datetime module
+// can't hold is wrapped all the same.
+PyObject*
+wrap_native (
+    MI_ValueBase::Ptr const& pValue)
+{
+    PyObject* rval = NULL;
+    if (pValue &&
+        MI_DATETIME == pValue->getType ())
+    {
+        rval = MI_Datetime_to_PyObject (
+            *static_cast<scx::MI_Datetime*>(pValue.get ()));
+        if (NULL == rval)
+        {
+            PyErr_Clear ();
+            rval = wrap_datetime (pValue);
+        }
+    }
+    else if (pValue &&
+             MI_DATETIMEA == pValue->getType ())
+    {
+        scx::MI_Array<MI_DATETIMEA> const& array =
+            *static_cast<scx::MI_Array<MI_DATETIMEA>*>(pValue.get ());
+        rval = PyList_New (array.size ());
+        for (size_t i = 0; NULL != rval && i < array.size (); ++i)
+        {
+            scx::MI_Datetime::Ptr pItem (array.getValueAt (i));
+            PyObject* pItemObj = MI_Datetime_to_PyObject (*pItem);
+            if (NULL == pItemObj)
+            {
+                PyErr_Clear ();
+                pItemObj = wrap_datetime (pItem);
+            }
+            PyList_SET_ITEM (rval, i, pItemObj);
+        }
+    }
+    else
+    {
+        rval = wrap_base (pValue);
+    }
+    return rval;
+}
+
+
 }
 
 
@@ -743,15 +933,50 @@ convertToBase (
 /*static*/ char const MI_Instance_Wrapper::DOC[] =
     "omi.MI_Instance utility";
 /*static*/ PyTypeObject MI_Instance_Wrapper::s_PyTypeObject = {};
+/*static*/ MI_Instance_Wrapper::class_type_map_t
+    MI_Instance_Wrapper::s_ClassTypes;
+/*static*/ MI_Instance_Wrapper::class_decl_map_t
+    MI_Instance_Wrapper::s_ClassDecls;
+/*static*/ char const* const MI_Instance_Wrapper::GET_VALUE_KEYWORDS[] = {
+    "name",
+    NULL
+};
+/*static*/ char const* const MI_Instance_Wrapper::GET_CLASS_TYPE_KEYWORDS[] = {
+    "name",
+    NULL
+};
+/*static*/ char const* const MI_Instance_Wrapper::SET_VALUE_KEYWORDS[] = {
+    "name",
+    "value",
+    NULL
+};
 /*static*/ PyMethodDef MI_Instance_Wrapper::METHODS[] = {
+#if (SCX_USE_FASTCALL)
+    { "GetValue",
+      reinterpret_cast<PyCFunction>(MI_Instance_Wrapper::getValueFast),
+      METH_FASTCALL | METH_KEYWORDS, "retrieve a value from the instance" },
+    { "SetValue",
+      reinterpret_cast<PyCFunction>(MI_Instance_Wrapper::setValueFast),
+      METH_FASTCALL | METH_KEYWORDS, "set a value for the instance" },
+#else
     { "GetValue",
       reinterpret_cast<PyCFunction>(MI_Instance_Wrapper::getValue),
       METH_VARARGS | METH_KEYWORDS, "retrieve a value from the instance" },
     { "SetValue",
       reinterpret_cast<PyCFunction>(MI_Instance_Wrapper::setValue),
       METH_VARARGS | METH_KEYWORDS, "set a value for the instance" },
+#endif
+    { "GetClassType",
+      reinterpret_cast<PyCFunction>(MI_Instance_Wrapper::getClassType),
+      METH_VARARGS | METH_KEYWORDS | METH_STATIC,
+      "retrieve the type made for a class of the schema" },
     { NULL, NULL, 0, NULL }
 };
+/*static*/ PyMappingMethods MI_Instance_Wrapper::MAPPING_METHODS = {
+    NULL,
+    MI_Instance_Wrapper::subscript,
+    MI_Instance_Wrapper::ass_subscript
+};
 
 
 /*static*/ void
@@ -763,13 +988,16 @@ MI_Instance_Wrapper::moduleInit (
     s_PyTypeObject.tp_name = OMI_NAME;
     s_PyTypeObject.tp_basicsize = sizeof (MI_Instance_Wrapper);
     s_PyTypeObject.tp_dealloc = dealloc;
-    s_PyTypeObject.tp_flags = Py_TPFLAGS_DEFAULT;
+    // the class types made by createClassTypes derive from this type
+    s_PyTypeObject.tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE;
     s_PyTypeObject.tp_doc = DOC;
     s_PyTypeObject.tp_init = init;
     s_PyTypeObject.tp_new = PyType_GenericNew;
     s_PyTypeObject.tp_alloc = PyType_GenericAlloc;
     s_PyTypeObject.tp_methods = METHODS;
-    if (0 == PyType_Ready (&s_PyTypeObject))
+    s_PyTypeObject.tp_as_mapping = &MAPPING_METHODS;
+    if (0 == PyType_Ready (&s_PyTypeObject) &&
+        PY_SUCCESS == MI_Property_Descriptor::moduleInit ())
     {
         Py_INCREF (&s_PyTypeObject);
         PyModule_AddObject (
@@ -799,19 +1027,49 @@ MI_Instance_Wrapper::createPyPtr (
         MI_Instance::Ptr const& pInstance)
 {
     //SCX_BOOKEND ("MI_Instance_Wrapper::createPyPtr");
-    PyObjPtr pPyWrapper (s_PyTypeObject.tp_alloc (&s_PyTypeObject, 0));
-    if (pPyWrapper)
+    PyPtr pyInstance (alloc (pInstance.get ()), DO_NOT_INC_REF);
+    if (pyInstance)
+    {
+        pyInstance->ctor (pInstance);
+    }
+    return pyInstance;
+}
+
+
+#if (UTIL_HAS_RVALUE_REFERENCES)
+/*static*/
+MI_Instance_Wrapper::PyPtr
+MI_Instance_Wrapper::createPyPtr (
+        MI_Instance::Ptr&& pInstance)
+{
+    //SCX_BOOKEND ("MI_Instance_Wrapper::createPyPtr");
+    PyPtr pyInstance (alloc (pInstance.get ()), DO_NOT_INC_REF);
+    if (pyInstance)
     {
-        SCX_BOOKEND_PRINT ("instance wrapper allocated");
-        MI_Instance_Wrapper* pWrapper =
-            reinterpret_cast<MI_Instance_Wrapper*>(pPyWrapper.get ());
-        pWrapper->ctor (pInstance);
-        return PyPtr (
-            reinterpret_cast<MI_Instance_Wrapper*>(pPyWrapper.release ()),
-            DO_NOT_INC_REF);
+        pyInstance->ctor (MI_Instance::Ptr ());
+        pyInstance->m_pInstance = UTIL_MOVE (pInstance);
     }
-    //SCX_BOOKEND_PRINT ("instance was not allocated");
-    return PyPtr ();
+    return pyInstance;
+}
+#endif
+
+
+/*static*/
+MI_Instance_Wrapper*
+MI_Instance_Wrapper::alloc (
+    MI_Instance const* const pInstance)
+{
+    PyTypeObject* pType = &s_PyTypeObject;
+    if (pInstance && pInstance->getObjectDecl ())
+    {
+        class_type_map_t::const_iterator pos =
+            s_ClassTypes.find (pInstance->getObjectDecl ().get ());
+        if (s_ClassTypes.end () != pos)
+        {
+            pType = reinterpret_cast<PyTypeObject*>(pos->second.pType);
+        }
+    }
+    return reinterpret_cast<MI_Instance_Wrapper*>(pType->tp_alloc (pType, 0));
 }
 
 
@@ -822,6 +1080,88 @@ MI_Instance_Wrapper::getPyTypeObject ()
 }
 
 
+/*static*/ int
+MI_Instance_Wrapper::createClassTypes (
+    MI_SchemaDecl const& schemaDecl)
+{
+    SCX_BOOKEND ("MI_Instance_Wrapper::createClassTypes");
+    int rval = PY_SUCCESS;
+    for (std::vector<MI_ClassDecl::Ptr>::const_iterator
+             pos = schemaDecl.getClassDecls ().begin (),
+             endPos = schemaDecl.getClassDecls ().end ();
+         PY_SUCCESS == rval && pos != endPos;
+         ++pos)
+    {
+        rval = create_class_type (*pos);
+        for (std::vector<MI_MethodDecl::Ptr>::const_iterator
+                 methodPos = (*pos)->getMethodDecls ().begin (),
+                 methodEndPos = (*pos)->getMethodDecls ().end ();
+             PY_SUCCESS == rval && methodPos != methodEndPos;
+             ++methodPos)
+        {
+            rval = create_class_type (*methodPos);
+        }
+    }
+    return rval;
+}
+
+
+/*static*/ PyObject*
+MI_Instance_Wrapper::getValueAt (
+    PyObject* pSelf,
+    MI_Uint32 const& ordinal)
+{
+    PyObject* rval = NULL;
+    MI_ValueBase::Ptr pValue;
+    if (0 == reinterpret_cast<MI_Instance_Wrapper*>(
+            pSelf)->m_pInstance->getValueAt (ordinal, &pValue))
+    {
+        rval = wrap_native (pValue);
+    }
+    else
+    {
+        PyErr_SetString (PyExc_AttributeError,
+                         "the ordinal is not a member of the instance");
+    }
+    return rval;
+}
+
+
+/*static*/ int
+MI_Instance_Wrapper::setValueAt (
+    PyObject* pSelf,
+    MI_Uint32 const& ordinal,
+    PyObject* pValueObj)
+{
+    int rval = PY_FAILURE;
+    MI_Instance::Ptr const& pInstance =
+        reinterpret_cast<MI_Instance_Wrapper*>(pSelf)->m_pInstance;
+    if (pInstance->getObjectDecl () &&
+        ordinal < pInstance->getObjectDecl ()->getParameterDecls ().size ())
+    {
+        MI_ValueBase::Ptr pValue;
+        // a NULL pValueObj (del) removes the value
+        if (NULL == pValueObj ||
+            PY_SUCCESS == convertToBase (
+                pInstance->getObjectDecl ()->getParameterDecls ()[
+                    ordinal]->getType ()->getValue (),
+                pValueObj, &pValue))
+        {
+            if (0 == pInstance->setValueAt (ordinal, pValue))
+            {
+                rval = PY_SUCCESS;
+            }
+        }
+    }
+    if (PY_FAILURE == rval &&
+        !PyErr_Occurred ())
+    {
+        PyErr_SetString (PyExc_TypeError, "invalid value");
+    }
+    return rval;
+}
+
+
 /*static*/ int
 MI_Instance_Wrapper::init (
     PyObject* pSelf,
@@ -832,7 +1172,22 @@ MI_Instance_Wrapper::init (
     int rval = PY_FAILURE;
     MI_Instance_Wrapper* pInstance =
         reinterpret_cast<MI_Instance_Wrapper*>(pSelf);
-    pInstance->ctor (MI_Instance::Ptr (new MI_Instance (MI_ClassDecl::Ptr ())));
+    // an instance created by calling a class type, or a python subclass of
+    // one, is an instance of the nearest class type's declaration
+    MI_ObjectDecl::ConstPtr pObjectDecl;
+    PyObject* const pMRO = Py_TYPE (pSelf)->tp_mro;
+    for (Py_ssize_t i = 0;
+         !pObjectDecl && NULL != pMRO && i < PyTuple_GET_SIZE (pMRO);
+         ++i)
+    {
+        class_decl_map_t::const_iterator pos =
+            s_ClassDecls.find (PyTuple_GET_ITEM (pMRO, i));
+        if (s_ClassDecls.end () != pos)
+        {
+            pObjectDecl = pos->second;
+        }
+    }
+    pInstance->ctor (MI_Instance::Ptr (new MI_Instance (pObjectDecl)));
     char const* KEYWORDS[] = {
         NULL
     };
@@ -849,6 +1204,44 @@ MI_Instance_Wrapper::init (
 }
 
 
+/*static*/
+PyObject*
+MI_Instance_Wrapper::getClassType (
+    PyObject* pSelf,
+    PyObject* args,
+    PyObject* keywords)
+{
+    //SCX_BOOKEND ("MI_Instance_Wrapper::getClassType");
+    PyObject* rval = NULL;
+    char const* className = NULL;
+    if (PyArg_ParseTupleAndKeywords (
+            args, keywords, "s", const_cast<char **>(GET_CLASS_TYPE_KEYWORDS),
+            &className))
+    {
+        // class names are compared without regard to case, as CIM names are
+        for (class_type_map_t::const_iterator pos = s_ClassTypes.begin (),
+                 endPos = s_ClassTypes.end ();
+             NULL == rval && pos != endPos;
+             ++pos)
+        {
+            if (!pos->second.pObjectDecl->isMethodDecl () &&
+                0 == strcasecmp (
+                    className,
+                    pos->second.pObjectDecl->getName ()->getValue ().c_str ()))
+            {
+                rval = pos->second.pType;
+                Py_INCREF (rval);
+            }
+        }
+        if (NULL == rval)
+        {
+            PyErr_SetString (PyExc_KeyError, className);
+        }
+    }
+    return rval;
+}
+
+
 /*static*/
 PyObject*
 MI_Instance_Wrapper::getValue (
@@ -858,157 +1251,76 @@ MI_Instance_Wrapper::getValue (
 {
     //SCX_BOOKEND ("MI_Instance_Wrapper::getValue");
     PyObject* rval = NULL;
-    char const* KEYWORDS[] = {
-        "name",
-        NULL
-    };
     PyObject* pNameObj = NULL;
-    if (PyArg_ParseTupleAndKeywords (args, keywords, "O", const_cast<char **>(KEYWORDS), &pNameObj))
+    if (PyArg_ParseTupleAndKeywords (args, keywords, "O",
+                                     const_cast<char **>(GET_VALUE_KEYWORDS),
+                                     &pNameObj))
     {
-        MI_Type<MI_STRING>::type_t name;
-        int ret = fromPyObject (pNameObj, &name);
-        if (PY_SUCCESS == ret)
+        rval = get_value (pSelf, pNameObj);
+    }
+    else
+    {
+        // error: PyArg_ParseTupleAndKeywords failed
+    }
+    return rval;
+}
+
+
+#if (SCX_USE_FASTCALL)
+/*static*/
+PyObject*
+MI_Instance_Wrapper::getValueFast (
+    PyObject* pSelf,
+    PyObject* const* args,
+    Py_ssize_t nArgs,
+    PyObject* kwNames)
+{
+    //SCX_BOOKEND ("MI_Instance_Wrapper::getValueFast");
+    PyObject* rval = NULL;
+    PyObject* argv[1];
+    if (PY_SUCCESS == parseFastArgs (args, nArgs, kwNames,
+                                     GET_VALUE_KEYWORDS, 1, argv))
+    {
+        rval = get_value (pSelf, argv[0]);
+    }
+    return rval;
+}
+#endif // SCX_USE_FASTCALL
+
+
+/*static*/
+PyObject*
+MI_Instance_Wrapper::get_value (
+    PyObject* pSelf,
+    PyObject* pNameObj)
+{
+    PyObject* rval = NULL;
+    MI_Type<MI_STRING>::type_t name;
+    int ret = fromPyObject (pNameObj, &name);
+    if (PY_SUCCESS == ret)
+    {
+        MI_Instance_Wrapper* pInstance =
+            reinterpret_cast<MI_Instance_Wrapper*>(pSelf);
+        MI_ValueBase::Ptr pValue;
+        ret = pInstance->m_pInstance->getValue (name, &pValue);
+        if (0 == ret)
         {
-            MI_Instance_Wrapper* pInstance =
-                reinterpret_cast<MI_Instance_Wrapper*>(pSelf);
-            MI_ValueBase::Ptr pValue;
-            ret = pInstance->m_pInstance->getValue (name, &pValue);
-            if (0 == ret)
-            {
-                //std::ostringstream strm;
-                //strm << "MI_ClassDecl contains: " << name;
-                //SCX_BOOKEND_PRINT (strm.str ().c_str ());
-                if (pValue)
-                {
-                    //SCX_BOOKEND_PRINT ("value is not NULL");
-                    switch (pValue->getType ())
-                    {
-                    case MI_BOOLEAN:
-                        rval = wrap_value<MI_BOOLEAN> (pValue);
-                        break;
-                    case MI_UINT8:
-                        rval = wrap_value<MI_UINT8> (pValue);
-                        break;
-                    case MI_SINT8:
-                        rval = wrap_value<MI_SINT8> (pValue);
-                        break;
-                    case MI_UINT16:
-                        rval = wrap_value<MI_UINT16> (pValue);
-                        break;
-                    case MI_SINT16:
-                        rval = wrap_value<MI_SINT16> (pValue);
-                        break;
-                    case MI_UINT32:
-                        rval = wrap_value<MI_UINT32> (pValue);
-                        break;
-                    case MI_SINT32:
-                        rval = wrap_value<MI_SINT32> (pValue);
-                        break;
-                    case MI_UINT64:
-                        rval = wrap_value<MI_UINT64> (pValue);
-                        break;
-                    case MI_SINT64:
-                        rval = wrap_value<MI_SINT64> (pValue);
-                        break;
-                    case MI_REAL32:
-                        rval = wrap_value<MI_REAL32> (pValue);
-                        break;
-                    case MI_REAL64:
-                        rval = wrap_value<MI_REAL64> (pValue);
-                        break;
-                    case MI_CHAR16:
-                        rval = wrap_value<MI_CHAR16> (pValue);
-                        break;
-                    case MI_DATETIME:
-                        rval = wrap_datetime (pValue);
-                        break;
-                    case MI_STRING:
-                        rval = wrap_value<MI_STRING> (pValue);
-                        break;
-                    case MI_REFERENCE:
-                        SCX_BOOKEND_PRINT ("encountered an unhandled type");
-                        Py_INCREF (Py_None);
-                        rval = Py_None;
-                        break;
-                    case MI_INSTANCE:
-//                        SCX_BOOKEND_PRINT ("encountered an unhandled type");
-//                        Py_INCREF (Py_None);
-//                        rval = Py_None;
-                        rval = wrap_instance (pValue);
-                        break;
-                    case MI_BOOLEANA:
-                        rval = wrap_array<MI_BOOLEANA> (pValue);
-                        break;
-                    case MI_UINT8A:
-                        rval = wrap_array<MI_UINT8A> (pValue);
-                        break;
-                    case MI_SINT8A:
-                        rval = wrap_array<MI_SINT8A> (pValue);
-                        break;
-                    case MI_UINT16A:
-                        rval = wrap_array<MI_UINT16A> (pValue);
-                        break;
-                    case MI_SINT16A:
-                        rval = wrap_array<MI_SINT16A> (pValue);
-                        break;
-                    case MI_UINT32A:
-                        rval = wrap_array<MI_UINT32A> (pValue);
-                        break;
-                    case MI_SINT32A:
-                        rval = wrap_array<MI_SINT32A> (pValue);
-                        break;
-                    case MI_UINT64A:
-                        rval = wrap_array<MI_UINT64A> (pValue);
-                        break;
-                    case MI_SINT64A:
-                        rval = wrap_array<MI_SINT64A> (pValue);
-                        break;
-                    case MI_REAL32A:
-                        rval = wrap_array<MI_REAL32A> (pValue);
-                        break;
-                    case MI_REAL64A:
-                        rval = wrap_array<MI_REAL64A> (pValue);
-                        break;
-                    case MI_CHAR16A:
-                        rval = wrap_array<MI_CHAR16A> (pValue);
-                        break;
-                    case MI_DATETIMEA:
-                        rval = wrap_array<MI_DATETIMEA> (pValue);
-                        break;
-                    case MI_STRINGA:
-                        rval = wrap_array<MI_STRINGA> (pValue);
-                        break;
-                    case MI_REFERENCEA:
-                    case MI_INSTANCEA:
-                    default:
-                        SCX_BOOKEND_PRINT ("encountered an unhandled type");
-                        Py_INCREF (Py_None);
-                        rval = Py_None;
-                        break;
-                    }
-                }
-                else
-                {
-                    //SCX_BOOKEND_PRINT ("value is NULL");
-                    Py_INCREF (Py_None);
-                    rval = Py_None;
-                }
-            }
-            else
-            {
-                SCX_BOOKEND_PRINT ("Value name not a member of MI_ClassDecl");
-                // error: Name is not a member of MI_ClassDecl
-            }
+            //std::ostringstream strm;
+            //strm << "MI_ClassDecl contains: " << name;
+            //SCX_BOOKEND_PRINT (strm.str ().c_str ());
+            rval = pInstance->m_pInstance->getObjectDecl () ?
+                wrap_native (pValue) : wrap_base (pValue);
         }
         else
         {
-            SCX_BOOKEND_PRINT ("Name convert failed");
-            // error: Py_to_MI_convert failed
+            SCX_BOOKEND_PRINT ("Value name not a member of MI_ClassDecl");
+            // error: Name is not a member of MI_ClassDecl
         }
     }
     else
     {
-        // error: PyArg_ParseTupleAndKeywords failed
+        SCX_BOOKEND_PRINT ("Name convert failed");
+        // error: Py_to_MI_convert failed
     }
     return rval;
 }
@@ -1023,97 +1335,253 @@ MI_Instance_Wrapper::setValue (
 {
     //SCX_BOOKEND ("MI_Instance_Wrapper::setValue");
     PyObject* rval = NULL;
-    char const* KEYWORDS[] = {
-        "name",
-        "value",
-        NULL
-    };
     PyObject* pNameObj = NULL;
     PyObject* pValueObj = NULL;
-    if (PyArg_ParseTupleAndKeywords (args, keywords, "OO", const_cast<char **>(KEYWORDS),
+    if (PyArg_ParseTupleAndKeywords (args, keywords, "OO",
+                                     const_cast<char **>(SET_VALUE_KEYWORDS),
                                      &pNameObj, &pValueObj))
     {
         //SCX_BOOKEND_PRINT ("PyArg_ParseTupleAndKeywords succeeded");
-        MI_Type<MI_STRING>::type_t name;
-        int ret = fromPyObject (pNameObj, &name);
-        if (PY_SUCCESS == ret)
+        rval = set_value (pSelf, pNameObj, pValueObj);
+    }
+    else
+    {
+        SCX_BOOKEND_PRINT ("PyArg_ParseTupleAndKeywords failed");
+        // error: PyArg_ParseTupleAndKeywords failed
+    }
+    return rval;
+}
+
+
+#if (SCX_USE_FASTCALL)
+/*static*/
+PyObject*
+MI_Instance_Wrapper::setValueFast (
+    PyObject* pSelf,
+    PyObject* const* args,
+    Py_ssize_t nArgs,
+    PyObject* kwNames)
+{
+    //SCX_BOOKEND ("MI_Instance_Wrapper::setValueFast");
+    PyObject* rval = NULL;
+    PyObject* argv[2];
+    if (PY_SUCCESS == parseFastArgs (args, nArgs, kwNames,
+                                     SET_VALUE_KEYWORDS, 2, argv))
+    {
+        rval = set_value (pSelf, argv[0], argv[1]);
+    }
+    return rval;
+}
+#endif // SCX_USE_FASTCALL
+
+
+/*static*/
+PyObject*
+MI_Instance_Wrapper::set_value (
+    PyObject* pSelf,
+    PyObject* pNameObj,
+    PyObject* pValueObj)
+{
+    PyObject* rval = NULL;
+    MI_Type<MI_STRING>::type_t name;
+    int ret = fromPyObject (pNameObj, &name);
+    if (PY_SUCCESS == ret)
+    {
+        MI_Instance_Wrapper* pInstance =
+            reinterpret_cast<MI_Instance_Wrapper*>(pSelf);
+        if (pInstance->m_pInstance->getObjectDecl ())
         {
-            MI_Instance_Wrapper* pInstance =
-                reinterpret_cast<MI_Instance_Wrapper*>(pSelf);
-            if (pInstance->m_pInstance->getObjectDecl ())
+            MI_ParameterDecl::ConstPtr pParameterDecl =
+                pInstance->m_pInstance->getObjectDecl ()->getParameterDecl (
+                    name);
+            if (pParameterDecl)
             {
-                MI_ParameterDecl::ConstPtr pParameterDecl =
-                    pInstance->m_pInstance->getObjectDecl ()->getParameterDecl (
-                        name);
-                if (pParameterDecl)
-                {
-                    //SCX_BOOKEND_PRINT ("A parameter was found for Name");
-                    //std::ostringstream strm;
-                    //strm << "A parameter was found for " << name;
-                    //SCX_BOOKEND_PRINT (strm.str ());
-                    //strm.str ("");
-                    //strm.clear ();
-                    //strm << "parameter name: "
-                    //     << pParameterDecl->getName ()->getValue ();
-                    //SCX_BOOKEND_PRINT (strm.str ());
-                    //strm.str ("");
-                    //strm.clear ();
-                    //strm << "type: "
-                    //     << (pParameterDecl->getType ()->getValue ());
-                    //SCX_BOOKEND_PRINT (strm.str ());
-                    MI_ValueBase::Ptr pValue;
-                    ret = convertToBase (pParameterDecl->getType ()->getValue (),
-                                         pValueObj, &pValue);
-                    if (PY_SUCCESS == ret)
-                    {
-                        //SCX_BOOKEND_PRINT ("to_MI_ValueBase succeeded");
-                        pInstance->m_pInstance->setValue (name, pValue);
-                        rval = Py_None;
-                    }
-                    else
-                    {
-                        SCX_BOOKEND_PRINT ("Py_to_MI_convert failed");
-                    }
-                }
-                else
-                {
-                    SCX_BOOKEND_PRINT ("Name is not a parameter");
-                }
-            }
-            else
-            {
-                //SCX_BOOKEND_PRINT ("There is no MI_ObjectDecl");
+                //SCX_BOOKEND_PRINT ("A parameter was found for Name");
+                //std::ostringstream strm;
+                //strm << "A parameter was found for " << name;
+                //SCX_BOOKEND_PRINT (strm.str ());
+                //strm.str ("");
+                //strm.clear ();
+                //strm << "parameter name: "
+                //     << pParameterDecl->getName ()->getValue ();
+                //SCX_BOOKEND_PRINT (strm.str ());
+                //strm.str ("");
+                //strm.clear ();
+                //strm << "type: "
+                //     << (pParameterDecl->getType ()->getValue ());
+                //SCX_BOOKEND_PRINT (strm.str ());
                 MI_ValueBase::Ptr pValue;
-                ret = convertToBase (pValueObj, &pValue);
-                if (pValue)
+                ret = convertToBase (pParameterDecl->getType ()->getValue (),
+                                     pValueObj, &pValue);
+                if (PY_SUCCESS == ret)
                 {
-                    //SCX_BOOKEND_PRINT ("Value is a MI_Type");
+                    //SCX_BOOKEND_PRINT ("to_MI_ValueBase succeeded");
                     pInstance->m_pInstance->setValue (name, pValue);
                     rval = Py_None;
                 }
                 else
                 {
-                    // error
-                    SCX_BOOKEND_PRINT ("Value is not a MI_Type");
+                    SCX_BOOKEND_PRINT ("Py_to_MI_convert failed");
+                    if (!PyErr_Occurred ())
+                    {
+                        PyErr_SetString (
+                            PyExc_TypeError,
+                            "the value can't be converted to the type of the "
+                            "property");
+                    }
                 }
             }
+            else
+            {
+                SCX_BOOKEND_PRINT ("Name is not a parameter");
+            }
         }
         else
         {
-            SCX_BOOKEND_PRINT ("Name convert failed");
-            // error: Py_to_MI_convert failed
+            //SCX_BOOKEND_PRINT ("There is no MI_ObjectDecl");
+            MI_ValueBase::Ptr pValue;
+            ret = convertToBase (pValueObj, &pValue);
+            if (pValue)
+            {
+                //SCX_BOOKEND_PRINT ("Value is a MI_Type");
+                pInstance->m_pInstance->setValue (name, pValue);
+                rval = Py_None;
+            }
+            else
+            {
+                // error
+                SCX_BOOKEND_PRINT ("Value is not a MI_Type");
+            }
         }
     }
     else
     {
-        SCX_BOOKEND_PRINT ("PyArg_ParseTupleAndKeywords failed");
-        // error: PyArg_ParseTupleAndKeywords failed
+        SCX_BOOKEND_PRINT ("Name convert failed");
+        // error: Py_to_MI_convert failed
     }
     Py_XINCREF (rval);
     return rval;
 }
 
 
+/*static*/
+PyObject*
+MI_Instance_Wrapper::subscript (
+    PyObject* pSelf,
+    PyObject* pNameObj)
+{
+    PyObject* rval = get_value (pSelf, pNameObj);
+    if (NULL == rval &&
+        !PyErr_Occurred ())
+    {
+        PyErr_SetObject (PyExc_KeyError, pNameObj);
+    }
+    return rval;
+}
+
+
+/*static*/
+int
+MI_Instance_Wrapper::ass_subscript (
+    PyObject* pSelf,
+    PyObject* pNameObj,
+    PyObject* pValueObj)
+{
+    // a NULL pValueObj (del) is set as None, which removes the value
+    PyObject* pRval = set_value (
+        pSelf, pNameObj, NULL != pValueObj ? pValueObj : Py_None);
+    if (NULL == pRval &&
+        !PyErr_Occurred ())
+    {
+        PyErr_SetObject (PyExc_KeyError, pNameObj);
+    }
+    Py_XDECREF (pRval);
+    return NULL != pRval ? PY_SUCCESS : PY_FAILURE;
+}
+
+
+/*static*/
+int
+MI_Instance_Wrapper::create_class_type (
+    MI_ObjectDecl::ConstPtr const& pObjectDecl)
+{
+    //SCX_BOOKEND ("MI_Instance_Wrapper::create_class_type");
+    int rval = PY_FAILURE;
+    PyObjPtr pDict (PyDict_New ());
+    PyObjPtr pSlots (PyTuple_New (0));
+    PyObjPtr pModule (PyString_FromString ("omi"));
+    if (pDict &&
+        pSlots &&
+        pModule &&
+        0 == PyDict_SetItemString (pDict.get (), "__slots__", pSlots.get ()) &&
+        0 == PyDict_SetItemString (pDict.get (), "__module__", pModule.get ()))
+    {
+        rval = PY_SUCCESS;
+        std::vector<MI_ParameterDecl::ConstPtr> const& parameterDecls =
+            pObjectDecl->getParameterDecls ();
+        for (MI_Uint32 ordinal = 0;
+             PY_SUCCESS == rval && ordinal < parameterDecls.size ();
+             ++ordinal)
+        {
+            char const* const name =
+                parameterDecls[ordinal]->getName ()->getValue ().c_str ();
+            // a property must not hide a method or a special attribute of
+            // the type, it stays reachable by subscript
+            if (NULL == PyDict_GetItemString (pDict.get (), name) &&
+                !PyObject_HasAttrString (
+                    reinterpret_cast<PyObject*>(&s_PyTypeObject), name))
+            {
+                PyObjPtr pDescriptor (MI_Property_Descriptor::create (ordinal));
+                if (!pDescriptor ||
+                    0 != PyDict_SetItemString (
+                        pDict.get (), name, pDescriptor.get ()))
+                {
+                    rval = PY_FAILURE;
+                }
+            }
+            else
+            {
+                SCX_BOOKEND_PRINT ("property name is taken by the type");
+            }
+        }
+    }
+    if (PY_SUCCESS == rval)
+    {
+        PyObject* pType = PyObject_CallFunction (
+            reinterpret_cast<PyObject*>(&PyType_Type), "s(O)O",
+            pObjectDecl->getName ()->getValue ().c_str (),
+            reinterpret_cast<PyObject*>(&s_PyTypeObject), pDict.get ());
+        if (NULL != pType)
+        {
+            // the type lives as long as the module, as the schema does
+            class_type& classType = s_ClassTypes[pObjectDecl.get ()];
+            if (NULL != classType.pType)
+            {
+                s_ClassDecls.erase (classType.pType);
+                Py_DECREF (classType.pType);
+            }
+            classType.pObjectDecl = pObjectDecl;
+            classType.pType = pType;
+            s_ClassDecls[pType] = pObjectDecl;
+        }
+        else
+        {
+            rval = PY_FAILURE;
+        }
+    }
+    if (PY_FAILURE == rval)
+    {
+        SCX_BOOKEND_PRINT ("creating the class type failed");
+        if (!PyErr_Occurred ())
+        {
+            PyErr_SetString (PyExc_RuntimeError,
+                             "failed to create the class type");
+        }
+    }
+    return rval;
+}
+
+
 void
 MI_Instance_Wrapper::ctor (
     MI_Instance::Ptr const& pInstance)
@@ -1130,3 +1598,88 @@ MI_Instance_Wrapper::dtor ()
     typedef MI_Instance::Ptr ptr;
     m_pInstance.~ptr ();
 }
+
+
+/*static*/ char const MI_Property_Descriptor::OMI_NAME[] =
+    "omi.MI_Property_Descriptor";
+/*static*/ char const MI_Property_Descriptor::DOC[] =
+    "a property of an omi.MI_Instance class type";
+/*static*/ PyTypeObject MI_Property_Descriptor::s_PyTypeObject = {};
+
+
+/*static*/ int
+MI_Property_Descriptor::moduleInit ()
+{
+    SCX_BOOKEND ("MI_Property_Descriptor::moduleInit");
+    Zero_PyTypeObject (&s_PyTypeObject);
+    s_PyTypeObject.tp_name = OMI_NAME;
+    s_PyTypeObject.tp_basicsize = sizeof (MI_Property_Descriptor);
+    s_PyTypeObject.tp_flags = Py_TPFLAGS_DEFAULT;
+    s_PyTypeObject.tp_doc = DOC;
+    s_PyTypeObject.tp_alloc = PyType_GenericAlloc;
+    s_PyTypeObject.tp_descr_get = descr_get;
+    s_PyTypeObject.tp_descr_set = descr_set;
+    return 0 == PyType_Ready (&s_PyTypeObject) ? PY_SUCCESS : PY_FAILURE;
+}
+
+
+/*static*/ PyObject*
+MI_Property_Descriptor::create (
+    MI_Uint32 const& ordinal)
+{
+    PyObject* pDescriptor = s_PyTypeObject.tp_alloc (&s_PyTypeObject, 0);
+    if (NULL != pDescriptor)
+    {
+        reinterpret_cast<MI_Property_Descriptor*>(pDescriptor)->m_Ordinal =
+            ordinal;
+    }
+    return pDescriptor;
+}
+
+
+/*static*/ PyObject*
+MI_Property_Descriptor::descr_get (
+    PyObject* pSelf,
+    PyObject* pObj,
+    PyObject* /*pType*/)
+{
+    PyObject* rval = NULL;
+    if (NULL == pObj)
+    {
+        // looked up on the class type
+        Py_INCREF (pSelf);
+        rval = pSelf;
+    }
+    else if (PyObject_TypeCheck (pObj,
+                                 MI_Instance_Wrapper::getPyTypeObject ()))
+    {
+        rval = MI_Instance_Wrapper::getValueAt (
+            pObj, reinterpret_cast<MI_Property_Descriptor*>(pSelf)->m_Ordinal);
+    }
+    else
+    {
+        PyErr_SetString (PyExc_TypeError, "expected an omi.MI_Instance");
+    }
+    return rval;
+}
+
+
+/*static*/ int
+MI_Property_Descriptor::descr_set (
+    PyObject* pSelf,
+    PyObject* pObj,
+    PyObject* pValueObj)
+{
+    int rval = PY_FAILURE;
+    if (PyObject_TypeCheck (pObj, MI_Instance_Wrapper::getPyTypeObject ()))
+    {
+        rval = MI_Instance_Wrapper::setValueAt (
+            pObj, reinterpret_cast<MI_Property_Descriptor*>(pSelf)->m_Ordinal,
+            pValueObj);
+    }
+    else
+    {
+        PyErr_SetString (PyExc_TypeError, "expected an omi.MI_Instance");
+    }
+    return rval;
+}
@@ -8,7 +8,12 @@
 
 
 #include "mi_instance.hpp"
+#include "mi_schema.hpp"
 #include "py_ptr.hpp"
+#include "python_compatibility.hpp"
+
+
+#include <map>
 
 
 namespace scx
@@ -34,8 +39,43 @@ public:
     static PyObject* setValue (PyObject* pSelf,
                                PyObject* args,
                                PyObject* keywords);
+    // GetClassType returns the type createClassTypes made for the class
+    // named by name, to create instances of it with
+    static PyObject* getClassType (PyObject* pSelf,
+                                   PyObject* args,
+                                   PyObject* keywords);
+#if (SCX_USE_FASTCALL)
+    static PyObject* getValueFast (PyObject* pSelf,
+                                   PyObject* const* args,
+                                   Py_ssize_t nArgs,
+                                   PyObject* kwNames);
+    static PyObject* setValueFast (PyObject* pSelf,
+                                   PyObject* const* args,
+                                   Py_ssize_t nArgs,
+                                   PyObject* kwNames);
+#endif
 
     static PyPtr createPyPtr (MI_Instance::Ptr const& pInstance);
+#if (UTIL_HAS_RVALUE_REFERENCES)
+    // the wrapper takes pInstance over without touching its reference count
+    static PyPtr createPyPtr (MI_Instance::Ptr&& pInstance);
+#endif
+
+    // createClassTypes makes a subtype of omi.MI_Instance for each class and
+    // method in the schema with an attribute for each of its properties or
+    // parameters.  createPyPtr gives an instance the type for its class, and
+    // calling the type creates an instance of its declaration.  A
+    // property named like an attribute the type already has (GetValue,
+    // __module__, ...) gets no attribute of its own; it is reached through
+    // GetValue and SetValue or by subscript.  On failure a Python error is
+    // set.
+    static int createClassTypes (MI_SchemaDecl const& schemaDecl);
+
+    // get and set a value by its ordinal in the instance's declaration
+    static PyObject* getValueAt (PyObject* pSelf, MI_Uint32 const& ordinal);
+    static int setValueAt (PyObject* pSelf,
+                           MI_Uint32 const& ordinal,
+                           PyObject* pValueObj);
 
     static PyTypeObject* getPyTypeObject ();
 
@@ -48,11 +88,54 @@ private:
     /*ctor*/ MI_Instance_Wrapper (MI_Instance_Wrapper const&); // delete
     MI_Instance_Wrapper& operator = (MI_Instance_Wrapper const&); // delete
 
+    // allocate a wrapper of the class type for pInstance, or of
+    // omi.MI_Instance when it has none
+    static MI_Instance_Wrapper* alloc (MI_Instance const* const pInstance);
+
+    // a class type holds a reference to its declaration, so the address the
+    // type is found by can't be taken by another declaration while the type
+    // is in s_ClassTypes
+    struct class_type
+    {
+        /*ctor*/ class_type ()
+            : pType (NULL)
+        {
+            // empty
+        }
+
+        MI_ObjectDecl::ConstPtr pObjectDecl;
+        PyObject* pType;
+    };
+
+    typedef std::map<MI_ObjectDecl const*, class_type> class_type_map_t;
+    // the declaration of each class type, by the type
+    typedef std::map<PyObject const*, MI_ObjectDecl::ConstPtr>
+        class_decl_map_t;
+
+    static PyObject* get_value (PyObject* pSelf, PyObject* pNameObj);
+    static PyObject* set_value (PyObject* pSelf,
+                                PyObject* pNameObj,
+                                PyObject* pValueObj);
+
+    static PyObject* subscript (PyObject* pSelf, PyObject* pNameObj);
+    static int ass_subscript (PyObject* pSelf,
+                              PyObject* pNameObj,
+                              PyObject* pValueObj);
+
+    static int create_class_type (
+        MI_ObjectDecl::ConstPtr const& pObjectDecl);
+
     static char const NAME[];
     static char const OMI_NAME[];
     static char const DOC[];
+    static char const* const GET_VALUE_KEYWORDS[];
+    static char const* const GET_CLASS_TYPE_KEYWORDS[];
+    static char const* const SET_VALUE_KEYWORDS[];
     static PyMethodDef METHODS[];
+    static PyMappingMethods MAPPING_METHODS;
     static PyTypeObject s_PyTypeObject;
+    static class_type_map_t s_ClassTypes;
+    static class_decl_map_t s_ClassDecls;
 
     MI_Instance::Ptr m_pInstance;
 };
@@ -63,6 +146,38 @@ MI_Instance_Wrapper::getInstance () const
 {
     return m_pInstance;
 }
+
+
+// MI_Property_Descriptor is the attribute for one property of a class type
+// made by MI_Instance_Wrapper::createClassTypes.  It goes straight to the
+// property's ordinal.
+class MI_Property_Descriptor
+{
+public:
+    PyObject_HEAD
+
+    static int moduleInit ();
+
+    static PyObject* create (MI_Uint32 const& ordinal);
+
+private:
+    /*ctor*/ MI_Property_Descriptor (MI_Property_Descriptor const&); // delete
+    MI_Property_Descriptor& operator = (
+        MI_Property_Descriptor const&); // delete
+
+    static PyObject* descr_get (PyObject* pSelf,
+                                PyObject* pObj,
+                                PyObject* pType);
+    static int descr_set (PyObject* pSelf,
+                          PyObject* pObj,
+                          PyObject* pValueObj);
+
+    static char const OMI_NAME[];
+    static char const DOC[];
+    static PyTypeObject s_PyTypeObject;
+
+    MI_Uint32 m_Ordinal;
+};
     
 
 } // namespace scx
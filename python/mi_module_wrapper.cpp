@@ -5,6 +5,7 @@
 
 #include "mi_wrapper.hpp"
 #include "mi_context.hpp"
+#include "mi_instance_wrapper.hpp"
 #include "mi_schema_wrapper.hpp"
 
 
@@ -222,7 +223,9 @@ MI_Module_Wrapper::createModule (
         strm.clear ();
         MI_SchemaDecl::Ptr pSchemaDecl =
             m_pSchemaDecl_PH->createSchemaDecl (pPyModule);
-        if (pSchemaDecl)
+        if (pSchemaDecl &&
+            PY_SUCCESS ==
+                MI_Instance_Wrapper::createClassTypes (*pSchemaDecl))
         {
             SCX_BOOKEND_PRINT ("MI_SchemaDecl creation succeeded");
             m_pModule = new MI_Module (pSchemaDecl, m_pLoadFn, m_pUnloadFn);
@@ -329,6 +329,7 @@ template<> PyGetSetDef MI_Array_Iterator<_TYPE_>::s_Mutators[] = { \
      NULL }, \
    { NULL }, \
 }; \
+template<> PyBufferProcs MI_Array_Wrapper<_TYPE_>::BUFFER_PROCS = {}; \
 template<> PyTypeObject MI_Array_Wrapper<_TYPE_>::s_PyTypeObject = {}; \
 template<> PyTypeObject MI_Array_Iterator<_TYPE_>::s_PyTypeObject = {}
 
@@ -399,43 +400,29 @@ PyTypeObject MI_Array_Iterator<MI_DATETIMEA>::s_PyTypeObject = {};
 
 
 template<>
-/*static*/ int
-MI_Wrapper<MI_BOOLEAN>::init (
-    PyObject* pSelf,
-    PyObject* args,
-    PyObject* keywords)
+int
+MI_Wrapper<MI_BOOLEAN>::assign (
+    PyObject* pValue)
 {
-    //SCX_BOOKEND ("MI_Wrapper<MI_BOOLEAN>::init");
+    //SCX_BOOKEND ("MI_Wrapper<MI_BOOLEAN>::assign");
     int rval = PY_FAILURE;
-    MI_Wrapper<MI_BOOLEAN>* pWrapper =
-        reinterpret_cast<MI_Wrapper<MI_BOOLEAN>*>(pSelf);
-    pWrapper->ctor (MI_Value<MI_BOOLEAN>::Ptr ());
-    PyObject* pValue = NULL;
-    char const* KEYWORDS[] = {
-        "value",
-        NULL
-    };
-    if (PyArg_ParseTupleAndKeywords (
-            args, keywords, "|O", const_cast<char **>(KEYWORDS), &pValue))
+    if (NULL == pValue ||
+        Py_None == pValue)
     {
-        if (NULL == pValue ||
-            Py_None == pValue)
-        {
-            //SCX_BOOKEND_PRINT ("NULL or PyNone");
-            rval = PY_SUCCESS;
-        }
-        else if (Py_False == pValue)
-        {
-            //SCX_BOOKEND_PRINT ("***** Py_False");
-            pWrapper->m_pValue.reset (new MI_Value<MI_BOOLEAN> (MI_FALSE));
-            rval = PY_SUCCESS;
-        }
-        else if (Py_True == pValue)
-        {
-            //SCX_BOOKEND_PRINT ("***** Py_True");
-            pWrapper->m_pValue.reset (new MI_Value<MI_BOOLEAN> (MI_TRUE));
-            rval = PY_SUCCESS;
-        }
+        //SCX_BOOKEND_PRINT ("NULL or PyNone");
+        rval = PY_SUCCESS;
+    }
+    else if (Py_False == pValue)
+    {
+        //SCX_BOOKEND_PRINT ("***** Py_False");
+        m_pValue.reset (new MI_Value<MI_BOOLEAN> (MI_FALSE));
+        rval = PY_SUCCESS;
+    }
+    else if (Py_True == pValue)
+    {
+        //SCX_BOOKEND_PRINT ("***** Py_True");
+        m_pValue.reset (new MI_Value<MI_BOOLEAN> (MI_TRUE));
+        rval = PY_SUCCESS;
     }
     if (PY_FAILURE == rval)
     {
@@ -885,6 +872,23 @@ MI_Timestamp_Wrapper::createPyPtr (
 }
 
 
+#if (UTIL_HAS_RVALUE_REFERENCES)
+/*static*/ MI_Timestamp_Wrapper::PyPtr
+MI_Timestamp_Wrapper::createPyPtr (
+    MI_Timestamp::Ptr&& pValue)
+{
+    //SCX_BOOKEND ("MI_Timestamp::createPyPtr");
+    MI_Timestamp::Ptr const pEmpty;
+    PyPtr pyWrapper (createPyPtr (pEmpty));
+    if (pyWrapper)
+    {
+        pyWrapper->m_pTimestamp = UTIL_MOVE (pValue);
+    }
+    return pyWrapper;
+}
+#endif
+
+
 /*static*/ PyObject*
 MI_Timestamp_Wrapper::_getType (
     PyObject* pSelf)
@@ -1280,6 +1284,23 @@ MI_Interval_Wrapper::createPyPtr (
 }
 
 
+#if (UTIL_HAS_RVALUE_REFERENCES)
+/*static*/ MI_Interval_Wrapper::PyPtr
+MI_Interval_Wrapper::createPyPtr (
+    MI_Interval::Ptr&& pValue)
+{
+    //SCX_BOOKEND ("MI_Interval::createPyPtr");
+    MI_Interval::Ptr const pEmpty;
+    PyPtr pyWrapper (createPyPtr (pEmpty));
+    if (pyWrapper)
+    {
+        pyWrapper->m_pInterval = UTIL_MOVE (pValue);
+    }
+    return pyWrapper;
+}
+#endif
+
+
 /*static*/ PyTypeObject*
 MI_Interval_Wrapper::getPyTypeObject ()
 {
@@ -7,6 +7,7 @@
 #include "Python.h"
 
 
+#include "fast_args.hpp"
 #include "mi_value.hpp"
 #include "py_converter.hpp"
 #include "py_ptr.hpp"
@@ -40,7 +41,17 @@ public:
 
     static void dealloc (PyObject* pObj);
     static int init (PyObject* pSelf, PyObject* args, PyObject* keywords);
+#if (SCX_USE_VECTORCALL)
+    static PyObject* vectorcall (PyObject* pType,
+                                 PyObject* const* args,
+                                 size_t nArgsf,
+                                 PyObject* kwNames);
+#endif
     static PyPtr createPyPtr (typename MI_Value<TYPE_ID>::Ptr const& pValue);
+#if (UTIL_HAS_RVALUE_REFERENCES)
+    // the wrapper takes pValue over without touching its reference count
+    static PyPtr createPyPtr (typename MI_Value<TYPE_ID>::Ptr&& pValue);
+#endif
     static PyObject* _getType (PyObject* pSelf);
     static PyObject* _getValue (MI_Wrapper<TYPE_ID>* pSelf, void*);
     static int _setValue (MI_Wrapper<TYPE_ID>* pSelf, PyObject* pValue, void*);
@@ -52,6 +63,10 @@ public:
     MI_Value<TYPE_ID>* getValue () const;
 
 private:
+    // set the value from the argument to the constructor, NULL if there was
+    // none
+    int assign (PyObject* pValue);
+
     PyObject_HEAD
 
     typename MI_Value<TYPE_ID>::Ptr m_pValue;
@@ -107,6 +122,9 @@ public:
     static void dealloc (PyObject* pObj);
     static int init (PyObject* pSelf, PyObject* args, PyObject* keywords);
     static PyPtr createPyPtr (MI_Timestamp::Ptr const& pValue);
+#if (UTIL_HAS_RVALUE_REFERENCES)
+    static PyPtr createPyPtr (MI_Timestamp::Ptr&& pValue);
+#endif
     static PyObject* _getType (PyObject* pSelf);
 
     static PyObject* _isTimestamp (MI_Timestamp_Wrapper* pSelf, void*);
@@ -171,6 +189,9 @@ public:
     static void dealloc (PyObject* pObj);
     static int init (PyObject* pSelf, PyObject* args, PyObject* keywords);
     static PyPtr createPyPtr (MI_Interval::Ptr const& pValue);
+#if (UTIL_HAS_RVALUE_REFERENCES)
+    static PyPtr createPyPtr (MI_Interval::Ptr&& pValue);
+#endif
     static PyObject* _getType (PyObject* pSelf);
 
     static PyObject* _isTimestamp (MI_Interval_Wrapper* pSelf, void*);
@@ -307,6 +328,35 @@ private:
 };
 
 
+// getBufferFormat
+//------------------------------------------------------------------------------
+// the struct module format of the items of the numeric and octet arrays that
+// MI_Array_Wrapper exports through the buffer protocol, NULL for the others
+template<TypeID_t TYPE_ID>
+inline char const* getBufferFormat () { return NULL; }
+
+template<>
+inline char const* getBufferFormat<MI_UINT8A> () { return "B"; }
+template<>
+inline char const* getBufferFormat<MI_SINT8A> () { return "b"; }
+template<>
+inline char const* getBufferFormat<MI_UINT16A> () { return "H"; }
+template<>
+inline char const* getBufferFormat<MI_SINT16A> () { return "h"; }
+template<>
+inline char const* getBufferFormat<MI_UINT32A> () { return "I"; }
+template<>
+inline char const* getBufferFormat<MI_SINT32A> () { return "i"; }
+template<>
+inline char const* getBufferFormat<MI_UINT64A> () { return "Q"; }
+template<>
+inline char const* getBufferFormat<MI_SINT64A> () { return "q"; }
+template<>
+inline char const* getBufferFormat<MI_REAL32A> () { return "f"; }
+template<>
+inline char const* getBufferFormat<MI_REAL64A> () { return "d"; }
+
+
 // class MI_Array_Wrapper
 //------------------------------------------------------------------------------
 template<TypeID_t TYPE_ID>
@@ -323,6 +373,9 @@ public:
     static int init (PyObject* pSelf, PyObject* args, PyObject* keywords);
 
     static PyPtr createPyPtr (typename MI_Array<TYPE_ID>::Ptr const& pArray);
+#if (UTIL_HAS_RVALUE_REFERENCES)
+    static PyPtr createPyPtr (typename MI_Array<TYPE_ID>::Ptr&& pArray);
+#endif
 
     static PyObject* _getType (PyObject* pSelf);
 
@@ -349,6 +402,11 @@ public:
 
     static PyObject* to_str (PyObject* pSelf);
 
+    // the items of a numeric or octet array are exported in place, the array
+    // can't change size while a view of it exists
+    static int getBuffer (PyObject* pSelf, Py_buffer* pView, int flags);
+    static void releaseBuffer (PyObject* pSelf, Py_buffer* pView);
+
     static PyTypeObject* getPyTypeObject ();
 
     void ctor ();
@@ -360,15 +418,22 @@ private:
     /*ctor*/ MI_Array_Wrapper (MI_Array_Wrapper const&); // delete
     MI_Array_Wrapper& operator = (MI_Array_Wrapper const&); // delete
 
+    // sets BufferError if the array is exported
+    int check_resizable () const;
+
     static char const NAME[];
     static char const OMI_NAME[];
     static char const DOC[];
     static PyMethodDef METHODS[];
+    static PyBufferProcs BUFFER_PROCS;
     static PyTypeObject s_PyTypeObject;
 
     PyObject_HEAD
 
     typename MI_Array<TYPE_ID>::Ptr m_pArray;
+    // the number of views and the item count they were given
+    Py_ssize_t m_nExports;
+    Py_ssize_t m_Shape;
 };
 
 
@@ -564,6 +629,10 @@ MI_Wrapper<TYPE_ID>::moduleInit (
     s_PyTypeObject.tp_doc = DOC;
     s_PyTypeObject.tp_init = init;
     s_PyTypeObject.tp_new = PyType_GenericNew;
+#if (SCX_USE_VECTORCALL)
+    // not inherited, so a subclass is still made by tp_new and tp_init
+    s_PyTypeObject.tp_vectorcall = vectorcall;
+#endif
     s_PyTypeObject.tp_alloc = PyType_GenericAlloc;
     s_PyTypeObject.tp_getset = s_Mutators;
     s_PyTypeObject.tp_methods = s_Methods;
@@ -602,14 +671,6 @@ MI_Wrapper<TYPE_ID>::dealloc (
 }
 
 
-template<>
-/*static*/ int
-MI_Wrapper<MI_BOOLEAN>::init (
-    PyObject* pSelf,
-    PyObject* args,
-    PyObject* keywords);
-
-
 template<TypeID_t TYPE_ID>
 /*static*/ int
 MI_Wrapper<TYPE_ID>::init (
@@ -630,17 +691,74 @@ MI_Wrapper<TYPE_ID>::init (
     if (PyArg_ParseTupleAndKeywords (
             args, keywords, "|O", const_cast<char **>(KEYWORDS), &pValue))
     {
-        if (NULL == pValue ||
-            Py_None == pValue)
-        {
-            //SCX_BOOKEND_PRINT ("NULL or PyNone");
-            rval = PY_SUCCESS;
-        }
-        else
+        rval = pWrapper->assign (pValue);
+    }
+    else
+    {
+        PyErr_SetString (PyExc_ValueError, "invalid arguments");
+    }
+    return rval;
+}
+
+
+#if (SCX_USE_VECTORCALL)
+template<TypeID_t TYPE_ID>
+/*static*/ PyObject*
+MI_Wrapper<TYPE_ID>::vectorcall (
+    PyObject* pType,
+    PyObject* const* args,
+    size_t nArgsf,
+    PyObject* kwNames)
+{
+    //SCX_BOOKEND ("MI_Wrapper::vectorcall");
+    assert (reinterpret_cast<PyObject*>(&s_PyTypeObject) == pType);
+    PyObject* pValue = NULL;
+    char const* KEYWORDS[] = {
+        "value",
+        NULL
+    };
+    PyObjPtr pPyWrapper;
+    if (PY_SUCCESS == parseFastArgs (args, PyVectorcall_NARGS (nArgsf),
+                                     kwNames, KEYWORDS, 0, &pValue))
+    {
+        pPyWrapper.reset (s_PyTypeObject.tp_alloc (&s_PyTypeObject, 0));
+    }
+    if (pPyWrapper)
+    {
+        MI_Wrapper<TYPE_ID>* pWrapper =
+            reinterpret_cast<MI_Wrapper<TYPE_ID>*>(pPyWrapper.get ());
+        pWrapper->ctor (typename MI_Value<TYPE_ID>::Ptr ());
+        if (PY_SUCCESS != pWrapper->assign (pValue))
         {
-            rval = to_MI_Value<TYPE_ID> (pValue, &(pWrapper->m_pValue));
+            pPyWrapper.reset ();
         }
     }
+    return pPyWrapper.release ();
+}
+#endif // SCX_USE_VECTORCALL
+
+
+template<>
+int
+MI_Wrapper<MI_BOOLEAN>::assign (
+    PyObject* pValue);
+
+
+template<TypeID_t TYPE_ID>
+int
+MI_Wrapper<TYPE_ID>::assign (
+    PyObject* pValue)
+{
+    int rval = PY_SUCCESS;
+    if (NULL == pValue ||
+        Py_None == pValue)
+    {
+        //SCX_BOOKEND_PRINT ("NULL or PyNone");
+    }
+    else
+    {
+        rval = to_MI_Value<TYPE_ID> (pValue, &m_pValue);
+    }
     if (PY_FAILURE == rval)
     {
         PyErr_SetString (PyExc_ValueError, "invalid arguments");
@@ -675,6 +793,25 @@ MI_Wrapper<TYPE_ID>::createPyPtr (
 }
 
 
+#if (UTIL_HAS_RVALUE_REFERENCES)
+template<TypeID_t TYPE_ID>
+/*static*/ typename MI_Wrapper<TYPE_ID>::PyPtr
+MI_Wrapper<TYPE_ID>::createPyPtr (
+    typename MI_Value<TYPE_ID>::Ptr&& pValue)
+{
+    //SCX_BOOKEND ("MI_Wrapper::createPyPtr");
+    // the wrapper is made around an empty Ptr and the value is moved in
+    typename MI_Value<TYPE_ID>::Ptr const pEmpty;
+    PyPtr pyWrapper (createPyPtr (pEmpty));
+    if (pyWrapper)
+    {
+        pyWrapper->m_pValue = UTIL_MOVE (pValue);
+    }
+    return pyWrapper;
+}
+#endif
+
+
 template<TypeID_t TYPE_ID>
 /*static*/ PyObject*
 MI_Wrapper<TYPE_ID>::_getType (
@@ -872,6 +1009,13 @@ MI_Array_Wrapper<TYPE_ID>::moduleInit (
     s_PyTypeObject.tp_methods = METHODS;
     s_PyTypeObject.tp_str = to_str;
     s_PyTypeObject.tp_iter = getIter;
+    if (NULL != getBufferFormat<TYPE_ID> ())
+    {
+        BUFFER_PROCS.bf_getbuffer = getBuffer;
+        BUFFER_PROCS.bf_releasebuffer = releaseBuffer;
+        s_PyTypeObject.tp_as_buffer = &BUFFER_PROCS;
+        s_PyTypeObject.tp_flags |= SCX_TPFLAGS_HAVE_NEWBUFFER;
+    }
     if (0 == PyType_Ready (&s_PyTypeObject))
     {
         Py_INCREF (&s_PyTypeObject);
@@ -914,13 +1058,19 @@ MI_Array_Wrapper<TYPE_ID>::init (
     int rval = PY_FAILURE;
     MI_Array_Wrapper<TYPE_ID>* pWrapper =
         reinterpret_cast<MI_Array_Wrapper<TYPE_ID>*>(pSelf);
-    pWrapper->ctor ();
+    // the array can't be replaced while it is exported
+    bool const exported = PY_SUCCESS != pWrapper->check_resizable ();
+    if (!exported)
+    {
+        pWrapper->ctor ();
+    }
     PyObject* pValue = NULL;
     char const* KEYWORDS[] = {
         "values",
         NULL
     };
-    if (PyArg_ParseTupleAndKeywords (
+    if (!exported &&
+        PyArg_ParseTupleAndKeywords (
             args, keywords, "|O", const_cast<char **>(KEYWORDS), &pValue))
     {
         //SCX_BOOKEND_PRINT ("PyArg_ParseTupleAndKeywords succeeded");
@@ -988,8 +1138,57 @@ MI_Array_Wrapper<TYPE_ID>::init (
                 pWrapper->m_pArray.reset (pArray.get ());
             }
         }
+        else if (NULL != getBufferFormat<TYPE_ID> () &&
+                 PyObject_CheckBuffer (pValue))
+        {
+            //SCX_BOOKEND_PRINT ("***** buffer");
+            Py_buffer buffer;
+            if (0 == PyObject_GetBuffer (pValue, &buffer,
+                                         PyBUF_FORMAT | PyBUF_STRIDES))
+            {
+                if (is_numeric_buffer (buffer))
+                {
+                    typename MI_Array<TYPE_ID>::Ptr pArray (
+                        new MI_Array<TYPE_ID>);
+                    rval = PY_SUCCESS;
+                    if (is_buffer_of_type (buffer, TYPE_ID) &&
+                        PyBuffer_IsContiguous (&buffer, 'C'))
+                    {
+                        // the items are already this type, copy them
+                        Value_t const* pBegin =
+                            static_cast<Value_t const*>(buffer.buf);
+                        pArray->assign (pBegin, pBegin + buffer.shape[0]);
+                    }
+                    else
+                    {
+                        // convert and range check each item
+                        for (Py_ssize_t i = 0;
+                             PY_SUCCESS == rval && i < buffer.shape[0];
+                             ++i)
+                        {
+                            MI_ValueBase::Ptr pItem;
+                            rval = bufferItem_to_MI_ValueBase (
+                                TYPE_ID & ~MI_ARRAY, buffer, i, &pItem);
+                            if (PY_SUCCESS == rval)
+                            {
+                                pArray->push_back (
+                                    static_cast<
+                                        MI_Value<TYPE_ID & ~MI_ARRAY>*>(
+                                            pItem.get ())->getValue ());
+                            }
+                        }
+                    }
+                    if (PY_SUCCESS == rval)
+                    {
+                        pWrapper->m_pArray.reset (pArray.get ());
+                    }
+                }
+                PyBuffer_Release (&buffer);
+            }
+        }
     }
-    if (PY_FAILURE == rval)
+    if (PY_FAILURE == rval &&
+        !exported)
     {
         PyErr_SetString (PyExc_ValueError, "invalid arguments");
     }
@@ -1018,6 +1217,24 @@ MI_Array_Wrapper<TYPE_ID>::createPyPtr (
 }
 
 
+#if (UTIL_HAS_RVALUE_REFERENCES)
+template<TypeID_t TYPE_ID>
+/*static*/ typename MI_Array_Wrapper<TYPE_ID>::PyPtr
+MI_Array_Wrapper<TYPE_ID>::createPyPtr (
+    typename MI_Array<TYPE_ID>::Ptr&& pArray)
+{
+    //SCX_BOOKEND ("MI_Array_Wrapper::createPyPtr");
+    typename MI_Array<TYPE_ID>::Ptr const pEmpty;
+    PyPtr pyArray (createPyPtr (pEmpty));
+    if (pyArray)
+    {
+        pyArray->m_pArray = UTIL_MOVE (pArray);
+    }
+    return pyArray;
+}
+#endif
+
+
 template<TypeID_t TYPE_ID>
 /*static*/ PyObject*
 MI_Array_Wrapper<TYPE_ID>::_getType (
@@ -1174,7 +1391,11 @@ MI_Array_Wrapper<TYPE_ID>::_append (
         MI_Array_Wrapper<TYPE_ID>* pArray =
             reinterpret_cast<MI_Array_Wrapper<TYPE_ID>*>(pSelf);
         Value_t value;
-        if (PY_SUCCESS == fromPyObject (pValueObj, &value))
+        if (PY_SUCCESS != pArray->check_resizable ())
+        {
+            // error: the array is exported
+        }
+        else if (PY_SUCCESS == fromPyObject (pValueObj, &value))
         {
             pArray->m_pArray->push_back (value);
             rval = Py_None;
@@ -1233,7 +1454,11 @@ MI_Array_Wrapper<TYPE_ID>::_insert (
             static_cast<long>(pArray->m_pArray->size ()) >= index)
         {
             Value_t value;
-            if (PY_SUCCESS == fromPyObject (pValueObj, &value))
+            if (PY_SUCCESS != pArray->check_resizable ())
+            {
+                // error: the array is exported
+            }
+            else if (PY_SUCCESS == fromPyObject (pValueObj, &value))
             {
                 pArray->m_pArray->insert (index, value);
                 rval = Py_None;
@@ -1292,8 +1517,12 @@ MI_Array_Wrapper<TYPE_ID>::_pop (
         {
             index += static_cast<long>(pArray->m_pArray->size ());
         }
-        if (0 <= index &&
-            static_cast<size_t>(index) < pArray->m_pArray->size ())
+        if (PY_SUCCESS != pArray->check_resizable ())
+        {
+            // error: the array is exported
+        }
+        else if (0 <= index &&
+                 static_cast<size_t>(index) < pArray->m_pArray->size ())
         {
             rval = toPyObject ((*(pArray->m_pArray))[index]);
             pArray->m_pArray->erase (index);
@@ -1382,12 +1611,74 @@ MI_Array_Wrapper<TYPE_ID>::to_str (
 }
 
 
+template<TypeID_t TYPE_ID>
+/*static*/ int
+MI_Array_Wrapper<TYPE_ID>::getBuffer (
+    PyObject* pSelf,
+    Py_buffer* pView,
+    int flags)
+{
+    //SCX_BOOKEND ("MI_Array_Wrapper::getBuffer");
+    // an empty array still needs a buffer address
+    static Value_t s_Empty;
+    MI_Array_Wrapper<TYPE_ID>* pArray =
+        reinterpret_cast<MI_Array_Wrapper<TYPE_ID>*>(pSelf);
+    Value_t* pData = pArray->m_pArray->getData ();
+    Py_ssize_t const count =
+        static_cast<Py_ssize_t>(pArray->m_pArray->size ());
+    int rval = PyBuffer_FillInfo (
+        pView, pSelf, NULL != pData ? pData : &s_Empty,
+        count * static_cast<Py_ssize_t>(sizeof (Value_t)), 0, flags);
+    if (0 == rval)
+    {
+        pArray->m_Shape = count;
+        pView->itemsize = sizeof (Value_t);
+        pView->format = PyBUF_FORMAT == (flags & PyBUF_FORMAT) ?
+            const_cast<char*>(getBufferFormat<TYPE_ID> ()) : NULL;
+        pView->shape = PyBUF_ND == (flags & PyBUF_ND) ?
+            &pArray->m_Shape : NULL;
+        pView->strides = PyBUF_STRIDES == (flags & PyBUF_STRIDES) ?
+            &pView->itemsize : NULL;
+        ++pArray->m_nExports;
+    }
+    return rval;
+}
+
+
+template<TypeID_t TYPE_ID>
+/*static*/ void
+MI_Array_Wrapper<TYPE_ID>::releaseBuffer (
+    PyObject* pSelf,
+    Py_buffer* /*pView*/)
+{
+    //SCX_BOOKEND ("MI_Array_Wrapper::releaseBuffer");
+    --reinterpret_cast<MI_Array_Wrapper<TYPE_ID>*>(pSelf)->m_nExports;
+}
+
+
+template<TypeID_t TYPE_ID>
+int
+MI_Array_Wrapper<TYPE_ID>::check_resizable () const
+{
+    int rval = PY_SUCCESS;
+    if (0 < m_nExports)
+    {
+        PyErr_SetString (PyExc_BufferError,
+                         "the array can't change size while it is exported");
+        rval = PY_FAILURE;
+    }
+    return rval;
+}
+
+
 template<TypeID_t TYPE_ID>
 void
 MI_Array_Wrapper<TYPE_ID>::ctor ()
 {
     //SCX_BOOKEND ("MI_Array_Wrapper::ctor");
     new (&m_pArray) typename MI_Array<TYPE_ID>::Ptr (new MI_Array<TYPE_ID> ());
+    m_nExports = 0;
+    m_Shape = 0;
 }
 
 
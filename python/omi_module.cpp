@@ -5,8 +5,10 @@
 
 
 #include "debug_tags.hpp"
+#include "gil_lock.hpp"
 #include "mi_instance_wrapper.hpp"
 #include "shared.hpp"
+#include "socket_wrapper.hpp"
 
 
 #include <iostream>
@@ -69,6 +71,11 @@ initomi ()
     init_BookEnd_wrapper (pModule);
     init_MI_wrapper (pModule);
 
+#if (SCX_HAVE_GIL_CHECK)
+    // drop the GIL while blocked on the server
+    socket_wrapper::setBlockingHooks (release_gil_if_held, restore_gil);
+#endif
+
     #if PY_MAJOR_VERSION >= 3
         // Python 3 should return the module
         return pModule;
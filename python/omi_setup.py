@@ -18,6 +18,7 @@ module1 = Extension (
     'omi',
     sources = ['bookend_wrapper.cpp',
                'client_wrapper.cpp',
+               'event_loop.cpp',
                'functor.cpp',
                'mi_context_wrapper.cpp',
                'mi_function_table_placeholder.cpp',
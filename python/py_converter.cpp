@@ -7,10 +7,32 @@
 #include "python_compatibility.hpp"
 
 
+#include "datetime.h"
+
+
+#include <cstring>
+
+
 namespace
 {
 
 
+// the datetime C API is imported by each translation unit that uses it
+bool
+datetime_api_ready ()
+{
+    if (NULL == PyDateTimeAPI)
+    {
+        PyDateTime_IMPORT;
+        if (NULL == PyDateTimeAPI)
+        {
+            PyErr_Clear ();
+        }
+    }
+    return NULL != PyDateTimeAPI;
+}
+
+
 int
 _PyBool_to_MI_ValueBase (
     PyObject* pSource,
@@ -78,7 +100,16 @@ _MI_Datetime_to_MI_ValueBase (
         }
         else
         {
-            SCX_BOOKEND_PRINT ("pSource is not a MI_Datetime");
+            scx::MI_Datetime::Ptr pDatetime;
+            rval = scx::datetime_to_MI_Datetime (pSource, &pDatetime);
+            if (PY_SUCCESS == rval)
+            {
+                ppValueOut->reset (pDatetime.get ());
+            }
+            else
+            {
+                SCX_BOOKEND_PRINT ("pSource is not a MI_Datetime");
+            }
         }
     }
     else
@@ -200,6 +231,46 @@ _array_to_MI_ValueBase (
 }
 
 
+int
+_bytes_to_MI_ValueBase (
+    PyObject* pSource,
+    scx::MI_ValueBase::Ptr* ppValueOut)
+{
+    SCX_BOOKEND ("_bytes_to_MI_ValueBase");
+    int rval = PY_FAILURE;
+    char const* pBytes = NULL;
+    Py_ssize_t count = 0;
+    if (NULL != pSource &&
+        PyBytes_Check (pSource))
+    {
+        pBytes = PyBytes_AS_STRING (pSource);
+        count = PyBytes_GET_SIZE (pSource);
+        rval = PY_SUCCESS;
+    }
+    else if (NULL != pSource &&
+             PyByteArray_Check (pSource))
+    {
+        pBytes = PyByteArray_AS_STRING (pSource);
+        count = PyByteArray_GET_SIZE (pSource);
+        rval = PY_SUCCESS;
+    }
+    else
+    {
+        rval = _array_to_MI_ValueBase<MI_UINT8A> (pSource, ppValueOut);
+    }
+    if (NULL != pBytes)
+    {
+        scx::MI_Array<MI_UINT8A>::Ptr pArray (new scx::MI_Array<MI_UINT8A>);
+        for (Py_ssize_t i = 0; i < count; ++i)
+        {
+            pArray->push_back (static_cast<MI_Uint8>(pBytes[i]));
+        }
+        ppValueOut->reset (pArray.get ());
+    }
+    return rval;
+}
+
+
 int
 _MI_DatetimeA_to_MI_ValueBase (
     PyObject* pSource,
@@ -250,7 +321,12 @@ _MI_DatetimeA_to_MI_ValueBase (
                 }
                 else
                 {
-                    rval = PY_FAILURE;
+                    scx::MI_Datetime::Ptr pDatetime;
+                    rval = scx::datetime_to_MI_Datetime (pItem, &pDatetime);
+                    if (PY_SUCCESS == rval)
+                    {
+                        pArray->push_back (pDatetime);
+                    }
                 }
                        
 //                Value_t value;
@@ -295,7 +371,12 @@ _MI_DatetimeA_to_MI_ValueBase (
                 }
                 else
                 {
-                    rval = PY_FAILURE;
+                    scx::MI_Datetime::Ptr pDatetime;
+                    rval = scx::datetime_to_MI_Datetime (pItem, &pDatetime);
+                    if (PY_SUCCESS == rval)
+                    {
+                        pArray->push_back (pDatetime);
+                    }
                 }
 
 //                Value_t value;
@@ -320,6 +401,253 @@ _MI_DatetimeA_to_MI_ValueBase (
 }
 
 
+// buffer_item holds one item read from a buffer as the widest type of its
+// kind
+struct buffer_item
+{
+    enum kind_t
+    {
+        SINT,
+        UINT,
+        REAL,
+        UNSUPPORTED
+    };
+
+    kind_t kind;
+    long long sint;
+    unsigned long long uint;
+    double real;
+};
+
+
+buffer_item::kind_t
+get_buffer_kind (
+    Py_buffer const& buffer)
+{
+    buffer_item::kind_t kind = buffer_item::UNSUPPORTED;
+    // no format means unsigned bytes
+    char const* pFormat = NULL != buffer.format ? buffer.format : "B";
+    if ('@' == *pFormat ||
+        '=' == *pFormat)
+    {
+        // native byte order
+        ++pFormat;
+    }
+    if ('\0' != *pFormat &&
+        '\0' == pFormat[1])
+    {
+        switch (*pFormat)
+        {
+        case 'b':
+        case 'h':
+        case 'i':
+        case 'l':
+        case 'q':
+        case 'n':
+            kind = buffer_item::SINT;
+            break;
+        case 'B':
+        case 'H':
+        case 'I':
+        case 'L':
+        case 'Q':
+        case 'N':
+        case '?':
+            kind = buffer_item::UINT;
+            break;
+        case 'f':
+        case 'd':
+            kind = buffer_item::REAL;
+            break;
+        }
+    }
+    if ((buffer_item::REAL == kind &&
+         4 != buffer.itemsize &&
+         8 != buffer.itemsize) ||
+        (buffer_item::REAL != kind &&
+         1 != buffer.itemsize &&
+         2 != buffer.itemsize &&
+         4 != buffer.itemsize &&
+         8 != buffer.itemsize))
+    {
+        kind = buffer_item::UNSUPPORTED;
+    }
+    return kind;
+}
+
+
+void
+read_buffer_item (
+    Py_buffer const& buffer,
+    Py_ssize_t index,
+    buffer_item* pItemOut)
+{
+    char const* pSource = static_cast<char const*>(buffer.buf) +
+        index * (NULL != buffer.strides ? buffer.strides[0] : buffer.itemsize);
+    pItemOut->kind = get_buffer_kind (buffer);
+    pItemOut->sint = 0;
+    pItemOut->uint = 0;
+    pItemOut->real = 0.0;
+    switch (pItemOut->kind)
+    {
+    case buffer_item::SINT:
+        {
+            MI_Sint8 sint8;
+            MI_Sint16 sint16;
+            MI_Sint32 sint32;
+            MI_Sint64 sint64;
+            switch (buffer.itemsize)
+            {
+            case 1:
+                memcpy (&sint8, pSource, sizeof (sint8));
+                pItemOut->sint = sint8;
+                break;
+            case 2:
+                memcpy (&sint16, pSource, sizeof (sint16));
+                pItemOut->sint = sint16;
+                break;
+            case 4:
+                memcpy (&sint32, pSource, sizeof (sint32));
+                pItemOut->sint = sint32;
+                break;
+            case 8:
+                memcpy (&sint64, pSource, sizeof (sint64));
+                pItemOut->sint = sint64;
+                break;
+            default:
+                pItemOut->kind = buffer_item::UNSUPPORTED;
+                break;
+            }
+        }
+        break;
+    case buffer_item::UINT:
+        {
+            MI_Uint8 uint8;
+            MI_Uint16 uint16;
+            MI_Uint32 uint32;
+            MI_Uint64 uint64;
+            switch (buffer.itemsize)
+            {
+            case 1:
+                memcpy (&uint8, pSource, sizeof (uint8));
+                pItemOut->uint = uint8;
+                break;
+            case 2:
+                memcpy (&uint16, pSource, sizeof (uint16));
+                pItemOut->uint = uint16;
+                break;
+            case 4:
+                memcpy (&uint32, pSource, sizeof (uint32));
+                pItemOut->uint = uint32;
+                break;
+            case 8:
+                memcpy (&uint64, pSource, sizeof (uint64));
+                pItemOut->uint = uint64;
+                break;
+            default:
+                pItemOut->kind = buffer_item::UNSUPPORTED;
+                break;
+            }
+        }
+        break;
+    case buffer_item::REAL:
+        {
+            MI_Real32 real32;
+            MI_Real64 real64;
+            switch (buffer.itemsize)
+            {
+            case 4:
+                memcpy (&real32, pSource, sizeof (real32));
+                pItemOut->real = real32;
+                break;
+            case 8:
+                memcpy (&real64, pSource, sizeof (real64));
+                pItemOut->real = real64;
+                break;
+            default:
+                pItemOut->kind = buffer_item::UNSUPPORTED;
+                break;
+            }
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+
+// integer items convert to an integer type if they are in its range, real
+// items don't, as fromPyObject doesn't convert a float to an integer type
+template<scx::TypeID_t TYPE>
+int
+_buffer_item_to_MI_ValueBase (
+    buffer_item const& item,
+    scx::MI_ValueBase::Ptr* ppValueOut)
+{
+    typedef scx::MI_Limits<TYPE> limits_t;
+    int rval = PY_FAILURE;
+    if (buffer_item::SINT == item.kind &&
+        (0 <= item.sint ?
+            static_cast<unsigned long long>(item.sint) <=
+                static_cast<unsigned long long>(limits_t::max ()) :
+            static_cast<long long>(limits_t::min ()) <= item.sint))
+    {
+        ppValueOut->reset (new scx::MI_Value<TYPE> (
+            static_cast<typename limits_t::type_t>(item.sint)));
+        rval = PY_SUCCESS;
+    }
+    else if (buffer_item::UINT == item.kind &&
+             item.uint <= static_cast<unsigned long long>(limits_t::max ()))
+    {
+        ppValueOut->reset (new scx::MI_Value<TYPE> (
+            static_cast<typename limits_t::type_t>(item.uint)));
+        rval = PY_SUCCESS;
+    }
+    return rval;
+}
+
+
+template<scx::TypeID_t TYPE>
+int
+_buffer_item_to_real (
+    buffer_item const& item,
+    scx::MI_ValueBase::Ptr* ppValueOut)
+{
+    typedef scx::MI_Limits<TYPE> limits_t;
+    int rval = PY_FAILURE;
+    double value = 0.0;
+    switch (item.kind)
+    {
+    case buffer_item::SINT:
+        value = static_cast<double>(item.sint);
+        rval = PY_SUCCESS;
+        break;
+    case buffer_item::UINT:
+        value = static_cast<double>(item.uint);
+        rval = PY_SUCCESS;
+        break;
+    case buffer_item::REAL:
+        value = item.real;
+        rval = PY_SUCCESS;
+        break;
+    default:
+        break;
+    }
+    if (PY_SUCCESS == rval &&
+        limits_t::max () < fabs (value))
+    {
+        //SCX_BOOKEND_PRINT ("value out of range");
+        rval = PY_FAILURE;
+    }
+    if (PY_SUCCESS == rval)
+    {
+        ppValueOut->reset (new scx::MI_Value<TYPE> (
+            static_cast<typename limits_t::type_t>(value)));
+    }
+    return rval;
+}
+
+
 }
 
 
@@ -481,12 +809,16 @@ PyConverter<MI_Type<MI_STRING>::type_t>::fromPyObject (
     {
         #if PY_MAJOR_VERSION >= 3
             PyObject* tmp = PyUnicode_AsEncodedString (pSource, "utf-8", "strict");
-            *pValueOut = PyBytes_AsString (tmp);
-            Py_DECREF(tmp);
+            if (NULL != tmp)
+            {
+                *pValueOut = PyBytes_AsString (tmp);
+                Py_DECREF(tmp);
+                rval = PY_SUCCESS;
+            }
         #else
             *pValueOut = PyString_AsString (pSource);
+            rval = PY_SUCCESS;
         #endif
-        rval = PY_SUCCESS;
     }
     else
     {
@@ -555,7 +887,7 @@ to_MI_ValueBase (
         rval = _array_to_MI_ValueBase<MI_BOOLEANA> (pSource, ppValueOut);
         break;
     case MI_UINT8A:
-        rval = _array_to_MI_ValueBase<MI_UINT8A> (pSource, ppValueOut);
+        rval = _bytes_to_MI_ValueBase (pSource, ppValueOut);
         break;
     case MI_SINT8A:
         rval = _array_to_MI_ValueBase<MI_SINT8A> (pSource, ppValueOut);
@@ -607,4 +939,275 @@ to_MI_ValueBase (
 }
 
 
+bool
+is_numeric_buffer (
+    Py_buffer const& buffer)
+{
+    return 1 == buffer.ndim &&
+        buffer_item::UNSUPPORTED != get_buffer_kind (buffer);
+}
+
+
+bool
+is_buffer_of_type (
+    Py_buffer const& buffer,
+    TypeID_t type)
+{
+    buffer_item::kind_t kind = buffer_item::UNSUPPORTED;
+    size_t size = 0;
+    switch (type & ~MI_ARRAY)
+    {
+    case MI_UINT8:
+        kind = buffer_item::UINT;
+        size = sizeof (MI_Uint8);
+        break;
+    case MI_SINT8:
+        kind = buffer_item::SINT;
+        size = sizeof (MI_Sint8);
+        break;
+    case MI_UINT16:
+        kind = buffer_item::UINT;
+        size = sizeof (MI_Uint16);
+        break;
+    case MI_SINT16:
+        kind = buffer_item::SINT;
+        size = sizeof (MI_Sint16);
+        break;
+    case MI_UINT32:
+        kind = buffer_item::UINT;
+        size = sizeof (MI_Uint32);
+        break;
+    case MI_SINT32:
+        kind = buffer_item::SINT;
+        size = sizeof (MI_Sint32);
+        break;
+    case MI_UINT64:
+        kind = buffer_item::UINT;
+        size = sizeof (MI_Uint64);
+        break;
+    case MI_SINT64:
+        kind = buffer_item::SINT;
+        size = sizeof (MI_Sint64);
+        break;
+    case MI_REAL32:
+        kind = buffer_item::REAL;
+        size = sizeof (MI_Real32);
+        break;
+    case MI_REAL64:
+        kind = buffer_item::REAL;
+        size = sizeof (MI_Real64);
+        break;
+    }
+    return buffer_item::UNSUPPORTED != kind &&
+        kind == get_buffer_kind (buffer) &&
+        static_cast<Py_ssize_t>(size) == buffer.itemsize;
+}
+
+
+int
+bufferItem_to_MI_ValueBase (
+    TypeID_t type,
+    Py_buffer const& buffer,
+    Py_ssize_t index,
+    MI_ValueBase::Ptr* ppValueOut)
+{
+    //SCX_BOOKEND ("bufferItem_to_MI_ValueBase");
+    assert (NULL != ppValueOut);
+    int rval = PY_FAILURE;
+    buffer_item item;
+    read_buffer_item (buffer, index, &item);
+    switch (type)
+    {
+    case MI_BOOLEAN:
+        if (buffer_item::SINT == item.kind ||
+            buffer_item::UINT == item.kind)
+        {
+            ppValueOut->reset (
+                new MI_Value<MI_BOOLEAN> (0 != item.sint || 0 != item.uint));
+            rval = PY_SUCCESS;
+        }
+        break;
+    case MI_UINT8:
+        rval = _buffer_item_to_MI_ValueBase<MI_UINT8> (item, ppValueOut);
+        break;
+    case MI_SINT8:
+        rval = _buffer_item_to_MI_ValueBase<MI_SINT8> (item, ppValueOut);
+        break;
+    case MI_UINT16:
+        rval = _buffer_item_to_MI_ValueBase<MI_UINT16> (item, ppValueOut);
+        break;
+    case MI_SINT16:
+        rval = _buffer_item_to_MI_ValueBase<MI_SINT16> (item, ppValueOut);
+        break;
+    case MI_UINT32:
+        rval = _buffer_item_to_MI_ValueBase<MI_UINT32> (item, ppValueOut);
+        break;
+    case MI_SINT32:
+        rval = _buffer_item_to_MI_ValueBase<MI_SINT32> (item, ppValueOut);
+        break;
+    case MI_UINT64:
+        rval = _buffer_item_to_MI_ValueBase<MI_UINT64> (item, ppValueOut);
+        break;
+    case MI_SINT64:
+        rval = _buffer_item_to_MI_ValueBase<MI_SINT64> (item, ppValueOut);
+        break;
+    case MI_CHAR16:
+        rval = _buffer_item_to_MI_ValueBase<MI_CHAR16> (item, ppValueOut);
+        break;
+    case MI_REAL32:
+        rval = _buffer_item_to_real<MI_REAL32> (item, ppValueOut);
+        break;
+    case MI_REAL64:
+        rval = _buffer_item_to_real<MI_REAL64> (item, ppValueOut);
+        break;
+    default:
+        SCX_BOOKEND_PRINT ("the type can't be read from a buffer");
+        break;
+    }
+    return rval;
+}
+
+
+int
+datetime_to_MI_Datetime (
+    PyObject* pSource,
+    MI_Datetime::Ptr* ppValueOut)
+{
+    int rval = PY_FAILURE;
+    if (!datetime_api_ready ())
+    {
+        SCX_BOOKEND_PRINT ("the datetime module is not available");
+    }
+    else if (PyDateTime_Check (pSource))
+    {
+        MI_Sint32 utc = 0;
+        rval = PY_SUCCESS;
+        if (reinterpret_cast<PyDateTime_DateTime*>(pSource)->hastzinfo)
+        {
+            PyObjPtr pOffset (PyObject_CallMethod (
+                                  pSource, const_cast<char*>("utcoffset"),
+                                  NULL));
+            if (!pOffset)
+            {
+                rval = PY_FAILURE;
+            }
+            else if (PyDelta_Check (pOffset.get ()))
+            {
+                PyDateTime_Delta* pDelta =
+                    reinterpret_cast<PyDateTime_Delta*>(pOffset.get ());
+                utc = static_cast<MI_Sint32>(
+                    (pDelta->days * 86400 + pDelta->seconds) / 60);
+            }
+        }
+        if (PY_SUCCESS == rval)
+        {
+            ppValueOut->reset (
+                new MI_Timestamp (
+                    PyDateTime_GET_YEAR (pSource),
+                    PyDateTime_GET_MONTH (pSource),
+                    PyDateTime_GET_DAY (pSource),
+                    PyDateTime_DATE_GET_HOUR (pSource),
+                    PyDateTime_DATE_GET_MINUTE (pSource),
+                    PyDateTime_DATE_GET_SECOND (pSource),
+                    PyDateTime_DATE_GET_MICROSECOND (pSource),
+                    utc));
+        }
+    }
+    else if (PyDelta_Check (pSource))
+    {
+        PyDateTime_Delta* pDelta =
+            reinterpret_cast<PyDateTime_Delta*>(pSource);
+        if (0 <= pDelta->days)
+        {
+            ppValueOut->reset (
+                new MI_Interval (
+                    pDelta->days,
+                    pDelta->seconds / 3600,
+                    pDelta->seconds / 60 % 60,
+                    pDelta->seconds % 60,
+                    pDelta->microseconds));
+            rval = PY_SUCCESS;
+        }
+        else
+        {
+            PyErr_SetString (PyExc_ValueError,
+                             "a negative timedelta can't be a MI_Interval");
+        }
+    }
+    return rval;
+}
+
+
+PyObject*
+MI_Datetime_to_PyObject (
+    MI_Datetime const& value)
+{
+    PyObject* rval = NULL;
+    if (!datetime_api_ready ())
+    {
+        PyErr_SetString (PyExc_ImportError,
+                         "the datetime module is not available");
+    }
+    else if (value.isTimestamp ())
+    {
+        MI_Timestamp const& timestamp =
+            static_cast<MI_Timestamp const&>(value);
+#if (PY_VERSION_HEX >= 0x03070000)
+        PyObjPtr pTimezone;
+        if (0 == timestamp.getUTC ())
+        {
+            Py_INCREF (PyDateTime_TimeZone_UTC);
+            pTimezone.reset (PyDateTime_TimeZone_UTC);
+        }
+        else
+        {
+            PyObjPtr pOffset (PyDelta_FromDSU (0, timestamp.getUTC () * 60,
+                                               0));
+            if (pOffset)
+            {
+                pTimezone.reset (PyTimeZone_FromOffset (pOffset.get ()));
+            }
+        }
+        if (pTimezone)
+        {
+            rval = PyDateTimeAPI->DateTime_FromDateAndTime (
+                timestamp.getYear (), timestamp.getMonth (),
+                timestamp.getDay (), timestamp.getHour (),
+                timestamp.getMinute (), timestamp.getSecond (),
+                timestamp.getMicroseconds (), pTimezone.get (),
+                PyDateTimeAPI->DateTimeType);
+        }
+#else
+        rval = PyDateTime_FromDateAndTime (
+            timestamp.getYear (), timestamp.getMonth (), timestamp.getDay (),
+            timestamp.getHour (), timestamp.getMinute (),
+            timestamp.getSecond (), timestamp.getMicroseconds ());
+#endif
+    }
+    else
+    {
+        MI_Interval const& interval = static_cast<MI_Interval const&>(value);
+        // the hours, minutes and seconds may add up to more than a day
+        unsigned long long seconds =
+            interval.getHours () * 3600ULL +
+            interval.getMinutes () * 60ULL +
+            interval.getSeconds ();
+        unsigned long long days = interval.getDays () + seconds / 86400;
+        // timedelta.max.days
+        if (999999999ULL >= days)
+        {
+            rval = PyDelta_FromDSU (static_cast<int>(days),
+                                    static_cast<int>(seconds % 86400),
+                                    interval.getMicroseconds ());
+        }
+        else
+        {
+            PyErr_SetString (PyExc_OverflowError,
+                             "the MI_Interval is too long for a timedelta");
+        }
+    }
+    return rval;
+}
+
+
 } // namespace scx
@@ -226,6 +226,7 @@ to_MI_Value_or_NULL (
 // purpose: attempts to convert PyObject* to MI_Value<TYPE>::type
 // notes: this method works with basic Python types, MI_Wrapper<TYPE>, NULL, and
 //        Py_None
+//        bytes and bytearray convert to MI_UINT8A
 int
 to_MI_ValueBase (
     TypeID_t type,
@@ -233,6 +234,59 @@ to_MI_ValueBase (
     MI_ValueBase::Ptr* ppValueOut);
 
 
+// purpose: converts a datetime.datetime to MI_Timestamp and a
+//          datetime.timedelta to MI_Interval
+// notes: the offset of an aware datetime becomes the timestamp's UTC offset,
+//        a naive one has an offset of 0
+//        returns PY_FAILURE with no error set if pSource is neither type, and
+//        with a ValueError set for a negative timedelta
+int
+datetime_to_MI_Datetime (
+    PyObject* pSource,
+    MI_Datetime::Ptr* ppValueOut);
+
+
+// purpose: converts MI_Timestamp to datetime.datetime and MI_Interval to
+//          datetime.timedelta
+// notes: from Python 3.7 the datetime is aware, with a fixed offset timezone
+//        for the timestamp's UTC offset
+//        returns NULL with an error set if the value is out of the range of
+//        the datetime module (a timestamp in year 0, for example)
+PyObject*
+MI_Datetime_to_PyObject (
+    MI_Datetime const& value);
+
+
+// purpose: tells if the items of a buffer can be read by
+//          bufferItem_to_MI_ValueBase
+// notes: the buffer has to be one dimensional and hold native integers,
+//        floats or bools (array.array, memoryview, numpy arrays)
+bool
+is_numeric_buffer (
+    Py_buffer const& buffer);
+
+
+// purpose: tells if the items of a buffer are already the value type of an
+//          MI type (or of the items of an MI array type), so that they can be
+//          copied as they are
+bool
+is_buffer_of_type (
+    Py_buffer const& buffer,
+    TypeID_t type);
+
+
+// purpose: converts an item of a buffer to MI_Value<TYPE> without creating a
+//          PyObject for it
+// notes: type has to be a numeric or MI_BOOLEAN type, the value is range
+//        checked the same way fromPyObject does
+int
+bufferItem_to_MI_ValueBase (
+    TypeID_t type,
+    Py_buffer const& buffer,
+    Py_ssize_t index,
+    MI_ValueBase::Ptr* ppValueOut);
+
+
 
 // class PyConverter_Sint definitions
 //------------------------------------------------------------------------------
@@ -418,52 +472,39 @@ PyConverter_Real<T>::fromPyObject (
     int rval = PY_FAILURE;
     assert (pSource && Py_None != pSource);
     assert (NULL != pValueOut);
+    double value = 0.0;
+    bool converted = false;
     if (PyFloat_Check (pSource))
     {
-        double value = PyFloat_AS_DOUBLE (pSource);
-        if ((MI_Limits<Type_to_ID<T>::ID>::min () <= fabs (value) &&
-             MI_Limits<Type_to_ID<T>::ID>::max () >= fabs (value)) ||
-            T(0) == fabs (value))
-        {
-            *pValueOut = static_cast<T>(value);
-            rval = PY_SUCCESS;
-        }
-        else
-        {
-            //SCX_BOOKEND_PRINT ("value out of range");
-        }
+        value = PyFloat_AS_DOUBLE (pSource);
+        converted = true;
     }
     else if (PyLong_Check (pSource))
     {
         //SCX_BOOKEND_PRINT ("PyLong");
-        unsigned long long value = PyLong_AsUnsignedLongLong (pSource);
-        if ((unsigned long long)-1 != value ||
-            NULL == PyErr_Occurred ())
-        {
-            // succeeded
-            *pValueOut = static_cast<T>(value);
-            rval = PY_SUCCESS;
-        }
-        else
-        {
-            // failed
-            //SCX_BOOKEND_PRINT ("PyLong_AsUnsignedLongLong failed");
-        }
+        // PyLong_AsDouble handles negative values and values too large for
+        // an integer type
+        value = PyLong_AsDouble (pSource);
+        converted = -1.0 != value || NULL == PyErr_Occurred ();
     }
     else if (PyInt_Check (pSource))
     {
         //SCX_BOOKEND_PRINT ("PyInt");
-        long value = PyInt_AsLong (pSource);
-        if (-1 != value ||
-            NULL == PyErr_Occurred ())
+        value = static_cast<double>(PyInt_AsLong (pSource));
+        converted = -1.0 != value || NULL == PyErr_Occurred ();
+    }
+    if (converted)
+    {
+        if ((MI_Limits<Type_to_ID<T>::ID>::min () <= fabs (value) &&
+             MI_Limits<Type_to_ID<T>::ID>::max () >= fabs (value)) ||
+            T(0) == fabs (value))
         {
             *pValueOut = static_cast<T>(value);
             rval = PY_SUCCESS;
         }
         else
         {
-            // failed
-            //SCX_BOOKEND_PRINT ("PyInt_AsLong failed");
+            //SCX_BOOKEND_PRINT ("value out of range");
         }
     }
     else
@@ -27,4 +27,48 @@
     #define PyString_FromString PyUnicode_FromString
 #endif
 
+// METH_FASTCALL passes a method its arguments as an array, without building a
+// tuple for them.  From 3.9 a type's tp_vectorcall is used the same way when
+// the type itself is called.
+#if (PY_VERSION_HEX >= 0x03070000)
+    #define SCX_USE_FASTCALL (1)
+#else
+    #define SCX_USE_FASTCALL (0)
+#endif
+#if (PY_VERSION_HEX >= 0x03090000)
+    #define SCX_USE_VECTORCALL (1)
+#else
+    #define SCX_USE_VECTORCALL (0)
+#endif
+
+// async def functions return coroutines, which are run with
+// asyncio.run_coroutine_threadsafe (new in 3.5.1).
+#if (PY_VERSION_HEX >= 0x03050100)
+    #define SCX_USE_ASYNCIO (1)
+#else
+    #define SCX_USE_ASYNCIO (0)
+#endif
+
+// Python 2 only uses a type's bf_getbuffer when the type has this flag.
+#if PY_MAJOR_VERSION >= 3
+    #define SCX_TPFLAGS_HAVE_NEWBUFFER (0)
+#else
+    #define SCX_TPFLAGS_HAVE_NEWBUFFER Py_TPFLAGS_HAVE_NEWBUFFER
+#endif
+
+// Whether the calling thread holds the GIL.  PyGILState_Check is new in 3.4
+// and 3.0 to 3.3 have no way to tell, so SCX_HAVE_GIL_CHECK is 0 for them.
+#if (PY_VERSION_HEX >= 0x03040000)
+    #define SCX_HAVE_GIL_CHECK (1)
+    #define SCX_GIL_HELD() (0 != PyGILState_Check ())
+#elif PY_MAJOR_VERSION < 3
+    #define SCX_HAVE_GIL_CHECK (1)
+    #define SCX_GIL_HELD() \
+        (NULL != _PyThreadState_Current && \
+         PyGILState_GetThisThreadState () == _PyThreadState_Current)
+#else
+    #define SCX_HAVE_GIL_CHECK (0)
+    #define SCX_GIL_HELD() (false)
+#endif
+
 #endif // INCLUDED_PYTHON_COMPATIBILITY_HPP
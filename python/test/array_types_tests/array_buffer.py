@@ -0,0 +1,89 @@
+from omi import *
+
+import array
+
+try:
+    from utils import *
+except ImportError:
+    import sys
+    sys.path.insert(0, '..')
+    from utils import *
+
+
+def buffera_test():
+    be = BookEnd('buffera_test')
+
+    rval = True
+
+    # memoryview of an octet array
+    v0 = MI_Uint8A([1, 2, 0xFF])
+    m0 = memoryview(v0)
+    if m0.format != 'B' or m0.itemsize != 1 or m0.tolist() != [1, 2, 0xFF]:
+        BookEndPrint('----- memoryview (MI_Uint8A) failed')
+        rval = False
+    if bytes(v0) != b'\x01\x02\xff':
+        BookEndPrint('----- bytes (MI_Uint8A) failed')
+        rval = False
+
+    # the view shares the items with the array
+    m0[0] = 7
+    if v0.getValueAt(0) != 7:
+        BookEndPrint('----- memoryview (write through) failed')
+        rval = False
+
+    # the array can't change size while it is exported
+    try:
+        v0.append(3)
+    except BufferError:
+        pass
+    else:
+        BookEndPrint('----- append (exported) failed')
+        rval = False
+    m0.release()
+    v0.append(3)
+    if v0.count() != 4:
+        BookEndPrint('----- append (released) failed')
+        rval = False
+
+    # empty array
+    if memoryview(MI_Sint32A()).tolist() != []:
+        BookEndPrint('----- memoryview (empty) failed')
+        rval = False
+
+    # wider items
+    v1 = MI_Sint64A([-5, 0, 5])
+    m1 = memoryview(v1)
+    if m1.format != 'q' or m1.itemsize != 8 or m1.tolist() != [-5, 0, 5]:
+        BookEndPrint('----- memoryview (MI_Sint64A) failed')
+        rval = False
+    m1.release()
+
+    # construct from a buffer of the same type
+    v2 = MI_Uint32A(array.array('I', [1, 2, 3]))
+    if v2.count() != 3 or v2.getValueAt(2) != 3:
+        BookEndPrint('----- init (array.array same type) failed')
+        rval = False
+
+    # construct from a buffer of another type
+    v3 = MI_Real64A(array.array('i', [-1, 2]))
+    if v3.count() != 2 or v3.getValueAt(0) != -1.0:
+        BookEndPrint('----- init (array.array other type) failed')
+        rval = False
+    v4 = MI_Uint8A(b'\x01\x02')
+    if v4.count() != 2 or v4.getValueAt(1) != 2:
+        BookEndPrint('----- init (bytes) failed')
+        rval = False
+
+    # construct from a buffer with an item out of range **error**
+    try:
+        MI_Uint8A(array.array('i', [1, 256]))
+    except ValueError:
+        pass
+    else:
+        BookEndPrint('----- init (buffer out of range) failed')
+        rval = False
+
+    if not rval:
+        BookEndPrint('!!!!!  Tests have failed! (buffer)')
+
+    return rval
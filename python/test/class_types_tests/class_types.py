@@ -0,0 +1,166 @@
+from omi import *
+
+import os
+import socket
+
+try:
+    from utils import *
+except ImportError:
+    import sys
+    sys.path.insert(0, '..')
+    from utils import *
+
+
+# the class types are made when a Client creates the module of the provider
+# in ./provider; the client is never run, the socket only has to be open
+_client = None
+_sock = None
+
+
+def get_class_type():
+    global _client
+    global _sock
+    if _client is None:
+        _sock, peer = socket.socketpair()
+        fd = os.dup(peer.fileno())
+        peer.close()
+        path = os.path.join(
+            os.path.dirname(os.path.realpath(__file__)), 'provider')
+        _client = Client(path, fd=fd)
+    return MI_Instance.GetClassType('Test_ClassType')
+
+
+def raises(exception, fn):
+    try:
+        fn()
+    except exception:
+        return True
+    except Exception:
+        return False
+    return False
+
+
+def class_type_test():
+    be = BookEnd('class_type_test')
+
+    rval = True
+
+    classType = get_class_type()
+    if classType.__name__ != 'Test_ClassType' or \
+            not issubclass(classType, MI_Instance):
+        BookEndPrint('----- GetClassType failed')
+        rval = False
+    # class names are compared without regard to case
+    if MI_Instance.GetClassType('test_classtype') is not classType:
+        BookEndPrint('----- GetClassType is case sensitive')
+        rval = False
+    if not raises(KeyError, lambda: MI_Instance.GetClassType('Missing')):
+        BookEndPrint('----- GetClassType found a missing class')
+        rval = False
+
+    inst = classType()
+    if type(inst) is not classType or \
+            inst.Count is not None or \
+            inst['Count'] is not None:
+        BookEndPrint('----- class type init failed')
+        rval = False
+
+    # a subclass of a class type has the class type's declaration
+    class Derived(classType):
+        pass
+    derived = Derived()
+    derived.Count = MI_Uint32(3)
+    if not isinstance(derived, classType) or \
+            derived.Count.value != 3 or \
+            derived['Count'].value != 3:
+        BookEndPrint('----- subclass init failed')
+        rval = False
+
+    # attribute access
+    inst.Count = MI_Uint32(7)
+    if inst.Count.value != 7 or \
+            inst['Count'].value != 7 or \
+            inst.GetValue('Count').value != 7:
+        BookEndPrint('----- attribute set failed')
+        rval = False
+
+    # mapping access
+    inst['Name'] = MI_String('apple')
+    if inst.Name.value != 'apple' or \
+            inst.GetValue('Name').value != 'apple':
+        BookEndPrint('----- subscript set failed')
+        rval = False
+    del inst['Name']
+    if inst['Name'] is not None:
+        BookEndPrint('----- subscript del failed')
+        rval = False
+
+    # a property named like a method doesn't hide the method
+    inst['GetValue'] = MI_Uint16(3)
+    if not callable(inst.GetValue) or \
+            inst.GetValue('GetValue').value != 3 or \
+            inst['GetValue'].value != 3:
+        BookEndPrint('----- property hid a method')
+        rval = False
+
+    if not raises(KeyError, lambda: inst['Missing']):
+        BookEndPrint('----- subscript found a missing property')
+        rval = False
+    if not raises(AttributeError, lambda: inst.Missing):
+        BookEndPrint('----- attribute found a missing property')
+        rval = False
+
+    return rval
+
+
+def coercion_test():
+    be = BookEnd('coercion_test')
+
+    rval = True
+
+    inst = get_class_type()()
+
+    # plain values are converted to the declared type
+    inst.Count = 5
+    if inst.Count.getType() != MI_UINT32 or inst.Count.value != 5:
+        BookEndPrint('----- int to MI_UINT32 failed')
+        rval = False
+    inst['Ratio'] = -2
+    if inst.Ratio.getType() != MI_REAL64 or \
+            not float_eq(inst.Ratio.value, -2.0):
+        BookEndPrint('----- int to MI_REAL64 failed')
+        rval = False
+    inst.Enabled = True
+    if inst.Enabled.getType() != MI_BOOLEAN or not inst.Enabled.value:
+        BookEndPrint('----- bool to MI_BOOLEAN failed')
+        rval = False
+    inst.SetValue('Name', 'pear')
+    if inst.Name.getType() != MI_STRING or inst.Name.value != 'pear':
+        BookEndPrint('----- str to MI_STRING failed')
+        rval = False
+    inst.Data = bytearray([1, 2, 255])
+    if inst.Data.getType() != MI_UINT8A or \
+            [inst.Data.getValueAt(i) for i in range(inst.Data.count())] != \
+            [1, 2, 255]:
+        BookEndPrint('----- bytearray to MI_UINT8A failed')
+        rval = False
+    inst.Names = ['kiwi', 'plum']
+    if inst.Names.getType() != MI_STRINGA or \
+            [inst.Names.getValueAt(i) for i in range(inst.Names.count())] != \
+            ['kiwi', 'plum']:
+        BookEndPrint('----- list to MI_STRINGA failed')
+        rval = False
+
+    # values that don't fit the declared type are refused and the value
+    # that was set stays
+    if not raises(Exception, lambda: setattr(inst, 'Count', -1)) or \
+            not raises(TypeError, lambda: setattr(inst, 'Count', 'x')) or \
+            not raises(Exception, lambda: setattr(inst, 'Data', [1, 256])) or \
+            inst.Count.value != 5:
+        BookEndPrint('----- invalid value was converted')
+        rval = False
+    if not raises(TypeError, lambda: setattr(inst, 'Count', MI_Uint8(1))):
+        BookEndPrint('----- wrapper of another type was set')
+        rval = False
+
+    return rval
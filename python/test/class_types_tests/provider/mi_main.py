@@ -0,0 +1,56 @@
+# the provider the class type tests create a Client for, its schema is only
+# there to have class types made for it
+from omi import *
+
+
+def prop(name, type):
+    return MI_PropertyDecl(
+        MI_FLAG_PROPERTY, # flags
+        name, # name
+        [], # qualifiers
+        type, # type
+        None, # className
+        'Test_ClassType', # origin
+        'Test_ClassType', # propagator
+        None # value
+        )
+
+
+Test_ClassType_properties = [
+    prop('Name', MI_STRING),
+    prop('Count', MI_UINT32),
+    prop('Ratio', MI_REAL64),
+    prop('Enabled', MI_BOOLEAN),
+    prop('Data', MI_UINT8A),
+    prop('Names', MI_STRINGA),
+    # named like a method of MI_Instance
+    prop('GetValue', MI_UINT16),
+    ]
+
+Test_ClassType_class = MI_ClassDecl(
+    MI_FLAG_CLASS, # flags
+    'Test_ClassType', # name
+    [], # qualifiers
+    Test_ClassType_properties, # properties
+    None, # superclass
+    [], # methods
+    None, # FunctionTable
+    None # owningclass
+    )
+
+schema = MI_SchemaDecl(
+    [],
+    [Test_ClassType_class]
+    )
+
+
+def Load(module, context):
+    context.PostResult(MI_RESULT_OK)
+
+
+def Unload(module, context):
+    context.PostResult(MI_RESULT_OK)
+
+
+def mi_main():
+    return MI_Module(schema, Load, Unload)
@@ -2,6 +2,7 @@ from omi import *
 
 # Import test functions
 from array_types_tests.array_boolean import booleana_test
+from array_types_tests.array_buffer import buffera_test
 from array_types_tests.array_char import char16a_test
 from array_types_tests.array_datetime import datetimea_test
 from array_types_tests.array_int16 import uint16a_test, sint16a_test
@@ -11,6 +12,7 @@ from array_types_tests.array_int8 import uint8a_test, sint8a_test
 from array_types_tests.array_real32 import real32a_test
 from array_types_tests.array_real64 import real64a_test
 from array_types_tests.array_strings import stringa_test
+from class_types_tests.class_types import class_type_test, coercion_test
 from types_tests.bool_type import bool_test
 from types_tests.char_type import char16_test
 from types_tests.instance_type import instance_test
@@ -213,10 +215,17 @@ def main(argv=None):
         rval = False
     if stringa_test() is False:
         rval = False
+    if sys.version_info[0] >= 3 and buffera_test() is False:
+        rval = False
 
     if instance_test() is False:
         rval = False
 
+    if class_type_test() is False:
+        rval = False
+    if coercion_test() is False:
+        rval = False
+
     BookEndPrint('!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!')
     BookEndPrint('!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!')
     if not rval:
@@ -1,5 +1,7 @@
 from omi import *
 
+import datetime
+
 try:
     from utils import *
 except ImportError:
@@ -719,6 +721,19 @@ def instance_test():
         BookEndPrint('----- datetime SetValue/GetValue failed')
         rval = False
 
+    # datetime (from datetime.datetime and datetime.timedelta)
+    inst25 = MI_Instance()
+    inst25.SetValue('datetime', datetime.datetime(2017, 5, 4, 3, 2, 1, 9))
+    if not datetime_eq(inst25.GetValue('datetime'),
+                       MI_Timestamp(2017, 5, 4, 3, 2, 1, 9, 0)):
+        BookEndPrint('----- datetime SetValue (datetime) failed')
+        rval = False
+    inst25.SetValue('datetime', datetime.timedelta(3, 3723, 9))
+    if not datetime_eq(inst25.GetValue('datetime'),
+                       MI_Interval(3, 1, 2, 3, 9)):
+        BookEndPrint('----- datetime SetValue (timedelta) failed')
+        rval = False
+
     # string
     string_vals = [
         'apple', 'banana', 'peach', 'pear', 'orange',
@@ -0,0 +1,139 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#include "hash_table_test.hpp"
+
+
+#include <cstdlib>
+#include <hash_table.hpp>
+#include <vector>
+
+
+using test::hash_table_test;
+
+
+namespace
+{
+
+
+// stops a probe at an empty (0) slot or at value
+class int_probe
+{
+public:
+    /*ctor*/ int_probe (int const value)
+        : m_Value (value)
+    {
+        // empty
+    }
+
+    bool operator () (int const item) const
+    {
+        return 0 == item || m_Value == item;
+    }
+
+private:
+    int const m_Value;
+};
+
+
+} // namespace (unnamed)
+
+
+/*ctor*/
+hash_table_test::hash_table_test ()
+{
+    add_test (MAKE_TEST (hash_table_test::test01));
+    add_test (MAKE_TEST (hash_table_test::test02));
+    add_test (MAKE_TEST (hash_table_test::test03));
+    add_test (MAKE_TEST (hash_table_test::test04));
+}
+
+
+int
+hash_table_test::test01 ()
+{
+    // test hash_name
+    int rval = EXIT_SUCCESS;
+    // the FNV-1a offset basis and the hash of "a"
+    if (static_cast<size_t>(2166136261u) !=
+            util::hash_name<util::exact_char> ("") ||
+        ((static_cast<size_t>(2166136261u) ^ 'a') *
+         static_cast<size_t>(16777619u)) !=
+            util::hash_name<util::exact_char> ("a"))
+    {
+        rval = EXIT_FAILURE;
+    }
+    if (util::hash_name<util::exact_char> ("Name") ==
+            util::hash_name<util::exact_char> ("NAME") ||
+        util::hash_name<util::folded_char> ("Name") !=
+            util::hash_name<util::folded_char> ("NAME") ||
+        util::hash_name<util::folded_char> ("name") !=
+            util::hash_name<util::exact_char> ("name"))
+    {
+        rval = EXIT_FAILURE;
+    }
+    // the seed changes the hash
+    if (util::hash_name<util::exact_char> ("Name") ==
+        util::hash_name<util::exact_char> ("Name", 8))
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
+int
+hash_table_test::test02 ()
+{
+    // test equal_names
+    int rval = EXIT_SUCCESS;
+    if (!util::equal_names<util::exact_char> ("Name", "Name") ||
+        util::equal_names<util::exact_char> ("Name", "name") ||
+        !util::equal_names<util::folded_char> ("Name", "nAME") ||
+        util::equal_names<util::folded_char> ("Name", "Names") ||
+        util::equal_names<util::folded_char> ("Names", "Name") ||
+        !util::equal_names<util::folded_char> ("", ""))
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
+int
+hash_table_test::test03 ()
+{
+    // test hash_table_size
+    int rval = EXIT_SUCCESS;
+    if (0 != util::hash_table_size (0) ||
+        2 != util::hash_table_size (1) ||
+        4 != util::hash_table_size (2) ||
+        8 != util::hash_table_size (3) ||
+        8 != util::hash_table_size (4) ||
+        16 != util::hash_table_size (5))
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
+int
+hash_table_test::test04 ()
+{
+    // test hash_probe
+    int rval = EXIT_SUCCESS;
+    std::vector<int> slots (8, 0);
+    slots[6] = 1;
+    slots[7] = 2;
+    slots[0] = 3;
+    // a probe wraps around the end of the table
+    if (6 != util::hash_probe (slots, 6, int_probe (1)) ||
+        7 != util::hash_probe (slots, 6, int_probe (2)) ||
+        0 != util::hash_probe (slots, 14, int_probe (3)) ||
+        1 != util::hash_probe (slots, 7, int_probe (4)) ||
+        3 != util::hash_probe (slots, 3, int_probe (1)))
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
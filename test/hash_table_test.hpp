@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#ifndef INCLUDED_HASH_TABLE_TEST_HPP
+#define INCLUDED_HASH_TABLE_TEST_HPP
+
+
+#include "test_helper.hpp"
+
+
+namespace test
+{
+
+
+class hash_table_test : public test_class<hash_table_test>
+{
+public:
+    /*ctor*/ hash_table_test ();
+
+    int test01 ();
+    int test02 ();
+    int test03 ();
+    int test04 ();
+};
+
+
+} // namespace test
+
+
+#endif // INCLUDED_HASH_TABLE_TEST_HPP
@@ -134,6 +134,20 @@ struct NonDeleter
 };
 
 
+class ArgType : public util::ref_counted_obj
+{
+public:
+    /*ctor*/ ArgType (
+        int const value,
+        int& target)
+        : m_value (value)
+    {
+        target = value;
+    }
+    int m_value;
+};
+
+
 } // namespace <unnamed>
 
 
@@ -207,6 +221,12 @@ internal_counted_ptr_test::internal_counted_ptr_test ()
     add_test (MAKE_TEST (internal_counted_ptr_test::test65));
     add_test (MAKE_TEST (internal_counted_ptr_test::test66));
     add_test (MAKE_TEST (internal_counted_ptr_test::test67));
+#if (UTIL_HAS_RVALUE_REFERENCES)
+    add_test (MAKE_TEST (internal_counted_ptr_test::test68));
+    add_test (MAKE_TEST (internal_counted_ptr_test::test69));
+    add_test (MAKE_TEST (internal_counted_ptr_test::test70));
+    add_test (MAKE_TEST (internal_counted_ptr_test::test71));
+#endif
 }
 
 
@@ -4500,3 +4520,226 @@ internal_counted_ptr_test::test67 ()
     }
     return rval;
 }
+
+
+#if (UTIL_HAS_RVALUE_REFERENCES)
+int
+internal_counted_ptr_test::test68 ()
+{
+    // test move constructor
+    int rval = EXIT_SUCCESS;
+    {
+        util::internal_counted_ptr<BaseType> pBase1;
+        util::internal_counted_ptr<BaseType> pBase2 (std::move (pBase1));
+        if (NULL != pBase1.get () ||
+            NULL != pBase2.get () ||
+            0 != BaseType::base_count)
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    {
+        BaseType* pBase = new BaseType;
+        util::internal_counted_ptr<BaseType> pBase1 (pBase);
+        util::internal_counted_ptr<BaseType> pBase2 (std::move (pBase1));
+        if (1 != BaseType::base_count ||
+            NULL != pBase1.get () ||
+            pBase2.get () != pBase ||
+            1 != pBase->use_count ())
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (0 != BaseType::base_count)
+    {
+        rval = EXIT_FAILURE;
+    }
+    {
+        BaseDeleter::base_count = 0;
+        BaseType* pBase = new BaseType;
+        util::internal_counted_ptr<BaseType, BaseDeleter> pBase1 (pBase);
+        util::internal_counted_ptr<BaseType, BaseDeleter> pBase2 (
+            std::move (pBase1));
+        if (1 != BaseType::base_count ||
+            NULL != pBase1.get () ||
+            pBase2.get () != pBase ||
+            1 != pBase->use_count () ||
+            0 != BaseDeleter::base_count)
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (0 != BaseType::base_count ||
+        1 != BaseDeleter::base_count)
+    {
+        rval = EXIT_FAILURE;
+    }
+    {
+        base_delete_count = 0;
+        BaseType* pBase = new BaseType;
+        util::internal_counted_ptr<BaseType, void(*)(BaseType*&)> pBase1 (
+            pBase, BaseDelete);
+        util::internal_counted_ptr<BaseType, void(*)(BaseType*&)> pBase2 (
+            std::move (pBase1));
+        if (1 != BaseType::base_count ||
+            NULL != pBase1.get () ||
+            pBase2.get () != pBase ||
+            1 != pBase->use_count () ||
+            0 != base_delete_count)
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (0 != BaseType::base_count ||
+        1 != base_delete_count)
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
+int
+internal_counted_ptr_test::test69 ()
+{
+    // test the move constructor which casts from a derived type
+    int rval = EXIT_SUCCESS;
+    {
+        DerivedType* pDerived = new DerivedType;
+        util::internal_counted_ptr<DerivedType> pDerived1 (pDerived);
+        util::internal_counted_ptr<BaseType> pBase (std::move (pDerived1));
+        if (1 != BaseType::base_count ||
+            1 != DerivedType::derived_count ||
+            NULL != pDerived1.get () ||
+            pBase.get () != pDerived ||
+            1 != pDerived->use_count ())
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (0 != BaseType::base_count ||
+        0 != DerivedType::derived_count)
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
+int
+internal_counted_ptr_test::test70 ()
+{
+    // test move assignment
+    int rval = EXIT_SUCCESS;
+    {
+        // something for something else
+        BaseType* pBaseA = new BaseType;
+        BaseType* pBaseB = new BaseType;
+        util::internal_counted_ptr<BaseType> pBase1 (pBaseA);
+        util::internal_counted_ptr<BaseType> pBase2 (pBaseB);
+        pBase2 = std::move (pBase1);
+        if (1 != BaseType::base_count ||
+            NULL != pBase1.get () ||
+            pBase2.get () != pBaseA ||
+            1 != pBaseA->use_count ())
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (0 != BaseType::base_count)
+    {
+        rval = EXIT_FAILURE;
+    }
+    {
+        // the same thing
+        BaseType* pBase = new BaseType;
+        util::internal_counted_ptr<BaseType> pBase1 (pBase);
+        util::internal_counted_ptr<BaseType> pBase2 (pBase1);
+        pBase2 = std::move (pBase1);
+        if (1 != BaseType::base_count ||
+            NULL != pBase1.get () ||
+            pBase2.get () != pBase ||
+            1 != pBase->use_count ())
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (0 != BaseType::base_count)
+    {
+        rval = EXIT_FAILURE;
+    }
+    {
+        // itself
+        BaseType* pBase = new BaseType;
+        util::internal_counted_ptr<BaseType> pBase1 (pBase);
+        util::internal_counted_ptr<BaseType>& rBase1 = pBase1;
+        pBase1 = std::move (rBase1);
+        if (1 != BaseType::base_count ||
+            pBase1.get () != pBase ||
+            1 != pBase->use_count ())
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (0 != BaseType::base_count)
+    {
+        rval = EXIT_FAILURE;
+    }
+    {
+        // from a derived type
+        DerivedType* pDerived = new DerivedType;
+        util::internal_counted_ptr<DerivedType> pDerived1 (pDerived);
+        util::internal_counted_ptr<BaseType> pBase (new BaseType);
+        pBase = std::move (pDerived1);
+        if (1 != BaseType::base_count ||
+            1 != DerivedType::derived_count ||
+            NULL != pDerived1.get () ||
+            pBase.get () != pDerived ||
+            1 != pDerived->use_count ())
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (0 != BaseType::base_count ||
+        0 != DerivedType::derived_count)
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
+int
+internal_counted_ptr_test::test71 ()
+{
+    // test make_counted
+    int rval = EXIT_SUCCESS;
+    {
+        util::internal_counted_ptr<BaseType> pBase =
+            util::make_counted<BaseType> ();
+        if (1 != BaseType::base_count ||
+            NULL == pBase.get () ||
+            1 != pBase.use_count ())
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (0 != BaseType::base_count)
+    {
+        rval = EXIT_FAILURE;
+    }
+    {
+        int target = 0;
+        util::internal_counted_ptr<ArgType> pArg =
+            util::make_counted<ArgType> (7, target);
+        if (NULL == pArg.get () ||
+            7 != pArg->m_value ||
+            7 != target ||
+            1 != pArg.use_count ())
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    return rval;
+}
+#endif
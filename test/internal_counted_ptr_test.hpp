@@ -7,6 +7,9 @@
 #include "test_helper.hpp"
 
 
+#include <traits.hpp>
+
+
 namespace test
 {
 
@@ -83,6 +86,12 @@ public:
     int test65 ();
     int test66 ();
     int test67 ();
+#if (UTIL_HAS_RVALUE_REFERENCES)
+    int test68 ();
+    int test69 ();
+    int test70 ();
+    int test71 ();
+#endif
 };
 
 
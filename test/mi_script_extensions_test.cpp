@@ -113,7 +113,6 @@ mi_script_extensions_test::mi_script_extensions_test ()
     SCHEMA.numClassDecls = card (CLASSES);
     add_test (MAKE_TEST (mi_script_extensions_test::test01));
     add_test (MAKE_TEST (mi_script_extensions_test::test02));
-    add_test (MAKE_TEST (mi_script_extensions_test::test03));
 }
 
 
@@ -134,44 +133,51 @@ mi_script_extensions_test::test01 ()
 int
 mi_script_extensions_test::test02 ()
 {
-    // test findClassDecl
+    // test schema_index
     int rval = EXIT_SUCCESS;
-    if (&CLASS_0 != findClassDecl (CLASS_NAME_0, &SCHEMA) ||
-        &CLASS_1 != findClassDecl (CLASS_NAME_1, &SCHEMA) ||
-        &CLASS_2 != findClassDecl (CLASS_NAME_2, &SCHEMA))
+    schema_index index;
+    if (NULL != index.getSchemaDecl () ||
+        NULL != index.findClassDecl (CLASS_NAME_0) ||
+        NULL != index.findMethodDecl (&CLASS_1, METHOD_NAME_0))
     {
         rval = EXIT_FAILURE;
     }
-    if (NULL != findClassDecl ("FakeName", &SCHEMA))
+    index.reset (&SCHEMA);
+    if (&SCHEMA != index.getSchemaDecl () ||
+        &CLASS_0 != index.findClassDecl (CLASS_NAME_0) ||
+        &CLASS_1 != index.findClassDecl (CLASS_NAME_1) ||
+        &CLASS_2 != index.findClassDecl (CLASS_NAME_2))
     {
         rval = EXIT_FAILURE;
     }
-    return rval;
-}
-
-
-int
-mi_script_extensions_test::test03 ()
-{
-    // test findMethodDecl
-    int rval = EXIT_SUCCESS;
-    if (&METHOD_0 != findMethodDecl (METHOD_NAME_0, &CLASS_1) ||
-        &METHOD_1 != findMethodDecl (METHOD_NAME_1, &CLASS_1) ||
-        &METHOD_2 != findMethodDecl (METHOD_NAME_2, &CLASS_1))
+    // class and method names are not case sensitive
+    if (&CLASS_1 != index.findClassDecl ("CLASSNAME1") ||
+        &CLASS_2 != index.findClassDecl ("classname2") ||
+        &METHOD_1 != index.findMethodDecl (&CLASS_1, "methodNAME1"))
+    {
+        rval = EXIT_FAILURE;
+    }
+    if (NULL != index.findClassDecl ("FakeName") ||
+        NULL != index.findClassDecl ("ClassName") ||
+        NULL != index.findClassDecl (NULL))
     {
         rval = EXIT_FAILURE;
     }
-    if (NULL != findMethodDecl ("FakeName", &CLASS_1))
+    if (&METHOD_0 != index.findMethodDecl (&CLASS_1, METHOD_NAME_0) ||
+        &METHOD_1 != index.findMethodDecl (&CLASS_1, METHOD_NAME_1) ||
+        &METHOD_2 != index.findMethodDecl (&CLASS_1, METHOD_NAME_2) ||
+        NULL != index.findMethodDecl (&CLASS_1, "FakeName"))
     {
         rval = EXIT_FAILURE;
     }
-    if (NULL != findMethodDecl (METHOD_NAME_0, &CLASS_0) ||
-        NULL != findMethodDecl (METHOD_NAME_1, &CLASS_0) ||
-        NULL != findMethodDecl (METHOD_NAME_2, &CLASS_0))
+    // methods are only found on the class that declares them
+    if (NULL != index.findMethodDecl (&CLASS_0, METHOD_NAME_0) ||
+        NULL != index.findMethodDecl (&CLASS_2, METHOD_NAME_1))
     {
         rval = EXIT_FAILURE;
     }
-    if (NULL != findMethodDecl ("FakeName", &CLASS_0))
+    index.reset (NULL);
+    if (NULL != index.findClassDecl (CLASS_NAME_0))
     {
         rval = EXIT_FAILURE;
     }
@@ -21,7 +21,6 @@ public:
 
     int test01 ();
     int test02 ();
-    int test03 ();
 
 private:
     MI_ClassDeclEx CLASS_0;
@@ -7,6 +7,7 @@
 #include <mi_value.hpp>
 #include <sys/socket.h>
 #include <unistd.h>
+#include <vector>
 
 
 using test::mi_value_test;
@@ -116,7 +117,8 @@ mi_value_test::mi_value_test ()
     add_test (MAKE_TEST (mi_value_test::test17));
     add_test (MAKE_TEST (mi_value_test::test18));
     add_test (MAKE_TEST (mi_value_test::test19));
-//    add_test (MAKE_TEST (mi_value_test::test20));
+    add_test (MAKE_TEST (mi_value_test::test20));
+    add_test (MAKE_TEST (mi_value_test::test21));
 }
 
 
@@ -2504,6 +2506,142 @@ mi_value_test::test19 ()
 int
 mi_value_test::test20 ()
 {
+    // test that arrays sent as one block match arrays sent item by item
     int rval = EXIT_SUCCESS;
+    scx::MI_Array<MI_UINT32A> arr;
+    std::vector<socket_wrapper::byte_t> itemBuffer;
+    socket_wrapper itemSock (&itemBuffer);
+    size_t const count = rand () % 1000 + 1;
+    rval = protocol::send_item_count (count, itemSock);
+    for (size_t i = 0; EXIT_SUCCESS == rval && i < count; ++i)
+    {
+        MI_Uint32 val = static_cast<MI_Uint32>(rand ());
+        arr.push_back (val);
+        rval = protocol::send (val, itemSock);
+    }
+    if (EXIT_SUCCESS == rval)
+    {
+        std::vector<socket_wrapper::byte_t> blockBuffer;
+        socket_wrapper blockSock (&blockBuffer);
+        rval = arr.send (blockSock);
+        if (EXIT_SUCCESS == rval &&
+            blockBuffer != itemBuffer)
+        {
+            std::cout << "block encoding differs" << std::endl;
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (EXIT_SUCCESS == rval)
+    {
+        socket_wrapper recvSock (&itemBuffer[0], itemBuffer.size ());
+        scx::MI_Array<MI_UINT32A>::Ptr pIn;
+        rval = scx::MI_Array<MI_UINT32A>::recv (&pIn, recvSock);
+        if (EXIT_SUCCESS == rval)
+        {
+            for (size_t i = 0; EXIT_SUCCESS == rval && i < count; ++i)
+            {
+                if (arr[i] != (*pIn)[i])
+                {
+                    rval = EXIT_FAILURE;
+                }
+            }
+        }
+    }
+    if (EXIT_SUCCESS == rval)
+    {
+        // booleans go over the wire as 0 or 1
+        scx::MI_Array<MI_BOOLEANA> boolArr;
+        boolArr.push_back (MI_FALSE);
+        boolArr.push_back (static_cast<MI_Boolean>(7));
+        std::vector<socket_wrapper::byte_t> boolBuffer;
+        socket_wrapper boolSock (&boolBuffer);
+        rval = boolArr.send (boolSock);
+        if (EXIT_SUCCESS == rval &&
+            (sizeof (protocol::item_count_t) + 2 != boolBuffer.size () ||
+             0 != boolBuffer[sizeof (protocol::item_count_t)] ||
+             1 != boolBuffer[sizeof (protocol::item_count_t) + 1]))
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (EXIT_SUCCESS != rval)
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
+int
+mi_value_test::test21 ()
+{
+    // test that string_table returns the same value for equal strings
+    int rval = EXIT_SUCCESS;
+    scx::MI_Value<MI_STRING>::Ptr pFirst =
+        scx::string_table::intern ("InternedName");
+    scx::MI_Value<MI_STRING>::Ptr pSecond = scx::string_table::intern (
+        scx::MI_Value<MI_STRING>::type_t ("InternedName"));
+    scx::MI_Value<MI_STRING>::Ptr pOther =
+        scx::string_table::intern ("OtherName");
+    if (!pFirst ||
+        pFirst != pSecond ||
+        pFirst == pOther ||
+        "InternedName" != pFirst->getValue () ||
+        "OtherName" != pOther->getValue ())
+    {
+        rval = EXIT_FAILURE;
+    }
+    // a value of the same text is replaced by the interned value
+    scx::MI_Value<MI_STRING>::ConstPtr pOwn (
+        new scx::MI_Value<MI_STRING> ("InternedName"));
+    if (pFirst != scx::string_table::intern (pOwn) ||
+        scx::string_table::intern (scx::MI_Value<MI_STRING>::ConstPtr ()))
+    {
+        rval = EXIT_FAILURE;
+    }
+    scx::MI_Value<MI_STRING>::Ptr pEmpty = scx::string_table::intern (
+        static_cast<MI_Char const*>(NULL));
+    if (!pEmpty ||
+        !pEmpty->getValue ().empty ())
+    {
+        rval = EXIT_FAILURE;
+    }
+    // enough strings to make the table grow
+    for (int i = 0; EXIT_SUCCESS == rval && i < 200; ++i)
+    {
+        std::ostringstream strm;
+        strm << "Name" << i;
+        if (scx::string_table::intern (strm.str ()) !=
+            scx::string_table::intern (strm.str ()))
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (EXIT_SUCCESS == rval &&
+        pFirst != scx::string_table::intern ("InternedName"))
+    {
+        rval = EXIT_FAILURE;
+    }
+    if (EXIT_SUCCESS == rval)
+    {
+        std::vector<socket_wrapper::byte_t> buffer;
+        socket_wrapper sock (&buffer);
+        rval = protocol::send ("InternedName", sock);
+        scx::MI_Value<MI_STRING>::Ptr pRecv;
+        if (EXIT_SUCCESS == rval)
+        {
+            socket_wrapper recvSock (&buffer[0], buffer.size ());
+            rval = scx::string_table::recv (&pRecv, recvSock);
+        }
+        if (EXIT_SUCCESS == rval &&
+            pFirst != pRecv)
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (EXIT_SUCCESS != rval)
+    {
+        rval = EXIT_FAILURE;
+    }
     return rval;
 }
@@ -0,0 +1,208 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#include "server_pool_test.hpp"
+
+
+#include <cstdlib>
+#include <server_pool.hpp>
+#include <set>
+#include <time.h>
+
+
+using test::server_pool_test;
+
+
+namespace
+{
+
+
+time_t
+now ()
+{
+    timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec;
+}
+
+
+// fake_pool runs workers without a Server or a client process and counts
+// the calls the pool makes to start, stop and restart them
+class fake_pool : public server_pool
+{
+public:
+    using server_pool::worker;
+    using server_pool::acquire;
+    using server_pool::release;
+    using server_pool::reap;
+
+    /*ctor*/ fake_pool (
+        size_t const& minWorkers,
+        size_t const& maxWorkers)
+        : server_pool ("", "", "", minWorkers, maxWorkers)
+        , nStarted (0)
+        , nStopped (0)
+        , nRestarted (0)
+    {
+        // empty
+    }
+
+    /*dtor*/ ~fake_pool ()
+    {
+        close ();
+    }
+
+    size_t nStarted;
+    size_t nStopped;
+    size_t nRestarted;
+    // the workers whose client has gone away
+    std::set<worker const*> lost;
+
+protected:
+    worker* start_worker ()
+    {
+        ++nStarted;
+        return new worker (NULL);
+    }
+
+    void stop_worker (worker* const pWorker)
+    {
+        ++nStopped;
+        delete pWorker;
+    }
+
+    bool restart_worker (worker* const pWorker)
+    {
+        ++nRestarted;
+        lost.erase (pWorker);
+        return true;
+    }
+
+    bool is_alive (worker* const pWorker)
+    {
+        return lost.end () == lost.find (pWorker);
+    }
+};
+
+
+} // namespace (unnamed)
+
+
+/*ctor*/
+server_pool_test::server_pool_test ()
+{
+    add_test (MAKE_TEST (server_pool_test::test01));
+    add_test (MAKE_TEST (server_pool_test::test02));
+    add_test (MAKE_TEST (server_pool_test::test03));
+}
+
+
+int
+server_pool_test::test01 ()
+{
+    // test that acquire hands out the least busy worker and starts another
+    // one while every worker is busy, up to maxWorkers
+    int rval = EXIT_SUCCESS;
+    fake_pool pool (1, 3);
+    fake_pool::worker* pWorker1 = pool.acquire ();
+    fake_pool::worker* pWorker2 = pool.acquire ();
+    fake_pool::worker* pWorker3 = pool.acquire ();
+    if (NULL == pWorker1 ||
+        NULL == pWorker2 ||
+        NULL == pWorker3 ||
+        pWorker1 == pWorker2 ||
+        pWorker2 == pWorker3 ||
+        pWorker1 == pWorker3 ||
+        3 != pool.nStarted ||
+        3 != pool.getWorkerCount ())
+    {
+        rval = EXIT_FAILURE;
+    }
+    pool.release (pWorker2);
+    fake_pool::worker* pWorker4 = pool.acquire ();
+    fake_pool::worker* pWorker5 = pool.acquire ();
+    if (pWorker2 != pWorker4 ||
+        NULL == pWorker5 ||
+        3 != pool.nStarted ||
+        3 != pool.getWorkerCount ())
+    {
+        rval = EXIT_FAILURE;
+    }
+    pool.release (pWorker1);
+    pool.release (pWorker3);
+    pool.release (pWorker4);
+    pool.release (pWorker5);
+    return rval;
+}
+
+
+int
+server_pool_test::test02 ()
+{
+    // test that reap stops the workers above minWorkers once they have been
+    // idle for IDLE_TIMEOUT, and leaves the busy ones alone
+    int rval = EXIT_SUCCESS;
+    fake_pool pool (1, 3);
+    fake_pool::worker* pWorker1 = pool.acquire ();
+    fake_pool::worker* pWorker2 = pool.acquire ();
+    fake_pool::worker* pWorker3 = pool.acquire ();
+    pool.release (pWorker1);
+    pool.release (pWorker3);
+    pool.reap (now ());
+    if (0 != pool.nStopped ||
+        3 != pool.getWorkerCount ())
+    {
+        rval = EXIT_FAILURE;
+    }
+    pool.reap (now () + server_pool::IDLE_TIMEOUT + 1);
+    if (1 != pool.nStopped ||
+        2 != pool.getWorkerCount ())
+    {
+        rval = EXIT_FAILURE;
+    }
+    pool.release (pWorker2);
+    pool.reap (now () + server_pool::IDLE_TIMEOUT + 1);
+    if (2 != pool.nStopped ||
+        1 != pool.getWorkerCount () ||
+        pWorker1 != pool.acquire ())
+    {
+        rval = EXIT_FAILURE;
+    }
+    pool.release (pWorker1);
+    return rval;
+}
+
+
+int
+server_pool_test::test03 ()
+{
+    // test that a worker whose client is gone isn't handed out, and that
+    // reap restarts it when it is one of the minWorkers and drops it when
+    // it isn't
+    int rval = EXIT_SUCCESS;
+    fake_pool pool (1, 2);
+    fake_pool::worker* pWorker1 = pool.acquire ();
+    fake_pool::worker* pWorker2 = pool.acquire ();
+    pool.release (pWorker1);
+    pool.release (pWorker2);
+    pool.lost.insert (pWorker1);
+    pool.lost.insert (pWorker2);
+    if (NULL != pool.acquire ())
+    {
+        rval = EXIT_FAILURE;
+    }
+    pool.reap (now ());
+    if (1 != pool.nRestarted ||
+        0 != pool.nStopped ||
+        1 != pool.getWorkerCount () ||
+        pool.lost.end () != pool.lost.find (pWorker1))
+    {
+        rval = EXIT_FAILURE;
+    }
+    fake_pool::worker* pWorker3 = pool.acquire ();
+    if (pWorker1 != pWorker3)
+    {
+        rval = EXIT_FAILURE;
+    }
+    pool.release (pWorker3);
+    return rval;
+}
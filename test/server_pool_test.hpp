@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#ifndef INCLUDED_SERVER_POOL_TEST_HPP
+#define INCLUDED_SERVER_POOL_TEST_HPP
+
+
+#include "test_helper.hpp"
+
+
+namespace test
+{
+
+
+class server_pool_test : public test_class<server_pool_test>
+{
+public:
+    /*ctor*/ server_pool_test ();
+
+    int test01 ();
+    int test02 ();
+    int test03 ();
+};
+
+
+} // namespace test
+
+
+#endif // INCLUDED_SERVER_POOL_TEST_HPP
@@ -0,0 +1,243 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#include "server_protocol_test.hpp"
+
+
+#include <cstdlib>
+#include <cstring>
+#include <server_protocol.hpp>
+#include <vector>
+
+
+using test::server_protocol_test;
+
+
+namespace
+{
+
+
+MI_Char const* const PROPERTY_NAME = "Count";
+MI_Char const* const CLASS_NAME = "ClassName";
+
+
+// ClassName has the one property, Count, an MI_UINT32
+struct test_schema
+{
+    /*ctor*/ test_schema ()
+    {
+        memset (&property, 0, sizeof (property));
+        property.name = PROPERTY_NAME;
+        property.type = MI_UINT32;
+        properties[0] = &property;
+        memset (&classDecl, 0, sizeof (classDecl));
+        classDecl.name = CLASS_NAME;
+        classDecl.properties = properties;
+        classDecl.numProperties = 1;
+        classes[0] = &classDecl;
+        memset (&schemaDecl, 0, sizeof (schemaDecl));
+        schemaDecl.classDecls = classes;
+        schemaDecl.numClassDecls = 1;
+        index.reset (&schemaDecl);
+    }
+
+    MI_PropertyDecl property;
+    MI_PropertyDecl const* properties[1];
+    MI_ClassDecl classDecl;
+    MI_ClassDecl const* classes[1];
+    MI_SchemaDecl schemaDecl;
+    schema_index index;
+};
+
+
+// encode the body of a POST_INSTANCE carrying a delta of ClassName that sets
+// the property at propertyIndex to value
+int
+send_delta (
+    MI_Uint32 const& propertyIndex,
+    MI_Uint32 const& value,
+    socket_wrapper& sock)
+{
+    int rval = protocol::send (
+        protocol::MI_ORDINAL_FLAG | protocol::MI_DELTA_FLAG, sock);
+    if (socket_wrapper::SUCCESS == rval)
+    {
+        rval = protocol::send (MI_Uint32 (0), sock);
+    }
+    if (socket_wrapper::SUCCESS == rval)
+    {
+        rval = protocol::send_item_count (1, sock);
+    }
+    if (socket_wrapper::SUCCESS == rval)
+    {
+        rval = protocol::send (propertyIndex, sock);
+    }
+    if (socket_wrapper::SUCCESS == rval)
+    {
+        rval = protocol::send_type (MI_UINT32, sock);
+    }
+    if (socket_wrapper::SUCCESS == rval)
+    {
+        rval = protocol::send (value, sock);
+    }
+    return rval;
+}
+
+
+// post the delta, then the client's result, to a request and return the
+// result the request ends with
+int
+post_delta (
+    MI_Uint32 const& propertyIndex,
+    MI_Result const& clientResult,
+    MI_Result* const pResultOut,
+    protocol::request_state* const pState)
+{
+    test_schema schema;
+    // the context is only used once an instance decodes
+    int context = 0;
+    MI_Context* const pContext = reinterpret_cast<MI_Context*>(&context);
+    // each message is a frame of its own, as the server reads them
+    std::vector<socket_wrapper::byte_t> instanceBuffer;
+    socket_wrapper instanceSock (&instanceBuffer);
+    std::vector<socket_wrapper::byte_t> resultBuffer;
+    socket_wrapper resultSock (&resultBuffer);
+    int rval = send_delta (propertyIndex, 42, instanceSock);
+    if (socket_wrapper::SUCCESS == rval)
+    {
+        rval = protocol::send (clientResult, resultSock);
+    }
+    if (socket_wrapper::SUCCESS == rval)
+    {
+        socket_wrapper recvSock (&instanceBuffer[0], instanceBuffer.size ());
+        if (socket_wrapper::SUCCESS == protocol::recv_post_instance (
+                pContext, &(schema.index), NULL, pState, recvSock))
+        {
+            // the delta must not decode
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (socket_wrapper::SUCCESS == rval)
+    {
+        socket_wrapper recvSock (&resultBuffer[0], resultBuffer.size ());
+        rval = protocol::recv_post_result (
+            pContext, pResultOut, *pState, recvSock);
+    }
+    return rval;
+}
+
+
+} // namespace (unnamed)
+
+
+/*ctor*/
+server_protocol_test::server_protocol_test ()
+{
+    add_test (MAKE_TEST (server_protocol_test::test01));
+    add_test (MAKE_TEST (server_protocol_test::test02));
+    add_test (MAKE_TEST (server_protocol_test::test03));
+    add_test (MAKE_TEST (server_protocol_test::test04));
+}
+
+
+int
+server_protocol_test::test01 ()
+{
+    // test that a delta without a template fails its request even though
+    // the client posts MI_RESULT_OK
+    int rval = EXIT_SUCCESS;
+    protocol::request_state state;
+    MI_Result result = MI_RESULT_OK;
+    if (socket_wrapper::SUCCESS != post_delta (
+            0, MI_RESULT_OK, &result, &state) ||
+        !state.dropped ||
+        MI_RESULT_FAILED != result ||
+        NULL != state.templates.get (0))
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
+int
+server_protocol_test::test02 ()
+{
+    // test that a delta naming a property the class doesn't have fails its
+    // request, and that an error the client posts is kept
+    int rval = EXIT_SUCCESS;
+    protocol::request_state state;
+    MI_Result result = MI_RESULT_OK;
+    if (socket_wrapper::SUCCESS != post_delta (
+            1, MI_RESULT_OK, &result, &state) ||
+        !state.dropped ||
+        MI_RESULT_FAILED != result)
+    {
+        rval = EXIT_FAILURE;
+    }
+    protocol::request_state errorState;
+    if (socket_wrapper::SUCCESS != post_delta (
+            1, MI_RESULT_NOT_SUPPORTED, &result, &errorState) ||
+        !errorState.dropped ||
+        MI_RESULT_NOT_SUPPORTED != result)
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
+int
+server_protocol_test::test03 ()
+{
+    // test that a request that dropped nothing ends with the client's result
+    int rval = EXIT_SUCCESS;
+    int context = 0;
+    MI_Context* const pContext = reinterpret_cast<MI_Context*>(&context);
+    std::vector<socket_wrapper::byte_t> buffer;
+    socket_wrapper sendSock (&buffer);
+    if (socket_wrapper::SUCCESS !=
+            protocol::send (MI_RESULT_OK, sendSock) ||
+        socket_wrapper::SUCCESS !=
+            protocol::send (MI_RESULT_ACCESS_DENIED, sendSock))
+    {
+        rval = EXIT_FAILURE;
+    }
+    else
+    {
+        protocol::request_state state;
+        socket_wrapper recvSock (&buffer[0], buffer.size ());
+        MI_Result result = MI_RESULT_FAILED;
+        if (socket_wrapper::SUCCESS != protocol::recv_post_result (
+                pContext, &result, state, recvSock) ||
+            MI_RESULT_OK != result ||
+            socket_wrapper::SUCCESS != protocol::recv_post_result (
+                pContext, &result, state, recvSock) ||
+            MI_RESULT_ACCESS_DENIED != result)
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    return rval;
+}
+
+
+int
+server_protocol_test::test04 ()
+{
+    // test that a delta that fails to decode drops the class's template
+    int rval = EXIT_SUCCESS;
+    // the template is never read, it only has to be deletable
+    MI_Instance instance;
+    memset (&instance, 0, sizeof (instance));
+    protocol::request_state state;
+    state.templates.set (0, &instance);
+    MI_Result result = MI_RESULT_OK;
+    if (socket_wrapper::SUCCESS != post_delta (
+            1, MI_RESULT_OK, &result, &state) ||
+        !state.dropped ||
+        NULL != state.templates.get (0))
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#ifndef INCLUDED_SERVER_PROTOCOL_TEST_HPP
+#define INCLUDED_SERVER_PROTOCOL_TEST_HPP
+
+
+#include "test_helper.hpp"
+
+
+namespace test
+{
+
+
+class server_protocol_test : public test_class<server_protocol_test>
+{
+public:
+    /*ctor*/ server_protocol_test ();
+
+    int test01 ();
+    int test02 ();
+    int test03 ();
+    int test04 ();
+};
+
+
+} // namespace test
+
+
+#endif // INCLUDED_SERVER_PROTOCOL_TEST_HPP
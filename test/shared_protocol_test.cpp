@@ -10,6 +10,7 @@
 #include <signal.h>
 #include <sys/socket.h>
 #include <unistd.h>
+#include <vector>
 
 
 using test::shared_protocol_test;
@@ -125,6 +126,7 @@ shared_protocol_test::shared_protocol_test ()
     add_test (MAKE_TEST (shared_protocol_test::test16));
     add_test (MAKE_TEST (shared_protocol_test::test17));
     add_test (MAKE_TEST (shared_protocol_test::test18));
+    add_test (MAKE_TEST (shared_protocol_test::test19));
 }
 
 
@@ -273,13 +275,17 @@ shared_protocol_test::test04 ()
     int rval = create_sockets (&sendSock, &recvSock);
     for (size_t i = 0; EXIT_SUCCESS == rval && i < card (vals); ++i)
     {
-        rval = protocol::send_opcode (vals[i], *sendSock);
+        protocol::request_id_t const requestID =
+            static_cast<protocol::request_id_t>(0x10001 * (i + 1));
+        rval = protocol::send_opcode (vals[i], requestID, *sendSock);
         if (EXIT_SUCCESS == rval)
         {
             protocol::opcode_t opcodeIn;
-            rval = protocol::recv_opcode (&opcodeIn, *recvSock);
+            protocol::request_id_t requestIDIn;
+            rval = protocol::recv_opcode (&opcodeIn, &requestIDIn, *recvSock);
             if (EXIT_SUCCESS == rval &&
-                vals[i] != opcodeIn)
+                (vals[i] != opcodeIn ||
+                 requestID != requestIDIn))
             {
                 rval = EXIT_FAILURE;
             }
@@ -881,3 +887,86 @@ shared_protocol_test::test18 ()
     }
     return rval;
 }
+
+
+int
+shared_protocol_test::test19 ()
+{
+    // test recv_in_place (MI_Char const*)
+    size_t len = rand () % 995 + 5;
+    util::unique_ptr<MI_Char[]> strOut (create_rand_string (len));
+    std::vector<socket_wrapper::byte_t> buffer;
+    socket_wrapper encoder (&buffer);
+    int rval = protocol::send (strOut.get (), encoder);
+    if (EXIT_SUCCESS == rval)
+    {
+        rval = protocol::send (static_cast<MI_Char const*>(NULL), encoder);
+    }
+    if (EXIT_SUCCESS == rval)
+    {
+        // from memory the string is left where it lies
+        socket_wrapper decoder (&buffer[0], buffer.size ());
+        MI_Char const* pStrIn = NULL;
+        util::unique_ptr<MI_Char[]> copy;
+        rval = protocol::recv_in_place (&pStrIn, &copy, decoder);
+        if (EXIT_SUCCESS == rval &&
+            (copy ||
+             reinterpret_cast<MI_Char const*>(
+                 &buffer[0] + sizeof (protocol::item_count_t)) != pStrIn ||
+             0 != strcmp (pStrIn, strOut.get ())))
+        {
+            rval = EXIT_FAILURE;
+        }
+        if (EXIT_SUCCESS == rval)
+        {
+            rval = protocol::recv_in_place (&pStrIn, &copy, decoder);
+            if (EXIT_SUCCESS == rval &&
+                NULL != pStrIn)
+            {
+                rval = EXIT_FAILURE;
+            }
+        }
+    }
+    if (EXIT_SUCCESS == rval)
+    {
+        // a string that isn't terminated is rejected
+        buffer[sizeof (protocol::item_count_t) + len] = 'x';
+        socket_wrapper decoder (&buffer[0], buffer.size ());
+        MI_Char const* pStrIn = NULL;
+        util::unique_ptr<MI_Char[]> copy;
+        if (EXIT_SUCCESS ==
+                protocol::recv_in_place (&pStrIn, &copy, decoder))
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    socket_wrapper::Ptr sendSock;
+    socket_wrapper::Ptr recvSock;
+    if (EXIT_SUCCESS == rval)
+    {
+        rval = create_sockets (&sendSock, &recvSock);
+    }
+    if (EXIT_SUCCESS == rval)
+    {
+        // from a stream the string is copied
+        rval = protocol::send (strOut.get (), *sendSock);
+        if (EXIT_SUCCESS == rval)
+        {
+            MI_Char const* pStrIn = NULL;
+            util::unique_ptr<MI_Char[]> copy;
+            rval = protocol::recv_in_place (&pStrIn, &copy, *recvSock);
+            if (EXIT_SUCCESS == rval &&
+                (copy.get () != pStrIn ||
+                 NULL == pStrIn ||
+                 0 != strcmp (pStrIn, strOut.get ())))
+            {
+                rval = EXIT_FAILURE;
+            }
+        }
+    }
+    if (EXIT_SUCCESS != rval)
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
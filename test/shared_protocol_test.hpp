@@ -34,6 +34,7 @@ public:
     int test16 ();
     int test17 ();
     int test18 ();
+    int test19 ();
 };
 
 
@@ -0,0 +1,403 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#include "shared_ring_test.hpp"
+
+
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <shared_ring.hpp>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+
+using test::shared_ring_test;
+
+
+namespace
+{
+
+
+void
+fill_record (
+    std::vector<unsigned char>* pRecord,
+    size_t const& size,
+    unsigned int const& seed)
+{
+    pRecord->resize (size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        (*pRecord)[i] = static_cast<unsigned char>(seed + i);
+    }
+}
+
+
+bool
+check_record (
+    shared_ring::byte_t const* pData,
+    size_t const& nBytes,
+    size_t const& size,
+    unsigned int const& seed)
+{
+    bool rval = size == nBytes;
+    for (size_t i = 0; rval && i < size; ++i)
+    {
+        rval = static_cast<unsigned char>(seed + i) == pData[i];
+    }
+    return rval;
+}
+
+
+} // namespace (unnamed)
+
+
+/*ctor*/
+shared_ring_test::shared_ring_test ()
+{
+    add_test (MAKE_TEST (shared_ring_test::test01));
+    add_test (MAKE_TEST (shared_ring_test::test02));
+    add_test (MAKE_TEST (shared_ring_test::test03));
+    add_test (MAKE_TEST (shared_ring_test::test04));
+    add_test (MAKE_TEST (shared_ring_test::test05));
+    add_test (MAKE_TEST (shared_ring_test::test06));
+}
+
+
+int
+shared_ring_test::test01 ()
+{
+    // test create and attach, the backing file isn't inherited on exec
+    int rval = EXIT_SUCCESS;
+    shared_ring::Ptr pRing;
+    if (shared_ring::SUCCESS ==
+            shared_ring::create (shared_ring::DEFAULT_CAPACITY, &pRing) &&
+        pRing &&
+        shared_ring::INVALID_FD != pRing->getFD () &&
+        0 != (FD_CLOEXEC & fcntl (pRing->getFD (), F_GETFD)))
+    {
+        shared_ring::Ptr pAttached;
+        if (shared_ring::SUCCESS !=
+                shared_ring::attach (dup (pRing->getFD ()), &pAttached) ||
+            !pAttached ||
+            pRing->getMaxRecordSize () != pAttached->getMaxRecordSize ())
+        {
+            rval = EXIT_FAILURE;
+        }
+        pRing->closeFD ();
+        if (shared_ring::INVALID_FD != pRing->getFD ())
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        rval = EXIT_FAILURE;
+    }
+    // attach to something that isn't a ring
+    shared_ring::Ptr pBad;
+    if (shared_ring::SUCCESS ==
+            shared_ring::attach (shared_ring::INVALID_FD, &pBad) ||
+        pBad)
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
+int
+shared_ring_test::test02 ()
+{
+    // test write, peek, and consume through a second mapping
+    int rval = EXIT_SUCCESS;
+    shared_ring::Ptr pProducer;
+    shared_ring::Ptr pConsumer;
+    if (shared_ring::SUCCESS ==
+            shared_ring::create (shared_ring::DEFAULT_CAPACITY, &pProducer) &&
+        shared_ring::SUCCESS ==
+            shared_ring::attach (dup (pProducer->getFD ()), &pConsumer))
+    {
+        shared_ring::byte_t const* pData = NULL;
+        size_t nBytes = 0;
+        if (shared_ring::EMPTY != pConsumer->peek (&pData, &nBytes))
+        {
+            rval = EXIT_FAILURE;
+        }
+        std::vector<unsigned char> record;
+        for (unsigned int i = 0; i < 10; ++i)
+        {
+            fill_record (&record, 1 + i * 7, i);
+            if (shared_ring::SUCCESS !=
+                    pProducer->write (&record[0], record.size ()))
+            {
+                rval = EXIT_FAILURE;
+            }
+        }
+        for (unsigned int i = 0; i < 10; ++i)
+        {
+            if (shared_ring::SUCCESS != pConsumer->peek (&pData, &nBytes) ||
+                !check_record (pData, nBytes, 1 + i * 7, i))
+            {
+                rval = EXIT_FAILURE;
+            }
+            pConsumer->consume ();
+        }
+        if (shared_ring::EMPTY != pConsumer->peek (&pData, &nBytes))
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
+int
+shared_ring_test::test03 ()
+{
+    // test FULL and records that have to wrap to the start of the ring
+    int rval = EXIT_SUCCESS;
+    shared_ring::Ptr pRing;
+    if (shared_ring::SUCCESS == shared_ring::create (0, &pRing))
+    {
+        size_t const RECORD_SIZE = 1000;
+        std::vector<unsigned char> record;
+        shared_ring::byte_t const* pData = NULL;
+        size_t nBytes = 0;
+        unsigned int written = 0;
+        unsigned int read = 0;
+        for (int pass = 0; EXIT_SUCCESS == rval && pass < 4; ++pass)
+        {
+            // fill the ring
+            int result = shared_ring::SUCCESS;
+            while (shared_ring::SUCCESS == result)
+            {
+                fill_record (&record, RECORD_SIZE, written);
+                result = pRing->write (&record[0], record.size ());
+                if (shared_ring::SUCCESS == result)
+                {
+                    ++written;
+                }
+            }
+            if (shared_ring::FULL != result)
+            {
+                rval = EXIT_FAILURE;
+            }
+            // drain about half of it
+            for (int i = 0; EXIT_SUCCESS == rval && i < 30; ++i)
+            {
+                if (shared_ring::SUCCESS == pRing->peek (&pData, &nBytes) &&
+                    check_record (pData, nBytes, RECORD_SIZE, read))
+                {
+                    pRing->consume ();
+                    ++read;
+                }
+                else
+                {
+                    rval = EXIT_FAILURE;
+                }
+            }
+        }
+        while (EXIT_SUCCESS == rval &&
+               shared_ring::SUCCESS == pRing->peek (&pData, &nBytes))
+        {
+            if (check_record (pData, nBytes, RECORD_SIZE, read))
+            {
+                pRing->consume ();
+                ++read;
+            }
+            else
+            {
+                rval = EXIT_FAILURE;
+            }
+        }
+        if (written != read)
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
+int
+shared_ring_test::test04 ()
+{
+    // test TOO_LARGE
+    int rval = EXIT_SUCCESS;
+    shared_ring::Ptr pRing;
+    if (shared_ring::SUCCESS == shared_ring::create (0, &pRing))
+    {
+        std::vector<unsigned char> record (pRing->getMaxRecordSize () + 1);
+        if (shared_ring::TOO_LARGE !=
+                pRing->write (&record[0], record.size ()) ||
+            shared_ring::SUCCESS !=
+                pRing->write (&record[0], record.size () - 1))
+        {
+            rval = EXIT_FAILURE;
+        }
+        if (shared_ring::TOO_LARGE !=
+                pRing->waitForSpace (record.size (), -1))
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
+int
+shared_ring_test::test05 ()
+{
+    // test a producer in another process that has to wait for space
+    int rval = EXIT_SUCCESS;
+    unsigned int const RECORD_COUNT = 5000;
+    size_t const RECORD_SIZE = 333;
+    shared_ring::Ptr pRing;
+    int fds[2];
+    if (shared_ring::SUCCESS == shared_ring::create (0, &pRing) &&
+        -1 != socketpair (AF_UNIX, SOCK_STREAM, 0, fds))
+    {
+        pid_t pid = fork ();
+        if (0 == pid)
+        {
+            close (fds[0]);
+            int result = EXIT_SUCCESS;
+            shared_ring::Ptr pProducer;
+            if (shared_ring::SUCCESS ==
+                    shared_ring::attach (pRing->getFD (), &pProducer))
+            {
+                std::vector<unsigned char> record;
+                for (unsigned int i = 0;
+                     EXIT_SUCCESS == result && i < RECORD_COUNT;
+                     ++i)
+                {
+                    fill_record (&record, RECORD_SIZE, i);
+                    if (shared_ring::SUCCESS != pProducer->waitForSpace (
+                            record.size (), fds[1]) ||
+                        shared_ring::SUCCESS != pProducer->write (
+                            &record[0], record.size ()))
+                    {
+                        result = EXIT_FAILURE;
+                    }
+                }
+            }
+            else
+            {
+                result = EXIT_FAILURE;
+            }
+            _exit (result);
+        }
+        else if (-1 != pid)
+        {
+            close (fds[1]);
+            shared_ring::byte_t const* pData = NULL;
+            size_t nBytes = 0;
+            unsigned int read = 0;
+            while (EXIT_SUCCESS == rval &&
+                   RECORD_COUNT > read)
+            {
+                if (shared_ring::SUCCESS == pRing->peek (&pData, &nBytes))
+                {
+                    if (!check_record (pData, nBytes, RECORD_SIZE, read))
+                    {
+                        rval = EXIT_FAILURE;
+                    }
+                    pRing->consume ();
+                    ++read;
+                }
+                else
+                {
+                    usleep (100);
+                }
+            }
+            int status = EXIT_FAILURE;
+            if (pid != waitpid (pid, &status, 0) ||
+                !WIFEXITED (status) ||
+                EXIT_SUCCESS != WEXITSTATUS (status))
+            {
+                rval = EXIT_FAILURE;
+            }
+            close (fds[0]);
+        }
+        else
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
+int
+shared_ring_test::test06 ()
+{
+    // test records and a header the producer has corrupted
+    int rval = EXIT_SUCCESS;
+    size_t const HEADER_SIZE = 4096;
+    size_t const MAPPING_SIZE = HEADER_SIZE + 64 * 1024;
+    shared_ring::Ptr pRing;
+    void* pMapping = MAP_FAILED;
+    if (shared_ring::SUCCESS == shared_ring::create (0, &pRing) &&
+        MAP_FAILED != (pMapping = mmap (NULL, MAPPING_SIZE,
+                                        PROT_READ | PROT_WRITE, MAP_SHARED,
+                                        pRing->getFD (), 0)))
+    {
+        unsigned int* pCapacity = reinterpret_cast<unsigned int*>(pMapping);
+        unsigned int* pLength = reinterpret_cast<unsigned int*>(
+            reinterpret_cast<unsigned char*>(pMapping) + HEADER_SIZE + 16);
+        std::vector<unsigned char> record;
+        shared_ring::byte_t const* pData = NULL;
+        size_t nBytes = 0;
+        // the capacity in the mapping is ignored once the ring is created
+        fill_record (&record, 10, 0);
+        *pCapacity = 0x80000000;
+        if (shared_ring::SUCCESS != pRing->write (&record[0], record.size ()) ||
+            shared_ring::SUCCESS != pRing->peek (&pData, &nBytes) ||
+            !check_record (pData, nBytes, record.size (), 0))
+        {
+            rval = EXIT_FAILURE;
+        }
+        pRing->consume ();
+        // a length past the records written fails the ring for good
+        fill_record (&record, 10, 1);
+        if (shared_ring::SUCCESS != pRing->write (&record[0], record.size ()))
+        {
+            rval = EXIT_FAILURE;
+        }
+        *pLength = 1000;
+        if (shared_ring::INVALID_RECORD != pRing->peek (&pData, &nBytes))
+        {
+            rval = EXIT_FAILURE;
+        }
+        *pLength = static_cast<unsigned int>(record.size ());
+        if (shared_ring::INVALID_RECORD != pRing->peek (&pData, &nBytes))
+        {
+            rval = EXIT_FAILURE;
+        }
+        munmap (pMapping, MAPPING_SIZE);
+    }
+    else
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#ifndef INCLUDED_SHARED_RING_TEST_HPP
+#define INCLUDED_SHARED_RING_TEST_HPP
+
+
+#include "test_helper.hpp"
+
+
+namespace test
+{
+
+
+class shared_ring_test : public test_class<shared_ring_test>
+{
+public:
+    /*ctor*/ shared_ring_test ();
+
+    int test01 ();
+    int test02 ();
+    int test03 ();
+    int test04 ();
+    int test05 ();
+    int test06 ();
+};
+
+
+} // namespace test
+
+
+#endif // INCLUDED_SHARED_RING_TEST_HPP
@@ -6,10 +6,14 @@
 #include <cstdlib>
 #include <cstring>
 #include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <signal.h>
 #include <socket_wrapper.hpp>
 #include <sys/socket.h>
+#include <sys/wait.h>
 #include <unistd.h>
+#include <vector>
 
 
 using test::socket_wrapper_test;
@@ -51,6 +55,11 @@ socket_wrapper_test::socket_wrapper_test ()
     add_test (MAKE_TEST (socket_wrapper_test::test02));
     add_test (MAKE_TEST (socket_wrapper_test::test03));
     add_test (MAKE_TEST (socket_wrapper_test::test04));
+    add_test (MAKE_TEST (socket_wrapper_test::test05));
+    add_test (MAKE_TEST (socket_wrapper_test::test06));
+    add_test (MAKE_TEST (socket_wrapper_test::test07));
+    add_test (MAKE_TEST (socket_wrapper_test::test08));
+    add_test (MAKE_TEST (socket_wrapper_test::test09));
 }
 
 
@@ -174,3 +183,327 @@ socket_wrapper_test::test04 ()
     }
     return rval;
 }
+
+
+int
+socket_wrapper_test::test05 ()
+{
+    // test buffered send, flush, and recv
+    int rval = EXIT_SUCCESS;
+    size_t const BLOB_SIZE = 20;
+    int fds[2];
+    if (-1 != socketpair (AF_UNIX, SOCK_STREAM, 0, fds))
+    {
+        socket_wrapper sock0 (fds[0], socket_wrapper::BUFFERED);
+        socket_wrapper sock1 (fds[1], socket_wrapper::BUFFERED);
+        int originalBlob[BLOB_SIZE];
+        create_rand_blob (reinterpret_cast<unsigned char*>(originalBlob),
+                          sizeof (originalBlob));
+        for (size_t i = 0; i < BLOB_SIZE; ++i)
+        {
+            if (socket_wrapper::SUCCESS != sock0.send (
+                    reinterpret_cast<socket_wrapper::byte_t*>(
+                        originalBlob + i),
+                    sizeof (int)))
+            {
+                rval = EXIT_FAILURE;
+            }
+        }
+        // nothing should have reached the socket before the flush
+        int flags = fcntl (fds[1], F_GETFL);
+        fcntl (fds[1], F_SETFL, flags | O_NONBLOCK);
+        int probe = 0;
+        if (-1 != read (fds[1], &probe, sizeof (probe)) ||
+            (EAGAIN != errno && EWOULDBLOCK != errno))
+        {
+            rval = EXIT_FAILURE;
+        }
+        fcntl (fds[1], F_SETFL, flags);
+        if (socket_wrapper::SUCCESS != sock0.flush ())
+        {
+            rval = EXIT_FAILURE;
+        }
+        int receivedBlob[BLOB_SIZE];
+        for (size_t i = 0; i < BLOB_SIZE; ++i)
+        {
+            if (socket_wrapper::SUCCESS != sock1.recv (
+                    reinterpret_cast<socket_wrapper::byte_t*>(
+                        receivedBlob + i),
+                    sizeof (int)))
+            {
+                rval = EXIT_FAILURE;
+            }
+        }
+        if (0 != memcmp (originalBlob, receivedBlob, sizeof (originalBlob)))
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
+int
+socket_wrapper_test::test06 ()
+{
+    // test buffered send and recv of data larger than the buffer
+    int rval = EXIT_SUCCESS;
+    size_t const BLOB_SIZE = socket_wrapper::BUFFER_SIZE + 13;
+    int fds[2];
+    if (-1 != socketpair (AF_UNIX, SOCK_STREAM, 0, fds))
+    {
+        socket_wrapper sock0 (fds[0], socket_wrapper::BUFFERED);
+        socket_wrapper sock1 (fds[1], socket_wrapper::BUFFERED);
+        unsigned char* originalBlob = new unsigned char[BLOB_SIZE];
+        unsigned char* receivedBlob = new unsigned char[BLOB_SIZE];
+        create_rand_blob (originalBlob, BLOB_SIZE);
+        pid_t pid = fork ();
+        if (0 == pid)
+        {
+            // child: a small send followed by a large one that has to
+            // bypass the buffer
+            int result = EXIT_SUCCESS;
+            if (socket_wrapper::SUCCESS != sock0.send (originalBlob, 7) ||
+                socket_wrapper::SUCCESS != sock0.send (
+                    originalBlob + 7, BLOB_SIZE - 7) ||
+                socket_wrapper::SUCCESS != sock0.flush ())
+            {
+                result = EXIT_FAILURE;
+            }
+            _exit (result);
+        }
+        else if (-1 != pid)
+        {
+            // a large recv followed by a small one served from the buffer
+            if (socket_wrapper::SUCCESS != sock1.recv (
+                    receivedBlob, BLOB_SIZE - 3) ||
+                socket_wrapper::SUCCESS != sock1.recv (
+                    receivedBlob + BLOB_SIZE - 3, 3))
+            {
+                rval = EXIT_FAILURE;
+            }
+            if (0 != memcmp (originalBlob, receivedBlob, BLOB_SIZE))
+            {
+                rval = EXIT_FAILURE;
+            }
+            int status = EXIT_FAILURE;
+            if (pid != waitpid (pid, &status, 0) ||
+                !WIFEXITED (status) ||
+                EXIT_SUCCESS != WEXITSTATUS (status))
+            {
+                rval = EXIT_FAILURE;
+            }
+        }
+        else
+        {
+            rval = EXIT_FAILURE;
+        }
+        delete[] receivedBlob;
+        delete[] originalBlob;
+    }
+    else
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
+int
+socket_wrapper_test::test07 ()
+{
+    // test encoding to and decoding from memory
+    int rval = EXIT_SUCCESS;
+    size_t const BLOB_SIZE = 20;
+    int originalBlob[BLOB_SIZE];
+    create_rand_blob (reinterpret_cast<unsigned char*>(originalBlob),
+                      sizeof (originalBlob));
+    std::vector<socket_wrapper::byte_t> buffer;
+    socket_wrapper target (&buffer);
+    for (size_t i = 0; i < BLOB_SIZE; ++i)
+    {
+        if (socket_wrapper::SUCCESS != target.send (
+                reinterpret_cast<socket_wrapper::byte_t*>(originalBlob + i),
+                sizeof (int)))
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (sizeof (originalBlob) != buffer.size () ||
+        0 != memcmp (originalBlob, &buffer[0], sizeof (originalBlob)))
+    {
+        rval = EXIT_FAILURE;
+    }
+    socket_wrapper source (&buffer[0], buffer.size ());
+    int receivedBlob[BLOB_SIZE];
+    if (socket_wrapper::SUCCESS != source.recv (
+            reinterpret_cast<socket_wrapper::byte_t*>(receivedBlob),
+            sizeof (receivedBlob)) ||
+        0 != memcmp (originalBlob, receivedBlob, sizeof (originalBlob)))
+    {
+        rval = EXIT_FAILURE;
+    }
+    // reading past the end fails
+    if (socket_wrapper::RECV_FAILED != source.recv (
+            reinterpret_cast<socket_wrapper::byte_t*>(receivedBlob), 1))
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
+int
+socket_wrapper_test::test08 ()
+{
+    // test framed messages
+    int rval = EXIT_SUCCESS;
+    int fds[2];
+    if (-1 != socketpair (AF_UNIX, SOCK_STREAM, 0, fds))
+    {
+        socket_wrapper sock0 (fds[0], socket_wrapper::FRAMED);
+        socket_wrapper sock1 (fds[1], socket_wrapper::FRAMED);
+        int values[] = { 1, 2, 3, 4, 5 };
+        socket_wrapper::byte_t const* pValues =
+            reinterpret_cast<socket_wrapper::byte_t const*>(values);
+        // message 1: { 1 } (a send outside a message starts one)
+        // message 2: { 2, 3 }
+        // message 3: { 4, 5 }
+        if (socket_wrapper::SUCCESS != sock0.send (pValues, sizeof (int)) ||
+            socket_wrapper::SUCCESS != sock0.beginSendMessage () ||
+            socket_wrapper::SUCCESS != sock0.send (
+                pValues + sizeof (int), 2 * sizeof (int)) ||
+            socket_wrapper::SUCCESS != sock0.beginSendMessage () ||
+            socket_wrapper::SUCCESS != sock0.send (
+                pValues + 3 * sizeof (int), 2 * sizeof (int)) ||
+            socket_wrapper::SUCCESS != sock0.flush ())
+        {
+            rval = EXIT_FAILURE;
+        }
+        // the frames are length prefixed on the wire
+        socket_wrapper::frame_len_t frameLen = 0;
+        int value = 0;
+        if (sizeof (frameLen) != read (fds[1], &frameLen, sizeof (frameLen)) ||
+            sizeof (int) != frameLen ||
+            sizeof (value) != read (fds[1], &value, sizeof (value)) ||
+            1 != value)
+        {
+            rval = EXIT_FAILURE;
+        }
+        // read all of message 2
+        if (socket_wrapper::SUCCESS != sock1.beginRecvMessage () ||
+            socket_wrapper::SUCCESS != sock1.recv (
+                reinterpret_cast<socket_wrapper::byte_t*>(&value),
+                sizeof (value)) ||
+            2 != value ||
+            socket_wrapper::SUCCESS != sock1.recv (
+                reinterpret_cast<socket_wrapper::byte_t*>(&value),
+                sizeof (value)) ||
+            3 != value)
+        {
+            rval = EXIT_FAILURE;
+        }
+        // reading past the end of message 2 fails
+        if (socket_wrapper::RECV_FAILED != sock1.recv (
+                reinterpret_cast<socket_wrapper::byte_t*>(&value),
+                sizeof (value)))
+        {
+            rval = EXIT_FAILURE;
+        }
+        // message 3 is still intact
+        if (socket_wrapper::SUCCESS != sock1.beginRecvMessage () ||
+            socket_wrapper::SUCCESS != sock1.recv (
+                reinterpret_cast<socket_wrapper::byte_t*>(&value),
+                sizeof (value)) ||
+            4 != value)
+        {
+            rval = EXIT_FAILURE;
+        }
+        // the rest of message 3 is skipped, and an invalid length is
+        // rejected
+        frameLen = socket_wrapper::MAX_FRAME_SIZE + 1;
+        if (sizeof (frameLen) != write (fds[0], &frameLen, sizeof (frameLen)) ||
+            socket_wrapper::RECV_FAILED != sock1.beginRecvMessage () ||
+            socket_wrapper::INVALID_SOCKET != sock1.getFD ())
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
+int
+socket_wrapper_test::test09 ()
+{
+    // test duplex mode and getRecvRemaining
+    int rval = EXIT_SUCCESS;
+    int fds[2];
+    if (-1 != socketpair (AF_UNIX, SOCK_STREAM, 0, fds))
+    {
+        socket_wrapper sock0 (fds[0], socket_wrapper::DUPLEX);
+        socket_wrapper sock1 (fds[1], socket_wrapper::DUPLEX);
+        int values[] = { 1, 2, 3 };
+        socket_wrapper::byte_t const* pValues =
+            reinterpret_cast<socket_wrapper::byte_t const*>(values);
+        // sock1 starts a message that it doesn't flush
+        if (socket_wrapper::SUCCESS != sock1.send (pValues, sizeof (int)) ||
+            socket_wrapper::SUCCESS != sock0.send (
+                pValues, 3 * sizeof (int)) ||
+            socket_wrapper::SUCCESS != sock0.flush ())
+        {
+            rval = EXIT_FAILURE;
+        }
+        int value = 0;
+        if (0 != sock1.getRecvRemaining () ||
+            socket_wrapper::SUCCESS != sock1.recv (
+                reinterpret_cast<socket_wrapper::byte_t*>(&value),
+                sizeof (value)) ||
+            1 != value ||
+            2 * sizeof (int) != sock1.getRecvRemaining ())
+        {
+            rval = EXIT_FAILURE;
+        }
+        // the recv didn't push sock1's message out
+        pollfd pfd;
+        pfd.fd = fds[0];
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (0 != poll (&pfd, 1, 0))
+        {
+            rval = EXIT_FAILURE;
+        }
+        if (socket_wrapper::SUCCESS != sock1.flush () ||
+            socket_wrapper::SUCCESS != sock0.recv (
+                reinterpret_cast<socket_wrapper::byte_t*>(&value),
+                sizeof (value)) ||
+            1 != value ||
+            0 != sock0.getRecvRemaining ())
+        {
+            rval = EXIT_FAILURE;
+        }
+        // an invalid length shuts the socket down but leaves it open
+        socket_wrapper::frame_len_t frameLen =
+            socket_wrapper::MAX_FRAME_SIZE + 1;
+        if (sizeof (frameLen) != write (fds[0], &frameLen, sizeof (frameLen)) ||
+            socket_wrapper::RECV_FAILED != sock1.beginRecvMessage () ||
+            fds[1] != sock1.getFD () ||
+            socket_wrapper::SUCCESS == sock1.beginRecvMessage ())
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
@@ -19,6 +19,11 @@ public:
     int test02 ();
     int test03 ();
     int test04 ();
+    int test05 ();
+    int test06 ();
+    int test07 ();
+    int test08 ();
+    int test09 ();
 };
 
 
@@ -8,6 +8,7 @@
 
 #include "test_helper.hpp"
 #include "traits_test.hpp"
+#include "hash_table_test.hpp"
 #include "repeat_test.hpp"
 #include "default_delete_test.hpp"
 #include "internal_counted_ptr_test.hpp"
@@ -17,6 +18,11 @@
 #include "mi_memory_helper_test.hpp"
 #include "socket_wrapper_test.hpp"
 #include "shared_protocol_test.hpp"
+#include "shared_ring_test.hpp"
+#include "server_pool_test.hpp"
+#include "server_protocol_test.hpp"
+#include "thread_pool_test.hpp"
+#include "value_pool_test.hpp"
 #include "mi_value_test.hpp"
 #include "getopt_test.hpp"
 
@@ -104,8 +110,20 @@ main ()
     test_suite.add_test_class (MAKE_TEST (shared_protocol_test));
 */
 
+    test::hash_table_test hash_table_test;
+    test_suite.add_test_class (MAKE_TEST (hash_table_test));
     test::mi_value_test mi_value_test;
     test_suite.add_test_class (MAKE_TEST (mi_value_test));
+    test::shared_ring_test shared_ring_test;
+    test_suite.add_test_class (MAKE_TEST (shared_ring_test));
+    test::server_pool_test server_pool_test;
+    test_suite.add_test_class (MAKE_TEST (server_pool_test));
+    test::server_protocol_test server_protocol_test;
+    test_suite.add_test_class (MAKE_TEST (server_protocol_test));
+    test::thread_pool_test thread_pool_test;
+    test_suite.add_test_class (MAKE_TEST (thread_pool_test));
+    test::value_pool_test value_pool_test;
+    test_suite.add_test_class (MAKE_TEST (value_pool_test));
 
     //test::getopt_test getopt_test;
     //test_suite.add_test_class (MAKE_TEST (getopt_test));
@@ -0,0 +1,158 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#include "thread_pool_test.hpp"
+
+
+#include <cstdlib>
+#include <thread_pool.hpp>
+#include <time.h>
+
+
+using test::thread_pool_test;
+
+
+namespace
+{
+
+
+class count_task : public thread_pool::task
+{
+public:
+    /*ctor*/ count_task (unsigned int* const pCount)
+        : m_pCount (pCount)
+    {
+        // empty
+    }
+
+    void run ()
+    {
+        __atomic_add_fetch (m_pCount, 1, __ATOMIC_SEQ_CST);
+    }
+
+private:
+    unsigned int* const m_pCount;
+};
+
+
+// arrives at a count shared with the other tasks and waits (for up to a
+// few seconds) for all of them to arrive
+class meet_task : public thread_pool::task
+{
+public:
+    /*ctor*/ meet_task (
+        unsigned int* const pArrived,
+        unsigned int const& nTasks,
+        unsigned int* const pMet)
+        : m_pArrived (pArrived)
+        , m_nTasks (nTasks)
+        , m_pMet (pMet)
+    {
+        // empty
+    }
+
+    void run ()
+    {
+        __atomic_add_fetch (m_pArrived, 1, __ATOMIC_SEQ_CST);
+        timespec delay;
+        delay.tv_sec = 0;
+        delay.tv_nsec = 1000 * 1000;
+        for (int i = 0;
+             i < 5000 &&
+                 m_nTasks > __atomic_load_n (m_pArrived, __ATOMIC_SEQ_CST);
+             ++i)
+        {
+            nanosleep (&delay, NULL);
+        }
+        if (m_nTasks <= __atomic_load_n (m_pArrived, __ATOMIC_SEQ_CST))
+        {
+            __atomic_add_fetch (m_pMet, 1, __ATOMIC_SEQ_CST);
+        }
+    }
+
+private:
+    unsigned int* const m_pArrived;
+    unsigned int const m_nTasks;
+    unsigned int* const m_pMet;
+};
+
+
+} // namespace (unnamed)
+
+
+/*ctor*/
+thread_pool_test::thread_pool_test ()
+{
+    add_test (MAKE_TEST (thread_pool_test::test01));
+    add_test (MAKE_TEST (thread_pool_test::test02));
+    add_test (MAKE_TEST (thread_pool_test::test03));
+}
+
+
+int
+thread_pool_test::test01 ()
+{
+    // test that every task runs, before waitIdle and the dtor return
+    int rval = EXIT_SUCCESS;
+    unsigned int count = 0;
+    {
+        thread_pool pool (4);
+        if (4 != pool.getThreadCount ())
+        {
+            rval = EXIT_FAILURE;
+        }
+        for (int i = 0; i < 1000; ++i)
+        {
+            pool.submit (new count_task (&count));
+        }
+        pool.waitIdle ();
+        if (1000 != __atomic_load_n (&count, __ATOMIC_SEQ_CST))
+        {
+            rval = EXIT_FAILURE;
+        }
+        for (int i = 0; i < 1000; ++i)
+        {
+            pool.submit (new count_task (&count));
+        }
+    }
+    if (2000 != count)
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
+int
+thread_pool_test::test02 ()
+{
+    // test that tasks run at the same time
+    unsigned int const N_TASKS = 3;
+    unsigned int arrived = 0;
+    unsigned int met = 0;
+    {
+        thread_pool pool (N_TASKS);
+        for (unsigned int i = 0; i < N_TASKS; ++i)
+        {
+            pool.submit (new meet_task (&arrived, N_TASKS, &met));
+        }
+    }
+    return N_TASKS == met ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+int
+thread_pool_test::test03 ()
+{
+    // test that a pool without threads runs the task in submit
+    int rval = EXIT_SUCCESS;
+    unsigned int count = 0;
+    thread_pool pool (0);
+    pool.submit (new count_task (&count));
+    if (0 != pool.getThreadCount () ||
+        1 != count)
+    {
+        rval = EXIT_FAILURE;
+    }
+    pool.waitIdle ();
+    return rval;
+}
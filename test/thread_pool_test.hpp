@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#ifndef INCLUDED_THREAD_POOL_TEST_HPP
+#define INCLUDED_THREAD_POOL_TEST_HPP
+
+
+#include "test_helper.hpp"
+
+
+namespace test
+{
+
+
+class thread_pool_test : public test_class<thread_pool_test>
+{
+public:
+    /*ctor*/ thread_pool_test ();
+
+    int test01 ();
+    int test02 ();
+    int test03 ();
+};
+
+
+} // namespace test
+
+
+#endif // INCLUDED_THREAD_POOL_TEST_HPP
@@ -217,6 +217,12 @@ unique_ptr_test::unique_ptr_test ()
     add_test (MAKE_TEST (unique_ptr_test::test75));
     add_test (MAKE_TEST (unique_ptr_test::test76));
     add_test (MAKE_TEST (unique_ptr_test::test77));
+#if (UTIL_HAS_RVALUE_REFERENCES)
+    add_test (MAKE_TEST (unique_ptr_test::test78));
+    add_test (MAKE_TEST (unique_ptr_test::test79));
+    add_test (MAKE_TEST (unique_ptr_test::test80));
+    add_test (MAKE_TEST (unique_ptr_test::test81));
+#endif
 }
 
 
@@ -1349,6 +1355,20 @@ unique_ptr_test::test17 ()
     {
         rval = EXIT_FAILURE;
     }
+    {
+        // reset of a pointer that isn't empty leaves it empty
+        util::unique_ptr<BaseType> pBase (new BaseType);
+        pBase.reset ();
+        if (NULL != pBase.get () ||
+            0 != BaseType::base_count)
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (0 != BaseType::base_count)
+    {
+        rval = EXIT_FAILURE;
+    }
     return rval;
 }
 
@@ -5097,3 +5117,203 @@ unique_ptr_test::test77 ()
     }
     return rval;
 }
+
+
+#if (UTIL_HAS_RVALUE_REFERENCES)
+int
+unique_ptr_test::test78 ()
+{
+    // test move constructor
+    int rval = EXIT_SUCCESS;
+    {
+        util::unique_ptr<BaseType> pBase0;
+        util::unique_ptr<BaseType> pBase1 (std::move (pBase0));
+        if (NULL != pBase0.get () ||
+            NULL != pBase1.get () ||
+            0 != BaseType::base_count)
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    {
+        BaseType* pType = new BaseType;
+        util::unique_ptr<BaseType> pBase0 (pType);
+        util::unique_ptr<BaseType> pBase1 (std::move (pBase0));
+        if (NULL != pBase0.get () ||
+            pType != pBase1.get () ||
+            1 != BaseType::base_count)
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (0 != BaseType::base_count)
+    {
+        rval = EXIT_FAILURE;
+    }
+    {
+        BaseDeleter::base_count = 0;
+        BaseType* pType = new BaseType;
+        util::unique_ptr<BaseType, BaseDeleter> pBase0 (pType);
+        util::unique_ptr<BaseType, BaseDeleter> pBase1 (std::move (pBase0));
+        if (NULL != pBase0.get () ||
+            pType != pBase1.get () ||
+            1 != BaseType::base_count ||
+            0 != BaseDeleter::base_count)
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (0 != BaseType::base_count ||
+        1 != BaseDeleter::base_count)
+    {
+        rval = EXIT_FAILURE;
+    }
+    {
+        base_delete_count = 0;
+        BaseType* pType = new BaseType;
+        util::unique_ptr<BaseType, void (*)(BaseType*&)> pBase0 (
+            pType, BaseDelete);
+        util::unique_ptr<BaseType, void (*)(BaseType*&)> pBase1 (
+            std::move (pBase0));
+        if (NULL != pBase0.get () ||
+            pType != pBase1.get () ||
+            1 != BaseType::base_count ||
+            0 != base_delete_count)
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (0 != BaseType::base_count ||
+        1 != base_delete_count)
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
+int
+unique_ptr_test::test79 ()
+{
+    // test move assignment
+    int rval = EXIT_SUCCESS;
+    {
+        // something for something else
+        BaseDeleter::base_count = 0;
+        BaseType* pType = new BaseType;
+        util::unique_ptr<BaseType, BaseDeleter> pBase0 (pType);
+        util::unique_ptr<BaseType, BaseDeleter> pBase1 (new BaseType);
+        pBase1 = std::move (pBase0);
+        if (NULL != pBase0.get () ||
+            pType != pBase1.get () ||
+            1 != BaseType::base_count ||
+            1 != BaseDeleter::base_count)
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (0 != BaseType::base_count ||
+        2 != BaseDeleter::base_count)
+    {
+        rval = EXIT_FAILURE;
+    }
+    {
+        // nothing for something
+        BaseType* pType = new BaseType;
+        util::unique_ptr<BaseType> pBase0;
+        util::unique_ptr<BaseType> pBase1 (pType);
+        pBase1 = std::move (pBase0);
+        if (NULL != pBase0.get () ||
+            NULL != pBase1.get () ||
+            0 != BaseType::base_count)
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    {
+        // itself
+        BaseType* pType = new BaseType;
+        util::unique_ptr<BaseType> pBase0 (pType);
+        util::unique_ptr<BaseType>& rBase0 = pBase0;
+        pBase0 = std::move (rBase0);
+        if (pType != pBase0.get () ||
+            1 != BaseType::base_count)
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (0 != BaseType::base_count)
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
+int
+unique_ptr_test::test80 ()
+{
+    // test move constructor and move assignment (array)
+    int rval = EXIT_SUCCESS;
+    {
+        ArrayDeleter::count = 0;
+        BaseType* pArray = new BaseType[3];
+        util::unique_ptr<BaseType[], ArrayDeleter> pBase0 (pArray);
+        util::unique_ptr<BaseType[], ArrayDeleter> pBase1 (
+            std::move (pBase0));
+        if (NULL != pBase0.get () ||
+            pArray != pBase1.get () ||
+            3 != BaseType::base_count ||
+            0 != ArrayDeleter::count)
+        {
+            rval = EXIT_FAILURE;
+        }
+        util::unique_ptr<BaseType[], ArrayDeleter> pBase2 (
+            new BaseType[2]);
+        pBase2 = std::move (pBase1);
+        if (NULL != pBase1.get () ||
+            pArray != pBase2.get () ||
+            3 != BaseType::base_count ||
+            1 != ArrayDeleter::count)
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (0 != BaseType::base_count ||
+        2 != ArrayDeleter::count)
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+
+
+int
+unique_ptr_test::test81 ()
+{
+    // test make_unique
+    int rval = EXIT_SUCCESS;
+    {
+        util::unique_ptr<BaseType> pBase = util::make_unique<BaseType> ();
+        if (NULL == pBase.get () ||
+            1 != BaseType::base_count)
+        {
+            rval = EXIT_FAILURE;
+        }
+        util::unique_ptr<BaseType> pDerived (
+            util::make_unique<DerivedType> ().release ());
+        if (NULL == pDerived.get () ||
+            2 != BaseType::base_count ||
+            1 != DerivedType::derived_count)
+        {
+            rval = EXIT_FAILURE;
+        }
+    }
+    if (0 != BaseType::base_count ||
+        0 != DerivedType::derived_count)
+    {
+        rval = EXIT_FAILURE;
+    }
+    return rval;
+}
+#endif
@@ -7,6 +7,9 @@
 #include "test_helper.hpp"
 
 
+#include <traits.hpp>
+
+
 namespace test
 {
 
@@ -93,6 +96,12 @@ public:
     int test75 ();
     int test76 ();
     int test77 ();
+#if (UTIL_HAS_RVALUE_REFERENCES)
+    int test78 ();
+    int test79 ();
+    int test80 ();
+    int test81 ();
+#endif
 };
 
 
@@ -0,0 +1,130 @@
+// Copyright (c) Microsoft Corporation.  All rights reserved.
+// Licensed under the MIT license.
+#include "value_pool_test.hpp"
+
+
+#include <cstdlib>
+#include <mi_value.hpp>
+#include <pthread.h>
+#include <value_pool.hpp>
+
+
+using test::value_pool_test;
+
+
+namespace
+{
+
+
+// frees the blocks it is given, on its own thread
+void*
+free_blocks (
+    void* pBlocks)
+{
+    void** const ppBlocks = reinterpret_cast<void**>(pBlocks);
+    for (size_t i = 0; NULL != ppBlocks[i]; ++i)
+    {
+        value_pool::deallocate (ppBlocks[i], value_pool::MAX_SIZE);
+    }
+    return NULL;
+}
+
+
+} // namespace (unnamed)
+
+
+/*ctor*/
+value_pool_test::value_pool_test ()
+{
+    add_test (MAKE_TEST (value_pool_test::test01));
+    add_test (MAKE_TEST (value_pool_test::test02));
+    add_test (MAKE_TEST (value_pool_test::test03));
+}
+
+
+int
+value_pool_test::test01 ()
+{
+    // test that a freed block is reused for the same size class
+    int rval = EXIT_SUCCESS;
+    void* const pFirst = value_pool::allocate (20);
+    value_pool::deallocate (pFirst, 20);
+    void* const pSecond = value_pool::allocate (32);
+    if (NULL == pFirst ||
+        pFirst != pSecond)
+    {
+        rval = EXIT_FAILURE;
+    }
+    void* const pSmaller = value_pool::allocate (8);
+    if (pSmaller == pSecond)
+    {
+        rval = EXIT_FAILURE;
+    }
+    value_pool::deallocate (pSmaller, 8);
+    value_pool::deallocate (pSecond, 32);
+    // sizes above MAX_SIZE aren't pooled
+    void* const pLarge = value_pool::allocate (value_pool::MAX_SIZE + 1);
+    if (NULL == pLarge)
+    {
+        rval = EXIT_FAILURE;
+    }
+    value_pool::deallocate (pLarge, value_pool::MAX_SIZE + 1);
+    value_pool::deallocate (NULL, 8);
+    return rval;
+}
+
+
+int
+value_pool_test::test02 ()
+{
+    // test that scalar values, timestamps and intervals come from the pool
+    int rval = EXIT_SUCCESS;
+    scx::MI_Value<MI_UINT32>::Ptr pValue (new scx::MI_Value<MI_UINT32> (5));
+    void* const pAddress = pValue.get ();
+    pValue.reset ();
+    pValue.reset (new scx::MI_Value<MI_UINT32> (7));
+    if (pAddress != pValue.get () ||
+        7 != pValue->getValue ())
+    {
+        rval = EXIT_FAILURE;
+    }
+    scx::MI_Datetime::Ptr pDatetime (new scx::MI_Timestamp ());
+    void* const pDatetimeAddress = pDatetime.get ();
+    pDatetime.reset ();
+    pDatetime.reset (new scx::MI_Timestamp ());
+    if (pDatetimeAddress != pDatetime.get ())
+    {
+        rval = EXIT_FAILURE;
+    }
+    // freed through a base pointer
+    scx::MI_ValueBase::Ptr pBase (new scx::MI_Interval ());
+    pBase.reset ();
+    return rval;
+}
+
+
+int
+value_pool_test::test03 ()
+{
+    // test that blocks can be freed by another thread
+    int rval = EXIT_SUCCESS;
+    size_t const COUNT = 2 * value_pool::MAX_FREE_BLOCKS;
+    void** ppBlocks = new void*[COUNT + 1];
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        ppBlocks[i] = value_pool::allocate (value_pool::MAX_SIZE);
+    }
+    ppBlocks[COUNT] = NULL;
+    pthread_t thread;
+    if (0 == pthread_create (&thread, NULL, free_blocks, ppBlocks))
+    {
+        pthread_join (thread, NULL);
+    }
+    else
+    {
+        free_blocks (ppBlocks);
+        rval = EXIT_FAILURE;
+    }
+    delete[] ppBlocks;
+    return rval;
+}
@@ -149,8 +149,7 @@ def Full_Test_EnumerateInstances (
 
     instance = context.NewInstance('Full_Test')
 
-    for entry in InstancesRecord:
-        context.PostInstance(entry)
+    context.PostInstances(InstancesRecord)
 
     context.PostResult (MI_RESULT_OK)
 